@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #ifndef ASTBVCONST_H
 #define ASTBVCONST_H
+#include <stdint.h>
 namespace BEEV
 {
   class STPMgr;
@@ -54,6 +55,25 @@ namespace BEEV
     // If the CBV is managed outside of this class. Then a defensive copy isn't taken.
     bool cbv_managed_outside;
 
+    // Constants of 64 bits or less are kept in the node: the words
+    // below are laid out like a CBV (three header words, then the
+    // value), and _bvconst points into them. So narrow constants
+    // don't allocate, and hashing and comparing them is done on the
+    // value.
+    enum
+    {
+      InlineWords = sizeof(uint64_t) / sizeof(unsigned int)
+    };
+    unsigned int _inline[3 + InlineWords];
+
+    bool isInline() const
+    {
+      return _value_width <= 64;
+    }
+
+    // Copies a narrow constant into _inline.
+    void setInline(uint64_t value);
+
     /****************************************************************
      * Class ASTBVConstHasher:                                      *
      *                                                              *
@@ -88,13 +108,10 @@ namespace BEEV
 
     enum CBV_LIFETIME {CBV_MANAGED_OUTSIDE};
 
-    ASTBVConst(CBV bv, unsigned int width, enum CBV_LIFETIME l )
-    :  ASTInternal(BVCONST)
-    {
-      _bvconst = (bv);
-      _value_width = width;
-      cbv_managed_outside =true;
-    }
+    ASTBVConst(CBV bv, unsigned int width, enum CBV_LIFETIME l );
+
+    // A constant of 64 bits or less.
+    ASTBVConst(uint64_t value, unsigned int width);
 
     // Copy constructor.
     ASTBVConst(const ASTBVConst &sym);  
@@ -104,6 +121,8 @@ namespace BEEV
     {
       if (bvc1._value_width != bvc2._value_width)
         return false;
+      if (bvc1.isInline())
+        return bvc1.GetUint64() == bvc2.GetUint64();
       return (0 == CONSTANTBV::BitVector_Compare(bvc1._bvconst, 
                                                  bvc2._bvconst));
     } //End of operator==
@@ -134,12 +153,22 @@ namespace BEEV
     //Destructor. Call the external destructor
     virtual ~ASTBVConst()
     {
-      if (!cbv_managed_outside)
+      if (!cbv_managed_outside && !isInline())
         CONSTANTBV::BitVector_Destroy(_bvconst);
     } //End of destructor
 
     // Return the bvconst. It is a const-value
     CBV GetBVConst() const;
+
+    // The value of a constant that's 64 bits or less.
+    uint64_t GetUint64() const
+    {
+      assert(isInline());
+      uint64_t v = 0;
+      for (unsigned i = 0; i < InlineWords; i++)
+        v |= ((uint64_t) _inline[3 + i]) << (i * sizeof(unsigned int) * 8);
+      return v;
+    }
   }; //End of ASTBVConst  
 } //end of namespace
 #endif
@@ -32,7 +32,6 @@ namespace BEEV
 {
   class ASTNode;
   class STPMgr;
-  typedef vector<ASTNode> ASTVec;
   
   /******************************************************************
    * Class ASTInterior:                                             *
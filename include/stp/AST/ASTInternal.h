@@ -72,13 +72,15 @@ namespace BEEV
      * Protected Data                                               *
      ****************************************************************/
 
-    mutable uint8_t iteration;
+    // Kind. It's a type tag and the operator.
+    enumeration<Kind,unsigned char> _kind;
+
+    // Only used by nodes with children. It's kept here because it
+    // fits in the padding after _kind.
+    mutable bool is_simplified;
 
     //reference counting for garbage collection
     unsigned int   _ref_count;
-   
-    // Kind. It's a type tag and the operator.
-    enumeration<Kind,unsigned char> _kind;
 
     //Nodenum is a unique positive integer for the node.  The nodenum
     //of a node should always be greater than its descendents (which
@@ -105,6 +107,29 @@ namespace BEEV
      *******************************************************************/
     unsigned int  _value_width;
 
+    // Hash of the node's contents, set when it enters the unique
+    // table so it never needs to be computed again.
+    uint32_t _hash;
+
+#ifdef STP_NODE_HANDLES
+    // This node's index in the handle table.
+    uint32_t _handle;
+
+    // Every node in a unique table, indexed by handle. ASTNodes hold
+    // the index rather than a pointer. Entry 0 is the null node. The
+    // handles of nodes that have been cleaned up are reused.
+    //
+    // The table is shared by all the STPMgrs, which may be on
+    // different threads. It's made of pages that never move once
+    // allocated, so lookups don't need a lock; handing out and
+    // releasing handles does.
+    enum
+    {
+      HandlePageBits = 16, HandlePageSize = 1 << HandlePageBits
+    };
+    static ASTInternal** handle_pages[1 << (32 - HandlePageBits)];
+#endif
+
     /****************************************************************
      * Protected Member Functions                                   *
      ****************************************************************/
@@ -145,12 +170,16 @@ namespace BEEV
     
     // Constructor (kind only, empty children, int nodenum)
     ASTInternal(Kind kind, int nodenum = 0) :
-      iteration(0),
-      _ref_count(0),
       _kind(kind),
+      is_simplified(false),
+      _ref_count(0),
       _node_num(nodenum),
       _index_width(0),
-      _value_width(0)
+      _value_width(0),
+      _hash(0)
+#ifdef STP_NODE_HANDLES
+      ,_handle(0)
+#endif
     {
     }
 
@@ -160,12 +189,16 @@ namespace BEEV
     // temporary hash keys before uniquefication.
     // FIXME:  I don't think children need to be copied.
     ASTInternal(const ASTInternal &int_node) :
-      iteration(0),
-      _ref_count(0),
       _kind(int_node._kind),
+      is_simplified(false),
+      _ref_count(0),
       _node_num(int_node._node_num),
       _index_width(int_node._index_width),
-      _value_width(int_node._value_width)
+      _value_width(int_node._value_width),
+      _hash(int_node._hash)
+#ifdef STP_NODE_HANDLES
+      ,_handle(0)
+#endif
     {
     }
 
@@ -207,6 +240,31 @@ namespace BEEV
       _node_num = nn;
     } //End of SetNodeNum()
 
+#ifdef STP_NODE_HANDLES
+    // Called when the node enters a unique table.
+    void AssignHandle();
+
+    // Called from CleanUp().
+    void ReleaseHandle();
+
+    static ASTInternal* LookupHandle(uint32_t h)
+    {
+      return handle_pages[h >> HandlePageBits][h & (HandlePageSize - 1)];
+    }
+
+    static size_t GetHandleCount();
+#endif
+
+    uint32_t GetHashValue() const
+    {
+      return _hash;
+    }
+
+    void SetHashValue(size_t h)
+    {
+      _hash = (uint32_t)(h ^ (h >> 16 >> 16));
+    }
+
   }; //End of Class ASTInternal
 } //end of namespace
 #endif
@@ -56,8 +56,14 @@ namespace BEEV
      * Private Data                                                 *
      ****************************************************************/
 
+#ifdef STP_NODE_HANDLES
+    // Index of the real data in STPMgr's handle table. 0 is the
+    // null node.
+    uint32_t _handle;
+#else
     // Ptr to the read data
     ASTInternal * _int_node_ptr;
+#endif
 
     /****************************************************************
      * Private Member Functions                                     *
@@ -66,12 +72,31 @@ namespace BEEV
     // Constructor.
     ASTNode(ASTInternal *in);
 
+    // The real data, NULL for the null node.
+#ifdef STP_NODE_HANDLES
+    ASTInternal * internal() const;
+#else
+    ASTInternal * internal() const
+    {
+      return _int_node_ptr;
+    }
+#endif
+
+    // Identifies the node. Nodes are compared, ordered and hashed
+    // on this.
+    size_t identity() const
+    {
+#ifdef STP_NODE_HANDLES
+      return _handle;
+#else
+      return (size_t) _int_node_ptr;
+#endif
+    }
+
     //Equal iff ASTIntNode pointers are the same.
     friend bool operator==(const ASTNode& node1, const ASTNode& node2)
     {
-      return 
-        ((size_t) node1._int_node_ptr) == 
-        ((size_t) node2._int_node_ptr);
+      return node1.identity() == node2.identity();
     }
 
     friend bool operator!=(const ASTNode& node1, const ASTNode& node2)
@@ -81,9 +106,7 @@ namespace BEEV
 
     friend bool operator<(const ASTNode& node1, const ASTNode& node2)
     {
-      return 
-        ((size_t) node1._int_node_ptr) < 
-        ((size_t) node2._int_node_ptr);
+      return node1.identity() < node2.identity();
     }
 
   public:
@@ -91,11 +114,12 @@ namespace BEEV
      * Public Member Functions                                      *
      ****************************************************************/
 
-    uint8_t getIteration() const;
-    void setIteration(uint8_t v) const;
-
     // Default constructor.
+#ifdef STP_NODE_HANDLES
+    ASTNode() :_handle(0) {};
+#else
     ASTNode() :_int_node_ptr(NULL) {};
+#endif
 
     // Copy constructor
     ASTNode(const ASTNode &n);
@@ -111,7 +135,7 @@ namespace BEEV
     // Check if it points to a null node
     inline bool IsNull() const 
     { 
-      return _int_node_ptr == NULL;
+      return identity() == 0;
     }
 
     bool isConstant() const
@@ -252,13 +276,17 @@ namespace BEEV
     // Assignment (for ref counting)
     ASTNode& operator=(const ASTNode& n);
 
-    //Get the STPMgr pointer. FIXME: Currently uses a global
-    //ptr. BAD!!
+    //Get the STPMgr that made the node. For a null node, it's the
+    //one bound to this thread.
     STPMgr* GetSTPMgr() const;
 
     // Access node number
     int GetNodeNum() const;
 
+    // The number of ASTNodes (including this one) that refer to the
+    // node.
+    unsigned int GetRefCount() const;
+
     // Access kind.
     Kind GetKind() const;
 
@@ -323,10 +351,10 @@ namespace BEEV
     void SetValueWidth(unsigned int vw) const;
     types GetType(void) const;
 
-    // Hash using pointer value of _int_node_ptr.
+    // Hash using pointer value of _int_node_ptr (or the handle).
     size_t Hash() const
     {
-      return (size_t) _int_node_ptr;
+      return identity();
     }
 
     void NFASTPrint(int l, int max, int prefix) const;
@@ -356,7 +384,7 @@ namespace BEEV
     // Check if NODE really has a good ptr
     bool IsDefined() const
     {
-      return _int_node_ptr != NULL;
+      return identity() != 0;
     }
 
     /*****************************************************************
@@ -371,7 +399,7 @@ namespace BEEV
     public:
       size_t operator()(const ASTNode& n) const
       {
-        return (size_t) n._int_node_ptr;
+        return n.identity();
         //return (size_t)n.GetNodeNum();
       }
       ;
@@ -389,7 +417,7 @@ namespace BEEV
     public:
       bool operator()(const ASTNode& n1, const ASTNode& n2) const
       {
-        return (n1._int_node_ptr == n2._int_node_ptr);
+        return (n1.identity() == n2.identity());
       }
     }; //End of ASTNodeEqual
 
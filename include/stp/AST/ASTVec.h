@@ -0,0 +1,521 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef ASTVEC_H
+#define ASTVEC_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <new>
+#include <iterator>
+#include <algorithm>
+#include <stdint.h>
+#include "stp/config.h"
+
+namespace BEEV
+{
+  /******************************************************************
+   * Class SmallNodeVector:                                         *
+   *                                                                *
+   * A std::vector look-alike that keeps its first few elements     *
+   * inside the object (in N pointer-sized slots), and only goes to *
+   * the heap when it grows past that. Almost every interior node   *
+   * has three or fewer children, so with this as ASTVec, a node's  *
+   * children live inside the node.                                 *
+   *                                                                *
+   * T must be no bigger than a pointer (the slots are sized before *
+   * T is complete), and must be movable with memcpy, which ASTNode *
+   * is. Unlike std::vector, swapping or moving one of these        *
+   * invalidates pointers to elements that are inline.              *
+   ******************************************************************/
+  template <class T, unsigned N>
+  class SmallNodeVector
+  {
+  public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  private:
+    T* _data;
+    uint32_t _size;
+    uint32_t _capacity;
+    void* _inline[N];
+
+    T* inlineData()
+    {
+      return reinterpret_cast<T*>(_inline);
+    }
+
+    static uint32_t inlineCapacity()
+    {
+      return (uint32_t) (N * sizeof(void*) / sizeof(T));
+    }
+
+    bool isInline() const
+    {
+      return _data == reinterpret_cast<const T*>(_inline);
+    }
+
+    void init()
+    {
+      assert(sizeof(T) <= sizeof(void*));
+      _data = inlineData();
+      _size = 0;
+      _capacity = inlineCapacity();
+    }
+
+    // Moves the elements to a buffer that holds at least n.
+    void grow(size_t n)
+    {
+      size_t c = 2 * (size_t) _capacity;
+      if (c < n)
+        c = n;
+      T* d = (T*) malloc(c * sizeof(T));
+      if (d == NULL)
+        throw std::bad_alloc();
+      memcpy((void*) d, (const void*) _data, _size * sizeof(T));
+      if (!isInline())
+        free(_data);
+      _data = d;
+      _capacity = (uint32_t) c;
+    }
+
+    void destroyAll()
+    {
+      for (uint32_t i = 0; i < _size; i++)
+        _data[i].~T();
+      _size = 0;
+    }
+
+    void releaseStorage()
+    {
+      if (!isInline())
+        free(_data);
+      _data = inlineData();
+      _capacity = inlineCapacity();
+    }
+
+    // Takes the elements of "other", leaving it empty.
+    void steal(SmallNodeVector& other)
+    {
+      assert(_size == 0 && isInline());
+      if (other.isInline())
+        {
+          memcpy((void*) _data, (const void*) other._data, other._size * sizeof(T));
+        }
+      else
+        {
+          _data = other._data;
+          _capacity = other._capacity;
+          other._data = other.inlineData();
+          other._capacity = inlineCapacity();
+        }
+      _size = other._size;
+      other._size = 0;
+    }
+
+    // Drops the current elements and takes those of "other".
+    void replaceWith(SmallNodeVector& other)
+    {
+      destroyAll();
+      releaseStorage();
+      steal(other);
+    }
+
+    // Makes a gap of n elements at position pos.
+    T* openGap(size_t pos, size_t n)
+    {
+      assert(pos <= _size);
+      if (_size + n > _capacity)
+        grow(_size + n);
+      memmove((void*) (_data + pos + n), (const void*) (_data + pos), (_size - pos) * sizeof(T));
+      _size += (uint32_t) n;
+      return _data + pos;
+    }
+
+    template <class InputIt>
+    void appendRange(InputIt first, InputIt last)
+    {
+      for (; first != last; ++first)
+        push_back(*first);
+    }
+
+  public:
+    SmallNodeVector()
+    {
+      init();
+    }
+
+    explicit SmallNodeVector(size_type n, const T& v = T())
+    {
+      init();
+      assign(n, v);
+    }
+
+    template <class InputIt>
+    SmallNodeVector(InputIt first, InputIt last)
+    {
+      init();
+      appendRange(first, last);
+    }
+
+    SmallNodeVector(const SmallNodeVector& other)
+    {
+      init();
+      reserve(other._size);
+      for (uint32_t i = 0; i < other._size; i++)
+        new (_data + i) T(other._data[i]);
+      _size = other._size;
+    }
+
+#if __cplusplus >= 201103L
+    SmallNodeVector(SmallNodeVector&& other) noexcept
+    {
+      init();
+      steal(other);
+    }
+
+    SmallNodeVector& operator=(SmallNodeVector&& other) noexcept
+    {
+      if (this != &other)
+        replaceWith(other);
+      return *this;
+    }
+#endif
+
+    ~SmallNodeVector()
+    {
+      destroyAll();
+      releaseStorage();
+    }
+
+    SmallNodeVector& operator=(const SmallNodeVector& other)
+    {
+      if (this != &other)
+        {
+          destroyAll();
+          reserve(other._size);
+          for (uint32_t i = 0; i < other._size; i++)
+            new (_data + i) T(other._data[i]);
+          _size = other._size;
+        }
+      return *this;
+    }
+
+    void swap(SmallNodeVector& other)
+    {
+      SmallNodeVector tmp;
+      tmp.steal(other);
+      other.steal(*this);
+      steal(tmp);
+    }
+
+    void assign(size_type n, const T& v)
+    {
+      SmallNodeVector tmp;
+      tmp.reserve(n);
+      for (size_type i = 0; i < n; i++)
+        new (tmp._data + i) T(v);
+      tmp._size = (uint32_t) n;
+      replaceWith(tmp);
+    }
+
+    template <class InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+      SmallNodeVector tmp(first, last);
+      replaceWith(tmp);
+    }
+
+    iterator begin()
+    {
+      return _data;
+    }
+
+    const_iterator begin() const
+    {
+      return _data;
+    }
+
+    iterator end()
+    {
+      return _data + _size;
+    }
+
+    const_iterator end() const
+    {
+      return _data + _size;
+    }
+
+    reverse_iterator rbegin()
+    {
+      return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+      return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+      return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const
+    {
+      return const_reverse_iterator(begin());
+    }
+
+    size_type size() const
+    {
+      return _size;
+    }
+
+    size_type capacity() const
+    {
+      return _capacity;
+    }
+
+    size_type max_size() const
+    {
+      return (uint32_t) -1;
+    }
+
+    bool empty() const
+    {
+      return _size == 0;
+    }
+
+    T* data()
+    {
+      return _data;
+    }
+
+    const T* data() const
+    {
+      return _data;
+    }
+
+    reference operator[](size_type i)
+    {
+      assert(i < _size);
+      return _data[i];
+    }
+
+    const_reference operator[](size_type i) const
+    {
+      assert(i < _size);
+      return _data[i];
+    }
+
+    reference at(size_type i)
+    {
+      assert(i < _size);
+      return _data[i];
+    }
+
+    const_reference at(size_type i) const
+    {
+      assert(i < _size);
+      return _data[i];
+    }
+
+    reference front()
+    {
+      assert(_size > 0);
+      return _data[0];
+    }
+
+    const_reference front() const
+    {
+      assert(_size > 0);
+      return _data[0];
+    }
+
+    reference back()
+    {
+      assert(_size > 0);
+      return _data[_size - 1];
+    }
+
+    const_reference back() const
+    {
+      assert(_size > 0);
+      return _data[_size - 1];
+    }
+
+    void reserve(size_type n)
+    {
+      if (n > _capacity)
+        grow(n);
+    }
+
+    void clear()
+    {
+      destroyAll();
+    }
+
+    void push_back(const T& v)
+    {
+      if (_size == _capacity)
+        {
+          // v might be one of our elements, so copy it first.
+          T copy(v);
+          grow(_size + 1);
+          new (_data + _size) T(copy);
+        }
+      else
+        new (_data + _size) T(v);
+      _size++;
+    }
+
+    void pop_back()
+    {
+      assert(_size > 0);
+      _size--;
+      _data[_size].~T();
+    }
+
+    void resize(size_type n, const T& v = T())
+    {
+      if (n < _size)
+        {
+          while (_size > n)
+            pop_back();
+          return;
+        }
+      T copy(v);
+      reserve(n);
+      while (_size < n)
+        {
+          new (_data + _size) T(copy);
+          _size++;
+        }
+    }
+
+    iterator insert(iterator pos, const T& v)
+    {
+      const size_t p = pos - _data;
+      T copy(v);
+      T* gap = openGap(p, 1);
+      new (gap) T(copy);
+      return gap;
+    }
+
+    void insert(iterator pos, size_type n, const T& v)
+    {
+      const size_t p = pos - _data;
+      T copy(v);
+      T* gap = openGap(p, n);
+      for (size_type i = 0; i < n; i++)
+        new (gap + i) T(copy);
+    }
+
+    template <class InputIt>
+    void insert(iterator pos, InputIt first, InputIt last)
+    {
+      // The range might come from this vector, so copy it first.
+      SmallNodeVector tmp(first, last);
+      const size_t p = pos - _data;
+      T* gap = openGap(p, tmp._size);
+      memcpy((void*) gap, (const void*) tmp._data, tmp._size * sizeof(T));
+      tmp._size = 0;
+    }
+
+    iterator erase(iterator pos)
+    {
+      return erase(pos, pos + 1);
+    }
+
+    iterator erase(iterator first, iterator last)
+    {
+      assert(_data <= first && first <= last && last <= _data + _size);
+      for (iterator i = first; i != last; ++i)
+        i->~T();
+      memmove((void*) first, (const void*) last, (end() - last) * sizeof(T));
+      _size -= (uint32_t) (last - first);
+      return first;
+    }
+
+    friend bool operator==(const SmallNodeVector& a, const SmallNodeVector& b)
+    {
+      return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const SmallNodeVector& a, const SmallNodeVector& b)
+    {
+      return !(a == b);
+    }
+
+    friend bool operator<(const SmallNodeVector& a, const SmallNodeVector& b)
+    {
+      return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend bool operator>(const SmallNodeVector& a, const SmallNodeVector& b)
+    {
+      return b < a;
+    }
+
+    friend bool operator<=(const SmallNodeVector& a, const SmallNodeVector& b)
+    {
+      return !(b < a);
+    }
+
+    friend bool operator>=(const SmallNodeVector& a, const SmallNodeVector& b)
+    {
+      return !(a < b);
+    }
+  }; //End of SmallNodeVector
+
+  template <class T, unsigned N>
+  inline void swap(SmallNodeVector<T, N>& a, SmallNodeVector<T, N>& b)
+  {
+    a.swap(b);
+  }
+
+  class ASTNode;
+
+  // Vector of ASTNodes, used for child nodes among other things. Up
+  // to three children (four handles) fit inline.
+#ifdef STP_NODE_HANDLES
+  typedef SmallNodeVector<ASTNode, 2> ASTVec;
+#else
+  typedef SmallNodeVector<ASTNode, 3> ASTVec;
+#endif
+} // end namespace BEEV
+#endif
@@ -28,11 +28,11 @@ THE SOFTWARE.
 
 #include <vector>
 #include "stp/AST/ASTKind.h"
+#include "stp/AST/ASTVec.h"
 
 namespace BEEV
 {
 class ASTNode;
-typedef std::vector<ASTNode> ASTVec;
 extern ASTVec _empty_ASTVec;
 class STPMgr;
 typedef unsigned int * CBV;
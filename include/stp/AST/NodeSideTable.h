@@ -0,0 +1,192 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef NODESIDETABLE_H
+#define NODESIDETABLE_H
+
+#include <vector>
+#include <cassert>
+#include <stdint.h>
+#include "stp/AST/AST.h"
+
+namespace BEEV
+{
+  /******************************************************************
+   * Class NodeSideTable:                                           *
+   *                                                                *
+   * Maps ASTNodes to a T, indexed directly by GetNodeNum(). It's   *
+   * a replacement for the std::map<ASTNode,T> memo tables that the *
+   * passes keep. The entries live in fixed size pages that are     *
+   * allocated when first touched, so pointers to values stay valid *
+   * as the table grows. Each slot is tagged with the epoch it was  *
+   * written in; clear() bumps the epoch rather than resetting the  *
+   * tags.                                                          *
+   *                                                                *
+   * The keys are kept (in insertion order) so that the table can   *
+   * be walked, and so that they stay alive like a map's keys do.   *
+   * All the nodes must come from the same STPMgr.                  *
+   ******************************************************************/
+  template <class T>
+  class NodeSideTable //not copyable
+  {
+    NodeSideTable(const NodeSideTable&);
+    NodeSideTable& operator=(const NodeSideTable&);
+
+    enum
+    {
+      PageBits = 7, PageSize = 1 << PageBits
+    };
+
+    struct Page
+    {
+      uint32_t epoch[PageSize];
+      T value[PageSize];
+
+      Page()
+      {
+        for (unsigned i = 0; i < PageSize; i++)
+          epoch[i] = 0;
+      }
+    };
+
+    std::vector<Page*> pages;
+    std::vector<ASTNode> keys;
+    uint32_t current_epoch;
+
+    Page* getPage(unsigned num) const
+    {
+      const size_t p = num >> PageBits;
+      return (p < pages.size()) ? pages[p] : NULL;
+    }
+
+    Page* makePage(unsigned num)
+    {
+      const size_t p = num >> PageBits;
+      if (p >= pages.size())
+        pages.resize(p + 1, (Page*) NULL);
+      if (pages[p] == NULL)
+        pages[p] = new Page();
+      return pages[p];
+    }
+
+  public:
+    NodeSideTable() :
+      current_epoch(1)
+    {
+    }
+
+    ~NodeSideTable()
+    {
+      for (size_t i = 0; i < pages.size(); i++)
+        delete pages[i];
+    }
+
+    // NULL if n isn't in the table.
+    T* find(const ASTNode& n)
+    {
+      const unsigned num = n.GetNodeNum();
+      Page* p = getPage(num);
+      if (p == NULL || p->epoch[num & (PageSize - 1)] != current_epoch)
+        return NULL;
+      return &p->value[num & (PageSize - 1)];
+    }
+
+    const T* find(const ASTNode& n) const
+    {
+      return const_cast<NodeSideTable*>(this)->find(n);
+    }
+
+    bool contains(const ASTNode& n) const
+    {
+      return find(n) != NULL;
+    }
+
+    // Like std::map, adds a default constructed T if n isn't there.
+    T& operator[](const ASTNode& n)
+    {
+      const unsigned num = n.GetNodeNum();
+      Page* p = makePage(num);
+      const unsigned i = num & (PageSize - 1);
+      if (p->epoch[i] != current_epoch)
+        {
+          p->epoch[i] = current_epoch;
+          keys.push_back(n);
+        }
+      return p->value[i];
+    }
+
+    // Returns false (and changes nothing) if n is already there.
+    bool insert(const ASTNode& n, const T& v)
+    {
+      if (contains(n))
+        return false;
+      (*this)[n] = v;
+      return true;
+    }
+
+    size_t size() const
+    {
+      return keys.size();
+    }
+
+    bool empty() const
+    {
+      return keys.empty();
+    }
+
+    // The i-th key added, for walking the table.
+    const ASTNode& key(size_t i) const
+    {
+      return keys[i];
+    }
+
+    T& value(size_t i)
+    {
+      T* v = find(keys[i]);
+      assert(v != NULL);
+      return *v;
+    }
+
+    // The values are reset, so they don't hold on to anything, and
+    // the slots are invalidated by moving to the next epoch.
+    void clear()
+    {
+      for (size_t i = 0; i < keys.size(); i++)
+        value(i) = T();
+      keys.clear();
+
+      if (++current_epoch == 0)
+        {
+          // Wrapped around, so the old tags could look current.
+          for (size_t i = 0; i < pages.size(); i++)
+            if (pages[i] != NULL)
+              for (unsigned j = 0; j < PageSize; j++)
+                pages[i]->epoch[j] = 0;
+          current_epoch = 1;
+        }
+    }
+  };
+} // end namespace BEEV
+#endif
@@ -0,0 +1,221 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef NODESLAB_H
+#define NODESLAB_H
+
+#include <vector>
+#include <new>
+#include <cstdlib>
+#include <cassert>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace BEEV
+{
+  class STPMgr;
+
+  /******************************************************************
+   * Class NodeSlab:
+   *
+   * Hands out fixed-size blocks for one class of node (ASTInterior,
+   * ASTSymbol, ASTBVConst). Blocks are carved sequentially out of
+   * large chunks, so nodes created together sit together in memory.
+   * Freed blocks go onto a free list and are reused before the chunk
+   * is extended. All the chunks are returned in one go by releaseAll().
+   *
+   * Chunks are aligned to their size and start with a pointer to the
+   * slab, so the slab, and the STPMgr that owns it, can be found from
+   * any node without a lookup.
+   ******************************************************************/
+  class NodeSlab //not copyable
+  {
+    struct FreeBlock
+    {
+      FreeBlock* next;
+    };
+
+    struct ChunkHeader
+    {
+      NodeSlab* slab;
+    };
+
+    NodeSlab(const NodeSlab&);
+    NodeSlab& operator=(const NodeSlab&);
+
+    enum
+    {
+      ChunkBits = 16
+    };
+    static const size_t ChunkBytes = size_t(1) << ChunkBits;
+
+    STPMgr* const owner;
+    const size_t block_size;
+
+    std::vector<char*> chunks;
+    FreeBlock* free_list;
+
+    // The unused tail of the most recently allocated chunk.
+    char* next_block;
+    char* chunk_end;
+
+    uint64_t allocations;
+    uint64_t reuses;
+    uint64_t live;
+
+    static size_t roundUp(size_t size)
+    {
+      // Nodes hold nothing wider than a pointer.
+      const size_t align = sizeof(void*);
+      if (size < sizeof(FreeBlock))
+        size = sizeof(FreeBlock);
+      return (size + align - 1) & ~(align - 1);
+    }
+
+    static char* allocateChunk()
+    {
+      void* c;
+#ifdef _MSC_VER
+      c = _aligned_malloc(ChunkBytes, ChunkBytes);
+#else
+      if (posix_memalign(&c, ChunkBytes, ChunkBytes) != 0)
+        c = NULL;
+#endif
+      if (c == NULL)
+        throw std::bad_alloc();
+      return (char*) c;
+    }
+
+    static void freeChunk(char* c)
+    {
+#ifdef _MSC_VER
+      _aligned_free(c);
+#else
+      free(c);
+#endif
+    }
+
+    void newChunk()
+    {
+      char* c = allocateChunk();
+      ((ChunkHeader*) c)->slab = this;
+      chunks.push_back(c);
+      next_block = c + roundUp(sizeof(ChunkHeader));
+      chunk_end = next_block + block_size * ((c + ChunkBytes - next_block) / block_size);
+    }
+
+  public:
+    NodeSlab(STPMgr* _owner, size_t size) :
+      owner(_owner), block_size(roundUp(size)), free_list(NULL),
+      next_block(NULL), chunk_end(NULL), allocations(0), reuses(0), live(0)
+    {
+      assert(block_size + roundUp(sizeof(ChunkHeader)) <= ChunkBytes);
+    }
+
+    ~NodeSlab()
+    {
+      releaseAll();
+    }
+
+    // Raw storage for one node. The caller placement-news into it.
+    void* allocate()
+    {
+      allocations++;
+      live++;
+      if (free_list != NULL)
+        {
+          reuses++;
+          FreeBlock* b = free_list;
+          free_list = b->next;
+          return b;
+        }
+
+      if (next_block == chunk_end)
+        newChunk();
+
+      void* result = next_block;
+      next_block += block_size;
+      return result;
+    }
+
+    // The node must already have been destructed.
+    void release(void* p)
+    {
+      assert(p != NULL);
+      assert(live > 0);
+      live--;
+      FreeBlock* b = (FreeBlock*) p;
+      b->next = free_list;
+      free_list = b;
+    }
+
+    // The slab that the block was allocated from.
+    static NodeSlab& of(const void* block)
+    {
+      const uintptr_t chunk = (uintptr_t) block & ~(uintptr_t) (ChunkBytes - 1);
+      return *((const ChunkHeader*) chunk)->slab;
+    }
+
+    STPMgr* getOwner() const
+    {
+      return owner;
+    }
+
+    // Frees every chunk. Any nodes still living in them are gone.
+    void releaseAll()
+    {
+      for (size_t i = 0; i < chunks.size(); i++)
+        freeChunk(chunks[i]);
+      chunks.clear();
+      free_list = NULL;
+      next_block = chunk_end = NULL;
+      live = 0;
+    }
+
+    uint64_t getAllocations() const
+    {
+      return allocations;
+    }
+
+    uint64_t getReuses() const
+    {
+      return reuses;
+    }
+
+    uint64_t getLive() const
+    {
+      return live;
+    }
+
+    size_t getReservedBytes() const
+    {
+      return chunks.size() * ChunkBytes;
+    }
+  };
+} // end namespace BEEV
+#endif
@@ -0,0 +1,174 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef NODEUNIQUETABLE_H
+#define NODEUNIQUETABLE_H
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <stdint.h>
+
+namespace BEEV
+{
+  /******************************************************************
+   * Class NodeUniqueTable:
+   *
+   * Open addressing (linear probing) hash set of node pointers, used
+   * for hash-consing. The hash of each node is computed once, when
+   * the node is created, and kept in the node (GetHashValue()). So
+   * probing, growing and erasing never call the hasher again, and
+   * most failed probes are rejected without calling Equal.
+   *
+   * Erase uses backward-shift deletion, so there are no tombstones.
+   ******************************************************************/
+  template <class T, class Equal>
+  class NodeUniqueTable //not copyable
+  {
+    NodeUniqueTable(const NodeUniqueTable&);
+    NodeUniqueTable& operator=(const NodeUniqueTable&);
+
+    std::vector<T*> slots;
+    size_t count;
+
+    // The capacity is 1 << (32 - shift).
+    unsigned shift;
+
+    Equal equal;
+
+    // Fibonacci hashing, so weak hashes (BitVector_Hash) spread out.
+    size_t home(uint32_t hash) const
+    {
+      return (uint32_t)(hash * 2654435769u) >> shift;
+    }
+
+    size_t mask() const
+    {
+      return slots.size() - 1;
+    }
+
+    void place(T* n)
+    {
+      size_t i = home(n->GetHashValue());
+      while (slots[i] != NULL)
+        i = (i + 1) & mask();
+      slots[i] = n;
+    }
+
+    void grow()
+    {
+      std::vector<T*> old;
+      old.swap(slots);
+      slots.assign(old.size() * 2, (T*) NULL);
+      shift--;
+      for (size_t i = 0; i < old.size(); i++)
+        if (old[i] != NULL)
+          place(old[i]);
+    }
+
+  public:
+    NodeUniqueTable(unsigned log2_capacity = 10) :
+      slots((size_t) 1 << log2_capacity, (T*) NULL), count(0), shift(32 - log2_capacity)
+    {
+      assert(log2_capacity > 0 && log2_capacity < 32);
+    }
+
+    // The key must have had its hash value set.
+    T* find(const T* key) const
+    {
+      const uint32_t hash = key->GetHashValue();
+      for (size_t i = home(hash);; i = (i + 1) & mask())
+        {
+          T* n = slots[i];
+          if (n == NULL)
+            return NULL;
+          if (n->GetHashValue() == hash && equal(n, key))
+            return n;
+        }
+    }
+
+    // The node must not already be in the table.
+    void insert(T* n)
+    {
+      if ((count + 1) * 4 > slots.size() * 3)
+        grow();
+      place(n);
+      count++;
+    }
+
+    // Removes exactly this node (not one that's equal to it).
+    void erase(const T* n)
+    {
+      size_t i = home(n->GetHashValue());
+      while (slots[i] != n)
+        {
+          if (slots[i] == NULL)
+            return;
+          i = (i + 1) & mask();
+        }
+
+      // Shift back entries that probed past the hole.
+      size_t j = i;
+      while (true)
+        {
+          j = (j + 1) & mask();
+          if (slots[j] == NULL)
+            break;
+          const size_t k = home(slots[j]->GetHashValue());
+          const bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+          if (!stays)
+            {
+              slots[i] = slots[j];
+              i = j;
+            }
+        }
+      slots[i] = NULL;
+      count--;
+    }
+
+    void clear()
+    {
+      std::fill(slots.begin(), slots.end(), (T*) NULL);
+      count = 0;
+    }
+
+    size_t size() const
+    {
+      return count;
+    }
+
+    // For walking every node: slot(i) is NULL for empty slots.
+    size_t capacity() const
+    {
+      return slots.size();
+    }
+
+    T* slot(size_t i) const
+    {
+      return slots[i];
+    }
+  };
+} // end namespace BEEV
+#endif
@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "stp/Util/StringHash.h"
 
 #include "stp/config.h"
+#include "stp/AST/ASTVec.h"
 
 #include HASH_SET_H
 #include HASH_MAP_H
@@ -74,11 +75,10 @@ namespace BEEV {
   /******************************************************************
    * Useful typedefs:                                               *
    *                                                                *
-   * Vector of ASTNodes, used for child nodes among other things.   *
+   * ASTVec, the vector of ASTNodes, is in ASTVec.h.                *
    * It is good to define hash_map and hash_set in case we want to  *
    * use libraries other than STL.                                  *
    ******************************************************************/
-  typedef vector<ASTNode> ASTVec;
   typedef unsigned int * CBV;
   extern ASTVec _empty_ASTVec;
 
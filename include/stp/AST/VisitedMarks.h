@@ -0,0 +1,90 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef VISITEDMARKS_H
+#define VISITEDMARKS_H
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include "stp/AST/AST.h"
+
+namespace BEEV
+{
+  /******************************************************************
+   * Class VisitedMarks:                                            *
+   *                                                                *
+   * Records which nodes a traversal has visited, in an array       *
+   * indexed by GetNodeNum(). Each slot holds the epoch it was      *
+   * marked in, so starting a new traversal is just moving to the   *
+   * next epoch; the array only has to be reset when the 32-bit     *
+   * epoch wraps. Get one from STPMgr::acquireVisitedMarks() (or    *
+   * use a VisitedMarksScope), so that traversals that run at the   *
+   * same time, nested or on other threads, each have their own.    *
+   ******************************************************************/
+  class VisitedMarks //not copyable
+  {
+    VisitedMarks(const VisitedMarks&);
+    VisitedMarks& operator=(const VisitedMarks&);
+
+    std::vector<uint32_t> epoch;
+    uint32_t current_epoch;
+
+  public:
+    VisitedMarks() :
+      current_epoch(1)
+    {
+    }
+
+    // Unmarks every node.
+    void clear()
+    {
+      if (++current_epoch == 0)
+        {
+          std::fill(epoch.begin(), epoch.end(), 0);
+          current_epoch = 1;
+        }
+    }
+
+    bool isMarked(const ASTNode& n) const
+    {
+      const size_t num = n.GetNodeNum();
+      return num < epoch.size() && epoch[num] == current_epoch;
+    }
+
+    // Returns false if n was already marked.
+    bool mark(const ASTNode& n)
+    {
+      const size_t num = n.GetNodeNum();
+      if (num >= epoch.size())
+        epoch.resize(std::max(num + 1, 2 * epoch.size()), 0);
+      if (epoch[num] == current_epoch)
+        return false;
+      epoch[num] = current_epoch;
+      return true;
+    }
+  };
+} // end namespace BEEV
+#endif
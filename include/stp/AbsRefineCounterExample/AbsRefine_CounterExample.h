@@ -79,6 +79,12 @@ namespace BEEV
     //function populates the datastructure CounterExampleMap)
     void ConstructCounterExample(SATSolver& newS, ToSATBase::ASTNodeToSATVar& satVarToSymbol);
 
+    // The parts of ConstructCounterExample.
+    void CopySATModel_To_CounterExample(SATSolver& newS, ToSATBase::ASTNodeToSATVar& satVarToSymbol);
+    void CopyArrayReads_To_CounterExample(void);
+
+    SOLVER_RETURN_TYPE CheckSATModel(const ASTNode& original_input);
+
     // Prints MINISAT assigment one bit at a time, for debugging.
     void PrintSATModel(SATSolver& S, ToSATBase::ASTNodeToSATVar& satVarToSymbol);
 
@@ -146,6 +152,14 @@ namespace BEEV
                         ToSATBase* tosat,
                         bool refinement);
 
+    // For a formula that was split into parts that share no symbols,
+    // each of which has been found satisfiable by its own solver.
+    // Builds the counterexample from all the solvers' models.
+    SOLVER_RETURN_TYPE
+    CallSAT_ResultCheck(const vector<SATSolver*>& solvers,
+                        const vector<ToSATBase*>& tosats,
+                        const ASTNode& original_input);
+
     
     SOLVER_RETURN_TYPE 
     SATBased_ArrayReadRefinement(SATSolver& newS,
@@ -24,15 +24,16 @@ THE SOFTWARE.
 
 // vim: tabstop=2:shiftwidth=2:softtabstop=2:expandtab
 
-/* This is ABSOLUTELY DISGUSTING!
- * These globals used by the library should
- * be encapsulated in a "Context" class
- * to allow concurrent usage of the STP library
+/* The "current context" globals below are thread local. Each
+ * thread works with its own STP instance (the C interface rebinds
+ * them to the VC passed to each call), so independent instances
+ * can be used concurrently from different threads.
  */
 
 #ifndef GLOBALS_H
 #define GLOBALS_H
 #include <vector>
+#include "stp/AST/ASTVec.h"
 
 /* FIXME: Clients who import this header file have to have
  * ASTNode already declarted (eurgh)
@@ -81,18 +82,19 @@ namespace BEEV
     };
 
   //Empty vector. Useful commonly used ASTNodes
-  extern std::vector<ASTNode> _empty_ASTVec;
+  extern ASTVec _empty_ASTVec;
 
   // FIXME: Why aren't these defined in Globals.cpp?
   extern ASTNode ASTFalse, ASTTrue, ASTUndefined;
 
-  //Useful global variables. Use for parsing only
-  extern  STP * GlobalSTP;
-  extern  STPMgr * ParserBM;
-  extern Cpp_interface * parserInterface;
+  //The instance the calling thread is working with. Used by the
+  //parsers, and by ASTNode when it needs its STPMgr.
+  extern thread_local STP * GlobalSTP;
+  extern thread_local STPMgr * ParserBM;
+  extern thread_local Cpp_interface * parserInterface;
 
   // Needed by the SMTLIB printer
-  extern enum inputStatus input_status;
+  extern thread_local enum inputStatus input_status;
 
   // Function that computes various kinds of statistics for the phases
   // of STP
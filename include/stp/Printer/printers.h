@@ -48,7 +48,7 @@ namespace printer
 
   ostream& Lisp_Print(ostream &os, 
                       const BEEV::ASTNode& n,  int indentation=0);
-  extern BEEV::ASTNodeSet Lisp_AlreadyPrintedSet;
+  extern thread_local BEEV::ASTNodeSet Lisp_AlreadyPrintedSet;
   ostream& Lisp_Print_indent(ostream &os,  
                              const BEEV::ASTNode& n,int indentation=0);
 
@@ -0,0 +1,94 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef DIFFICULTYMODEL_H_
+#define DIFFICULTYMODEL_H_
+
+#include <string>
+#include <iostream>
+#include "stp/AST/ASTKind.h"
+
+namespace BEEV
+{
+  /******************************************************************
+   * Class DifficultyModel:                                         *
+   *                                                                *
+   * The coefficients that DifficultyScore uses. Each node of kind  *
+   * k scores linear[k]*L + quadratic[k]*Q, where L is its width    *
+   * times its number of children, and Q is its width squared (for  *
+   * comparisons and subtraction, the width of the children is      *
+   * used). The defaults are hand tuned. Other coefficients, fitted *
+   * by fit_difficulty to a log of real bit-blasted sizes, can be   *
+   * read from a file, one "KIND linear quadratic" line per kind.   *
+   ******************************************************************/
+  class DifficultyModel
+  {
+  public:
+    static const int numberOfKinds = BOOLEAN + 1;
+
+  private:
+    double linear[numberOfKinds];
+    double quadratic[numberOfKinds];
+
+  public:
+    DifficultyModel();
+
+    double
+    getLinear(Kind k) const
+    {
+      return linear[k];
+    }
+
+    double
+    getQuadratic(Kind k) const
+    {
+      return quadratic[k];
+    }
+
+    void
+    set(Kind k, double l, double q)
+    {
+      linear[k] = l;
+      quadratic[k] = q;
+    }
+
+    int
+    score(Kind k, double l, double q) const
+    {
+      return static_cast<int>(linear[k] * l + quadratic[k] * q + 0.5);
+    }
+
+    // Kinds not mentioned keep their current coefficients. Returns
+    // false, having changed nothing, if the input is malformed.
+    bool read(std::istream& in);
+    bool load(const std::string& fileName);
+
+    void write(std::ostream& out) const;
+
+    static bool kindFromName(const std::string& name, Kind& k);
+  };
+}
+
+#endif /* DIFFICULTYMODEL_H_ */
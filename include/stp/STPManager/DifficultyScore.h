@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "stp/AST/ASTKind.h"
 #include <list>
 #include "stp/STPManager/NodeIterator.h"
+#include "stp/STPManager/DifficultyModel.h"
 
 // estimate how difficult that input is to solve based on some simple rules.
 
@@ -38,50 +39,56 @@ namespace BEEV
     struct DifficultyScore //not copyable
     {
     private:
+        // The model is the STPMgr's, found on the first call to score.
+        const DifficultyModel* model;
+
         int
         eval(const ASTNode& b)
         {
-            const Kind k = b.GetKind();
-
-            // These scores are approximately the number of AIG nodes created when
-            // no input values are known.
-            int score = 0;
-            if (k == BVMULT)
-                score = (5 * b.GetValueWidth() * b.GetValueWidth());
-            else if (k == BVMOD)
-                score = (15 * b.GetValueWidth() * b.GetValueWidth());
-            else if (isLikeDivision(k))
-                score = (20 * b.GetValueWidth() * b.GetValueWidth());
-            else if (k == BVCONCAT || k == BVEXTRACT || k == NOT)
-                {
-                } // no harder.
-            else if (k == EQ || k == BVGE || k == BVGT || k == BVSGE || k == BVSGT)
-                {
-                    // without getting the width of the child it'd always be 2.
-                    score = std::max(b[0].GetValueWidth(), 1u) * (b.Degree());
-                }
-            else if (k == BVSUB)
-                {
-                    // We convert subtract to a + (-b), we want the difficulty scores to be same.
-                    score = std::max(b[0].GetValueWidth(), 1u) * 3;
-                }
-            else
-                {
-                    score = std::max(b.GetValueWidth(), 1u) * (b.Degree());
-                }
-            return score;
-        }
-
-        static bool
-        isLikeDivision(const Kind& k)
-        {
-            return k == BVMULT || k == BVDIV || k == BVMOD || k == SBVDIV || k == SBVREM || k == SBVMOD;
+            double l, q;
+            features(b, l, q);
+            return model->score(b.GetKind(), l, q);
         }
 
         // maps from nodeNumber to the previously calculated difficulty score..
         std::map<int, int> cache;
 
     public:
+        DifficultyScore() : model(NULL)
+        {
+        }
+
+        // The quantities that the model's coefficients for b's kind multiply.
+        static void
+        features(const ASTNode& b, double& linear, double& quadratic)
+        {
+            const Kind k = b.GetKind();
+
+            // without getting the width of the child it'd always be 2.
+            unsigned width = b.GetValueWidth();
+            if (k == EQ || k == BVGE || k == BVGT || k == BVSGE || k == BVSGT || k == BVSUB)
+                width = b[0].GetValueWidth();
+
+            // Symbols and constants cost nothing.
+            linear = (double) std::max(width, 1u) * b.Degree();
+            quadratic = b.Degree() == 0 ? 0 : (double) width * width;
+        }
+
+        // Sums the features of each kind of node in top, for calibrating the model.
+        static void
+        totals(const ASTNode& top, std::map<Kind, std::pair<double, double> >& result)
+        {
+            NonAtomIterator ni(top, top.GetSTPMgr()->ASTUndefined, *top.GetSTPMgr());
+            ASTNode current;
+            while ((current = ni.next()) != ni.end())
+                {
+                    double l, q;
+                    features(current, l, q);
+                    std::pair<double, double>& t = result[current.GetKind()];
+                    t.first += l;
+                    t.second += q;
+                }
+        }
 
         int
         score(const ASTNode& top)
@@ -89,6 +96,9 @@ namespace BEEV
             if (cache.find(top.GetNodeNum()) != cache.end())
                 return cache.find(top.GetNodeNum())->second;
 
+            if (model == NULL)
+                model = &top.GetSTPMgr()->difficultyModel;
+
             NonAtomIterator ni(top, top.GetSTPMgr()->ASTUndefined, *top.GetSTPMgr());
             ASTNode current;
             int result = 0;
@@ -40,16 +40,20 @@ namespace BEEV
         std::stack<ASTNode> toVisit;
 
         const ASTNode& sentinel;
-        uint8_t iteration;
+        VisitedMarksScope visited;
 
 
     public:
         NodeIterator(const ASTNode &n, const ASTNode &_sentinel, STPMgr& stp) :
-                sentinel(_sentinel), iteration(stp.getNextIteration())
+                sentinel(_sentinel), visited(stp)
         {
             toVisit.push(n);
         }
 
+        virtual ~NodeIterator()
+        {
+        }
+
         ASTNode
         next()
         {
@@ -66,21 +70,21 @@ namespace BEEV
                     if (!ok(result))
                         continue; // Not OK to investigate.
 
-                    if (result.getIteration() != iteration)
+                    if (!visited->isMarked(result))
                         break; // not visited, DONE!
                 }
 
             if (result == sentinel)
                 return result;
 
-            result.setIteration(iteration);
+            visited->mark(result);
 
             const ASTVec& c = result.GetChildren();
             ASTVec::const_iterator itC = c.begin();
             ASTVec::const_iterator itendC = c.end();
             for (; itC != itendC; itC++)
                 {
-                    if (itC->getIteration() == iteration)
+                    if (visited->isMarked(*itC))
                         continue; // already examined.
                     toVisit.push(*itC);
                 }
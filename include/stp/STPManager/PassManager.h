@@ -0,0 +1,111 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef PASSMANAGER_H
+#define PASSMANAGER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include "stp/AST/AST.h"
+#include "stp/STPManager/DifficultyScore.h"
+
+namespace BEEV
+{
+  class STPMgr;
+
+  /******************************************************************
+   * Class PassManager:                                             *
+   *                                                                *
+   * Runs a sequence of named simplification passes over a formula, *
+   * once or to a fixed point, and keeps statistics on what each    *
+   * pass cost and what it achieved. The passes run in the order    *
+   * they were added, unless a pipeline (a comma separated list of  *
+   * names) says otherwise.                                         *
+   *                                                                *
+   * A pass isn't rerun on a formula it has already left unchanged, *
+   * so the last round of a fixed point, which changes nothing,     *
+   * costs little. When finding a fixed point, a pass whose recent  *
+   * yield (the fraction of the difficulty score it removes per     *
+   * run, averaged over its recent runs) is below the minimum yield *
+   * is skipped. A minimum yield of zero turns skipping off.        *
+   ******************************************************************/
+  class PassManager //not copyable
+  {
+  public:
+    typedef std::function<ASTNode(const ASTNode&)> Pass;
+    typedef std::function<bool()> Condition;
+
+    explicit PassManager(STPMgr* bm);
+
+    // The condition is checked before each run, so a pass can be
+    // turned off by the flags.
+    void add(const std::string& name, Pass pass, Condition enabled = Condition());
+
+    // Runs just the passes named, in that order. An empty pipeline
+    // runs all of them. Unknown names are a fatal error.
+    void setPipeline(const std::string& names);
+
+    // Zero, the default, never skips a pass.
+    void setMinimumYield(double yield);
+
+    ASTNode runOnce(const ASTNode& input);
+    ASTNode runToFixedPoint(const ASTNode& input);
+
+    void printStats(std::ostream& os) const;
+
+  private:
+    PassManager(const PassManager&);
+    PassManager& operator=(const PassManager&);
+
+    struct Entry
+    {
+      std::string name;
+      Pass run;
+      Condition enabled;
+
+      unsigned runs;
+      unsigned changes;
+      unsigned skipped;
+      double seconds;
+      long nodesRemoved;
+      long difficultyRemoved;
+      double recentYield;
+
+      // The last formula the pass was run on and didn't change.
+      ASTNode unchanged;
+    };
+
+    STPMgr* bm;
+    std::vector<Entry> passes;
+    std::vector<size_t> pipeline;
+    double minimumYield;
+    DifficultyScore difficulty;
+
+    ASTNode runPass(Entry& e, const ASTNode& input, bool inFixedPoint);
+  };
+} // end namespace BEEV
+#endif
@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include "stp/Parser/LetMgr.h"
 #include "stp/AbsRefineCounterExample/AbsRefine_CounterExample.h"
 #include "stp/Simplifier/PropagateEqualities.h"
+#include "stp/STPManager/PassManager.h"
+#include "stp/Simplifier/constantBitP/AssertedFixedBits.h"
 
 namespace BEEV
 {
@@ -43,7 +45,17 @@ namespace BEEV
 
     
 
-          ASTNode sizeReducing(ASTNode input, BVSolver* bvSolver, PropagateEqualities *pe);
+          // Adds the passes that make the formula smaller.
+          void addSizeReducingPasses(PassManager& passes, BVSolver* bvSolver, PropagateEqualities *pe);
+
+          // One round of substitution, solving, and simplification.
+          ASTNode simplifyRound(const ASTNode& input, BVSolver* bvSolver, PropagateEqualities *pe);
+
+          // Repeats simplifyRound until the formula stops changing. When
+          // there are lots of top level conjuncts, later rounds only look
+          // at the conjuncts that have changed, or that contain something
+          // that has been substituted for since.
+          ASTNode simplifyToFixedPoint(const ASTNode& input, BVSolver* bvSolver, PropagateEqualities *pe);
 
           // A copy of all the state we need to restore to a prior expression.
           struct Revert_to
@@ -53,6 +65,18 @@ namespace BEEV
             ArrayTransformer::ArrType backup_arrayToIndexToRead; // array-indices already removed.
           };
 
+          // A new SAT solver of the kind in the user flags. It stops
+          // early once "interrupt" is set, which is the soft timeout
+          // flag unless another is given.
+          SATSolver* newSATSolver();
+          SATSolver* newSATSolver(volatile bool& interrupt);
+
+          // Solves each of the formulas, which share no symbols, with its
+          // own solver, on "component-threads" threads. Returns VALID as
+          // soon as one is unsatisfiable, else builds the counterexample
+          // from all the models.
+          SOLVER_RETURN_TYPE solveComponents(const std::vector<ASTNode>& components, const ASTNode& original_input);
+
           // Accepts query and returns the answer. if query is valid,
           // returns VALID, else returns INVALID. Automatically constructs
           // counterexample for invalid queries, and prints them upon
@@ -65,8 +89,9 @@ namespace BEEV
   public:
 ArrayTransformer * arrayTransformer;
     
-          // calls sizeReducing and the bitblasting simplification.
-          ASTNode callSizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe, const int initial_difficulty_score, int & actualBBSize);
+          // runs the size reducing passes to a fixed point, then the
+          // bitblasting simplification.
+          ASTNode callSizeReducing(ASTNode simplified_solved_InputToSAT, PassManager& sizeReducing, const int initial_difficulty_score, int & actualBBSize);
 
 
     /****************************************************************
@@ -79,6 +104,11 @@ ArrayTransformer * arrayTransformer;
     ToSATBase * tosat;
     AbsRefine_CounterExample * Ctr_Example;
 
+    // The fixed bits of the assertions. Kept up to date by the C
+    // interface, so that queries against the same assertions don't
+    // propagate them again.
+    simplifier::constantBitP::AssertedFixedBits assertedFixedBits;
+
     /****************************************************************
      * Constructor and Destructor                                   *
      ****************************************************************/
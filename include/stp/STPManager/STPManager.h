@@ -26,8 +26,13 @@ THE SOFTWARE.
 #ifndef STPMGR_H
 #define STPMGR_H
 
+#include <mutex>
 #include "stp/STPManager/UserDefinedFlags.h"
+#include "stp/STPManager/DifficultyModel.h"
 #include "stp/AST/AST.h"
+#include "stp/AST/NodeSlab.h"
+#include "stp/AST/NodeUniqueTable.h"
+#include "stp/AST/VisitedMarks.h"
 #include "stp/AST/NodeFactory/HashingNodeFactory.h"
 #include "stp/Sat/SATSolver.h"
 
@@ -52,21 +57,18 @@ namespace BEEV
      ****************************************************************/
 
     // Typedef for unique Interior node table.
-    typedef hash_set<
-    ASTInterior *, 
-    ASTInterior::ASTInteriorHasher, 
+    typedef NodeUniqueTable<
+    ASTInterior, 
     ASTInterior::ASTInteriorEqual> ASTInteriorSet;    
 
     // Typedef for unique Symbol node (leaf) table.
-    typedef hash_set<
-      ASTSymbol *, 
-      ASTSymbol::ASTSymbolHasher, 
+    typedef NodeUniqueTable<
+      ASTSymbol, 
       ASTSymbol::ASTSymbolEqual> ASTSymbolSet;
 
     //Typedef for unique BVConst node (leaf) table.
-    typedef hash_set<
-      ASTBVConst *, 
-      ASTBVConst::ASTBVConstHasher, 
+    typedef NodeUniqueTable<
+      ASTBVConst, 
       ASTBVConst::ASTBVConstEqual> ASTBVConstSet;
 
 #if 0
@@ -86,10 +88,18 @@ namespace BEEV
     // Table to uniquefy bvconst
     ASTBVConstSet _bvconst_unique_table;
 
+    // Storage for the nodes held in the unique tables. Nodes are
+    // placement-new'd into these, and handed back by CleanUp().
+    NodeSlab interior_slab;
+    NodeSlab symbol_slab;
+    NodeSlab bvconst_slab;
+
     // Global for assigning new node numbers.
     int _max_node_num;
 
-    uint8_t last_iteration;
+    // Visited marks that aren't in use, kept for the next traversal.
+    std::vector<VisitedMarks*> visited_marks_pool;
+    std::mutex visited_marks_lock;
 
       public:
     HashingNodeFactory* hashingNodeFactory;
@@ -100,37 +110,24 @@ namespace BEEV
 
     volatile bool soft_timeout_expired;
 
-    // No nodes should already have the iteration number that is returned from here.
-    // This never returns zero.
-    uint8_t getNextIteration()
-    {
-        if (last_iteration == 255)
-            {
-                resetIteration();
-                last_iteration = 0;
-            }
-
-        uint8_t result =  ++last_iteration;
-        assert(result != 0);
-        return result;
-    }
+    // Visited marks for a traversal, with nothing marked. Each
+    // traversal that's running has its own, so they can nest, or run
+    // on several threads. Give them back with releaseVisitedMarks().
+    VisitedMarks* acquireVisitedMarks();
+    void releaseVisitedMarks(VisitedMarks* marks);
 
-    // Detauls the iteration count back to zero.
-    void resetIteration()
+    size_t getAssertLevel()
     {
-        for (ASTInteriorSet::iterator it =_interior_unique_table.begin(); it != _interior_unique_table.end(); it++ )
-            {(*it)->iteration = 0;}
-
-        for (ASTSymbolSet ::iterator it =_symbol_unique_table.begin(); it != _symbol_unique_table.end(); it++ )
-            {(*it)->iteration = 0;}
-
-        for (ASTBVConstSet:: iterator it =_bvconst_unique_table.begin(); it != _bvconst_unique_table.end(); it++ )
-            {(*it)->iteration = 0;}
+      return _asserts.size();
     }
 
-    size_t getAssertLevel()
+    // The number of assertions in all the logical contexts.
+    size_t getAssertCount() const
     {
-      return _asserts.size();
+      size_t count = 0;
+      for (size_t i = 0; i < _asserts.size(); i++)
+        count += _asserts[i]->size();
+      return count;
     }
 
   private:
@@ -142,6 +139,12 @@ namespace BEEV
     // created by PUSH/POP
     std::vector<ASTVec*> _asserts;
 
+    // The introduced symbols created while there was a logical
+    // context, and for each context, where its own start.
+    // Pop() only looks at the symbols of the context it pops.
+    ASTVec _level_introduced_symbols;
+    std::vector<size_t> _level_first_introduced;
+
     // Memo table that tracks terms already seen
     ASTNodeMap TermsAlreadySeenMap;
     
@@ -161,12 +164,13 @@ namespace BEEV
     // nodes are not modified.  Then it returns the hashed copy of the
     // node, which is created if necessary.
     ASTInterior *CreateInteriorNode(Kind kind, 
-                                    ASTInterior *new_node,
+                                    ASTInterior& new_node,
                                     const ASTVec & back_children = 
                                     _empty_ASTVec);
 
-    // Create unique ASTInterior node.
-    ASTInterior *LookupOrCreateInterior(ASTInterior *n);
+    // Create unique ASTInterior node. The argument is a temporary key,
+    // its children are moved into the new node if one is created.
+    ASTInterior *LookupOrCreateInterior(ASTInterior& n);
 
     // Create unique ASTSymbol node.
     ASTSymbol *LookupOrCreateSymbol(ASTSymbol& s);
@@ -197,6 +201,10 @@ namespace BEEV
      * Public Flags                                                 *
      ****************************************************************/    
     UserDefinedFlags UserFlags;
+
+    // Coefficients that DifficultyScore estimates the bit-blasted
+    // size of formulas with.
+    DifficultyModel difficultyModel;
     
     // This flag, when true, indicates that counterexample is being
     // checked by the counterexample checker
@@ -231,10 +239,12 @@ namespace BEEV
 
     // Constructor
     STPMgr() : 
-      _interior_unique_table(),
-      _symbol_unique_table(),
-      _bvconst_unique_table(),
-      last_iteration(0),
+      _interior_unique_table(16),
+      _symbol_unique_table(10),
+      _bvconst_unique_table(10),
+      interior_slab(this, sizeof(ASTInterior)),
+      symbol_slab(this, sizeof(ASTSymbol)),
+      bvconst_slab(this, sizeof(ASTBVConst)),
       soft_timeout_expired(false),
       UserFlags(),
       _symbol_count(0),
@@ -440,6 +450,9 @@ namespace BEEV
     //prints statistics for the ASTNode.
     void ASTNodeStats(const char * c, const ASTNode& a);
 
+    // prints how many nodes the slabs have handed out.
+    void printNodeAllocationStats();
+
     // Print variable to the input stream
     void printVarDeclsToStream(ostream &os, ASTNodeSet& symbols);
 
@@ -456,6 +469,8 @@ namespace BEEV
 
         BEEV::ASTNode CurrentSymbol = CreateSymbol(d,indexWidth,valueWidth);
         Introduced_SymbolsSet.insert(CurrentSymbol);
+        if (!_level_first_introduced.empty())
+          _level_introduced_symbols.push_back(CurrentSymbol);
         return CurrentSymbol;
     }
 
@@ -493,5 +508,36 @@ namespace BEEV
     ~STPMgr();
 
   };//End of Class STPMgr
+
+  // Holds visited marks from the STPMgr for as long as it's in scope.
+  class VisitedMarksScope //not copyable
+  {
+    VisitedMarksScope(const VisitedMarksScope&);
+    VisitedMarksScope& operator=(const VisitedMarksScope&);
+
+    STPMgr& bm;
+    VisitedMarks* marks;
+
+  public:
+    explicit VisitedMarksScope(STPMgr& _bm) :
+      bm(_bm), marks(_bm.acquireVisitedMarks())
+    {
+    }
+
+    ~VisitedMarksScope()
+    {
+      bm.releaseVisitedMarks(marks);
+    }
+
+    VisitedMarks& operator*() const
+    {
+      return *marks;
+    }
+
+    VisitedMarks* operator->() const
+    {
+      return marks;
+    }
+  };
 } //end of namespace
 #endif
@@ -184,6 +184,7 @@ namespace BEEV
       set("enable-unconstrained","0");
       set("use-intervals","0");
       set("pure-literals","0");
+      set("narrow-widths","0");
       set("simple-cnf","1");
       set("always_true","0");
 	   set("bitblast-simplification","0");
@@ -194,18 +194,19 @@ public:
 		cacheType ptrToOrig;
     	// This needs to be done after bitblasting because the PI nodes will be altered.
 
-    	for (BBNodeManagerAIG::SymbolToBBNode::iterator it = mgr.symbolToBBNode.begin(); it!= mgr.symbolToBBNode.end();it++)
+    	for (size_t j = 0; j < mgr.symbolToBBNode.size(); j++)
 		{
-			ASTNode fresh = it->first; // the fresh variable.
+			ASTNode fresh = mgr.symbolToBBNode.key(j); // the fresh variable.
 			assert(fresh.GetKind() == SYMBOL);
 
+			const vector<BBNodeAIG>& bits = mgr.symbolToBBNode.value(j);
 			ASTNode result;
 			if (varToNodeMap.find(fresh)== varToNodeMap.end())
-				result = it->first; // It's not a fresh variable. i.e. it's a propositional var. in the original formula.
+				result = fresh; // It's not a fresh variable. i.e. it's a propositional var. in the original formula.
 			else
 				result = varToNodeMap.find(fresh)->second; // what it replaced.
-			assert((it->second).size() == 1); // should be a propositional variable.
-			const int index = (it->second)[0].symbol_index; // This is the index of the pi.
+			assert(bits.size() == 1); // should be a propositional variable.
+			const int index = bits[0].symbol_index; // This is the index of the pi.
 			Aig_Obj_t * pi = Aig_ManPi(mgr.aigMgr,index);
 			ptrToOrig.insert(make_pair(pi,result));
 		}
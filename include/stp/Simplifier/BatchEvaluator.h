@@ -0,0 +1,114 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef BATCHEVALUATOR_H
+#define BATCHEVALUATOR_H
+
+#include <vector>
+#include <stdint.h>
+#include "stp/AST/AST.h"
+#include "stp/AST/NodeSideTable.h"
+
+namespace BEEV
+{
+  class STPMgr;
+
+  /******************************************************************
+   * Class BatchEvaluator:                                          *
+   *                                                                *
+   * Evaluates a DAG under up to 64 assignments to its symbols at   *
+   * once. Each bit of a node is held as a 64-bit word with one bit *
+   * per assignment (a "lane"), so a w-bit term is w words and a    *
+   * formula is one word. Every operation is then done on all the   *
+   * lanes together with word-wide logic: additions are ripple      *
+   * carry, shifts are barrel shifters, and so on. It's for         *
+   * checking lots of models cheaply, e.g. random simulation, or    *
+   * testing candidate rewrite rules.                               *
+   *                                                                *
+   * Symbols that haven't been given a value are zero (false) in    *
+   * every lane. Division by zero gives what NonMemberBVConst-      *
+   * Evaluator gives with division_by_zero_returns_one_flag set.    *
+   * Arrays aren't supported.                                       *
+   ******************************************************************/
+  class BatchEvaluator //not copyable
+  {
+  public:
+    typedef uint64_t Word;
+
+    enum
+    {
+      Lanes = 64
+    };
+
+    explicit BatchEvaluator(STPMgr* bm);
+
+    // Gives the symbol the value of the constant (a BVCONST, or
+    // ASTTrue/ASTFalse) in the lane.
+    void setValue(const ASTNode& symbol, unsigned lane, const ASTNode& value);
+
+    // Same, for symbols of 64 bits or less. Boolean symbols are true
+    // if the value isn't zero.
+    void setValue(const ASTNode& symbol, unsigned lane, uint64_t value);
+
+    // Evaluates n, and everything below it, in every lane. Returns
+    // false if n contains something that can't be evaluated.
+    bool evaluate(const ASTNode& n);
+
+    // The value of an evaluated node in the lane: a BVCONST, or
+    // ASTTrue/ASTFalse.
+    ASTNode getValue(const ASTNode& n, unsigned lane) const;
+
+    // Same, for terms of 64 bits or less.
+    uint64_t getUint64(const ASTNode& n, unsigned lane) const;
+
+    // For an evaluated formula, the lanes in which it's true.
+    Word getLanes(const ASTNode& n) const;
+
+    // Forgets the values of the symbols and the results.
+    void clear();
+
+  private:
+    BatchEvaluator(const BatchEvaluator&);
+    BatchEvaluator& operator=(const BatchEvaluator&);
+
+    STPMgr* bm;
+
+    // Where each node's words start. Symbols are kept separately
+    // from everything else, as the results are thrown away when a
+    // symbol changes.
+    NodeSideTable<size_t> symbolOffset;
+    std::vector<Word> symbolWords;
+    NodeSideTable<size_t> resultOffset;
+    std::vector<Word> resultWords;
+    bool stale;
+
+    static unsigned numberOfWords(const ASTNode& n);
+
+    Word* symbolSlices(const ASTNode& symbol);
+    const Word* find(const ASTNode& n) const;
+    bool visit(const ASTNode& n);
+  };
+} // end namespace BEEV
+#endif
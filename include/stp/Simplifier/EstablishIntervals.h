@@ -24,7 +24,7 @@ THE SOFTWARE.
 ********************************************************************/
 
 /*
- * Performs a basic unsigned interval analysis.
+ * Performs an interval analysis, with both unsigned and signed intervals.
  */
 
 #ifndef ESTABLISHINTERVALS_H_
@@ -33,11 +33,13 @@ THE SOFTWARE.
 #include "stp/STPManager/STPManager.h"
 #include "stp/Simplifier/simplifier.h"
 #include "stp/AST/NodeFactory/SimplifyingNodeFactory.h"
+#include "stp/AST/NodeSideTable.h"
 
 #ifdef _MSC_VER
 #include <compdep.h>
 #endif
 
+#include <deque>
 #include <iostream>
 using std::cerr;
 using std::endl;
@@ -107,9 +109,21 @@ namespace BEEV
 
     };
 
-    vector<EstablishIntervals::IntervalType * > toDeleteLater;
+    // NULL is the complete domain.
+    typedef NodeSideTable<IntervalType*> NodeToInterval;
+
+    // Owns the intervals. A deque so the pointers stay valid.
+    std::deque<IntervalType> intervals;
     vector<CBV> likeAutoPtr;
 
+    // Bounds read off the top level conjuncts, which hold in every
+    // model of the formula.
+    NodeToInterval unsignedBounds;
+    NodeToInterval signedBounds;
+
+    // Set when the intervals show the formula can't be satisfied.
+    bool conflict;
+
     IntervalType * freshUnsignedInterval(int width)
     {
       assert(width > 0);
@@ -120,9 +134,8 @@ namespace BEEV
 
     IntervalType * createInterval(CBV min, CBV max)
     {
-      IntervalType *it = new IntervalType(min,max);
-      toDeleteLater.push_back(it);
-      return it ;
+      intervals.push_back(IntervalType(min,max));
+      return &intervals.back();
     }
 
     CBV makeCBV(int width)
@@ -132,6 +145,91 @@ namespace BEEV
         return result;
     }
 
+    CBV copyCBV(const CBV c)
+    {
+        CBV result = CONSTANTBV::BitVector_Clone(c);
+        likeAutoPtr.push_back(result);
+        return result;
+    }
+
+    // 1000...0, the most negative signed number.
+    CBV signedMin(int width)
+    {
+        CBV result = makeCBV(width);
+        CONSTANTBV::BitVector_Bit_On(result, width - 1);
+        return result;
+    }
+
+    // 0111...1, the most positive signed number.
+    CBV signedMax(int width)
+    {
+        CBV result = makeCBV(width);
+        CONSTANTBV::BitVector_Fill(result);
+        CONSTANTBV::BitVector_Bit_Off(result, width - 1);
+        return result;
+    }
+
+    static int compare(const CBV a, const CBV b, bool isSigned)
+    {
+      return isSigned ? CONSTANTBV::BitVector_Compare(a, b) : CONSTANTBV::BitVector_Lexicompare(a, b);
+    }
+
+    static bool sameSign(const IntervalType* it, int width)
+    {
+      return CONSTANTBV::BitVector_bit_test(it->minV, width - 1) == CONSTANTBV::BitVector_bit_test(it->maxV, width - 1);
+    }
+
+    // Both ends of the interval are in the other domain's order too
+    // when they have the same sign.
+    static IntervalType* sameInBoth(IntervalType* it, int width)
+    {
+      return (it != NULL && sameSign(it, width)) ? it : NULL;
+    }
+
+    bool isComplete(const IntervalType* it, int width, bool isSigned)
+    {
+      if (!isSigned)
+        return CONSTANTBV::BitVector_is_empty(it->minV) && CONSTANTBV::BitVector_is_full(it->maxV);
+      return CONSTANTBV::BitVector_bit_test(it->minV, width - 1) && CONSTANTBV::Set_Norm(it->minV) == 1
+          && !CONSTANTBV::BitVector_bit_test(it->maxV, width - 1) && CONSTANTBV::Set_Norm(it->maxV) == (unsigned) width - 1;
+    }
+
+    // The intersection of two intervals, NULL being the complete
+    // domain. An empty intersection sets "conflict".
+    IntervalType* intersect(IntervalType* a, IntervalType* b, bool isSigned)
+    {
+      if (a == NULL)
+        return b;
+      if (b == NULL)
+        return a;
+      CBV min = (compare(a->minV, b->minV, isSigned) >= 0) ? a->minV : b->minV;
+      CBV max = (compare(a->maxV, b->maxV, isSigned) <= 0) ? a->maxV : b->maxV;
+      if (min == a->minV && max == a->maxV)
+        return a;
+      if (min == b->minV && max == b->maxV)
+        return b;
+      if (compare(min, max, isSigned) > 0)
+        {
+          conflict = true;
+          return a;
+        }
+      return createInterval(min, max);
+    }
+
+    // Whether a > b (or a >= b) is known, as [1,1] or [0,0].
+    IntervalType* compareIntervals(const IntervalType* a, const IntervalType* b, bool orEqual, bool isSigned)
+    {
+      if (a == NULL || b == NULL)
+        return NULL;
+      const int low = compare(a->minV, b->maxV, isSigned);
+      const int high = compare(a->maxV, b->minV, isSigned);
+      if (orEqual ? low >= 0 : low > 0)
+        return createInterval(littleOne, littleOne);
+      if (orEqual ? high < 0 : high <= 0)
+        return createInterval(littleZero, littleZero);
+      return NULL;
+    }
+
     // A special version that handles the lhs appearing in the rhs of the fromTo map.
     ASTNode replace(const ASTNode& n, ASTNodeMap& fromTo, ASTNodeMap& cache)
     {
@@ -176,20 +274,42 @@ namespace BEEV
     }
 
   public:
-    // Replace some of the things that unsigned intervals can figure out for us.
+    // Replace some of the things that intervals can figure out for us.
     // Reduce from signed to unsigned if possible.
     ASTNode topLevel_unsignedIntervals(const ASTNode&top)
     {
       bm.GetRunTimes()->start(RunTimes::IntervalPropagation);
-      map<const ASTNode, IntervalType*> visited;
-      map<const ASTNode, IntervalType*> clockwise;
-      visit(top,visited, clockwise);
+
+      // The conjuncts that bound a term are kept as they are, so that
+      // they aren't simplified away by the bounds they give.
+      ASTVec conjuncts;
+      if (AND == top.GetKind())
+        conjuncts = top.GetChildren();
+      else
+        conjuncts.push_back(top);
+      vector<bool> isBound(conjuncts.size());
+      unsignedBounds.clear();
+      signedBounds.clear();
+      conflict = false;
+      for (size_t i = 0; i < conjuncts.size(); i++)
+        isBound[i] = readBound(conjuncts[i]);
+
+      NodeToInterval visited;
+      NodeToInterval signedIntervals;
+      if (!conflict)
+        visit(top,visited, signedIntervals);
+      if (conflict)
+        {
+          bm.GetRunTimes()->stop(RunTimes::IntervalPropagation);
+          return bm.ASTFalse;
+        }
+
       ASTNodeMap fromTo;
       ASTNodeMap onePass;
-      for (map<const ASTNode, IntervalType*>::const_iterator it = visited.begin(); it != visited.end(); it++)
+      for (size_t i = 0; i < visited.size(); i++)
       {
-          const ASTNode& n = it->first;
-          IntervalType *interval = it->second;
+          const ASTNode& n = visited.key(i);
+          IntervalType *interval = visited.value(i);
           const int width = n.GetValueWidth();
 
           if (n.isConstant())
@@ -202,16 +322,16 @@ namespace BEEV
           if ((interval == NULL || !interval->isConstant())
             && (k == BVSGT || k == BVSGE || k == SBVDIV || k == BVSRSHIFT || k == SBVREM || k == BVSX))
                 {
-                  map<const ASTNode, IntervalType*>::const_iterator l = visited.find(n[0]);
-                  map<const ASTNode, IntervalType*>::const_iterator r = visited.find(n[1]);
+                  IntervalType** l = visited.find(n[0]);
+                  IntervalType** r = visited.find(n[1]);
 
                   bool lhs, rhs; // isFalse.
 
-                  if (l == visited.end())
+                  if (l == NULL)
                     lhs = false;
                   else
                     {
-                      IntervalType * a = (*l).second;
+                      IntervalType * a = *l;
                       if (a == NULL)
                         lhs = false;
                       else
@@ -220,11 +340,11 @@ namespace BEEV
                         }
                     }
 
-                  if (r == visited.end())
+                  if (r == NULL)
                     rhs = false;
                   else
                     {
-                      IntervalType * b = (*r).second;
+                      IntervalType * b = *r;
                       if (b == NULL)
                         rhs = false;
                       else
@@ -331,42 +451,317 @@ namespace BEEV
             }
       }
 
-      ASTNode result = top;
-      if (onePass.size() > 0)
+      if (onePass.empty() && fromTo.empty())
         {
-          // The rhs of the map contains the lhs, so it needs to be applied specially.
-          ASTNodeMap cache;
-          result =  replace(top, onePass, cache);
+          bm.GetRunTimes()->stop(RunTimes::IntervalPropagation);
+          return top;
         }
 
-      if (fromTo.size() > 0)
+      ASTVec result;
+      ASTNodeMap onePassCache;
+      ASTNodeMap cache;
+      for (size_t i = 0; i < conjuncts.size(); i++)
         {
-          ASTNodeMap cache;
-
-          bm.GetRunTimes()->stop(RunTimes::IntervalPropagation);
-          return SubstitutionMap::replace(result,fromTo,cache,top.GetSTPMgr()->defaultNodeFactory);
+          ASTNode c = conjuncts[i];
+          if (!isBound[i])
+            {
+              // The rhs of the onePass map contains the lhs, so it needs to be applied specially.
+              if (onePass.size() > 0)
+                c = replace(c, onePass, onePassCache);
+              if (fromTo.size() > 0)
+                c = SubstitutionMap::replace(c,fromTo,cache,top.GetSTPMgr()->defaultNodeFactory);
+            }
+          result.push_back(c);
         }
 
       bm.GetRunTimes()->stop(RunTimes::IntervalPropagation);
-      return result;
+      if (result == conjuncts)
+        return top;
+      return (result.size() == 1) ? result[0] : nf->CreateNode(AND, result);
     }
 
 
   private:
+    // If the conjunct compares a term with a constant, adds the bound it
+    // gives the term to unsignedBounds or signedBounds.
+    bool readBound(const ASTNode& conjunct)
+    {
+      const bool negated = (NOT == conjunct.GetKind());
+      const ASTNode& c = negated ? conjunct[0] : conjunct;
+      Kind k = c.GetKind();
+
+      bool isSigned;
+      switch (k)
+        {
+      case BVGT: case BVGE: case BVLT: case BVLE:
+        isSigned = false;
+        break;
+      case BVSGT: case BVSGE: case BVSLT: case BVSLE:
+        isSigned = true;
+        break;
+      case EQ:
+        if (negated)
+          return false;
+        isSigned = false;
+        break;
+      default:
+        return false;
+        }
+
+      if (BITVECTOR_TYPE != c[0].GetType() || (BVCONST == c[0].GetKind()) == (BVCONST == c[1].GetKind()))
+        return false;
+
+      // Makes it "term op constant", op being > >= < <= or =.
+      const bool constantFirst = (BVCONST == c[0].GetKind());
+      const ASTNode& term = constantFirst ? c[1] : c[0];
+      const CBV constant = (constantFirst ? c[0] : c[1]).GetBVConst();
+      const int width = term.GetValueWidth();
+
+      bool greater = (k == BVGT || k == BVGE || k == BVSGT || k == BVSGE);
+      bool orEqual = (k == BVGE || k == BVLE || k == BVSGE || k == BVSLE);
+      if (constantFirst)
+        greater = !greater;
+      if (negated)
+        {
+          greater = !greater;
+          orEqual = !orEqual;
+        }
+
+      IntervalType* bound;
+      if (EQ == k)
+        bound = createInterval(constant, constant);
+      else if (greater)
+        {
+          bound = createInterval(copyCBV(constant), isSigned ? signedMax(width) : makeCBV(width));
+          if (!isSigned)
+            CONSTANTBV::BitVector_Fill(bound->maxV);
+          if (!orEqual)
+            {
+              if (compare(bound->minV, bound->maxV, isSigned) == 0)
+                conflict = true; // greater than the largest number.
+              else
+                CONSTANTBV::BitVector_increment(bound->minV);
+            }
+        }
+      else
+        {
+          bound = createInterval(isSigned ? signedMin(width) : makeCBV(width), copyCBV(constant));
+          if (!orEqual)
+            {
+              if (compare(bound->minV, bound->maxV, isSigned) == 0)
+                conflict = true; // less than the smallest number.
+              else
+                CONSTANTBV::BitVector_decrement(bound->maxV);
+            }
+        }
+
+      if (EQ == k || !isSigned)
+        {
+          IntervalType** current = unsignedBounds.find(term);
+          unsignedBounds[term] = intersect(current == NULL ? NULL : *current, bound, false);
+        }
+      if (EQ == k || isSigned)
+        {
+          IntervalType** current = signedBounds.find(term);
+          signedBounds[term] = intersect(current == NULL ? NULL : *current, bound, true);
+        }
+      return true;
+    }
+
+    // The signed interval of n, from the signed intervals of its children.
+    IntervalType* visitSigned(const ASTNode& n, NodeToInterval & signedIntervals)
+    {
+      const int width = n.GetValueWidth();
+      const int number_children = n.Degree();
+      vector<IntervalType* > children;
+      children.reserve(number_children);
+      bool allKnown = true;
+      for (int i=0; i < number_children;i++)
+        {
+          IntervalType** it = signedIntervals.find(n[i]);
+          children.push_back(it == NULL ? NULL : *it);
+          allKnown &= (children.back() != NULL);
+        }
+
+      IntervalType* result = NULL;
+      switch (n.GetKind())
+        {
+      case BVSX:
+        {
+          // Unknown means anything the narrower width can hold.
+          const int from = n[0].GetValueWidth();
+          IntervalType* c = children[0];
+          if (c == NULL)
+            c = createInterval(signedMin(from), signedMax(from));
+          result = createInterval(makeCBV(width), makeCBV(width));
+          CONSTANTBV::BitVector_Interval_Copy(result->minV, c->minV, 0, 0, from);
+          CONSTANTBV::BitVector_Interval_Copy(result->maxV, c->maxV, 0, 0, from);
+          if (CONSTANTBV::BitVector_bit_test(c->minV, from - 1))
+            CONSTANTBV::BitVector_Interval_Fill(result->minV, from, width - 1);
+          if (CONSTANTBV::BitVector_bit_test(c->maxV, from - 1))
+            CONSTANTBV::BitVector_Interval_Fill(result->maxV, from, width - 1);
+        }
+        break;
+
+      case ITE:
+        if (children[1] != NULL && children[2] != NULL)
+          {
+            result = createInterval(
+                compare(children[1]->minV, children[2]->minV, true) < 0 ? children[1]->minV : children[2]->minV,
+                compare(children[1]->maxV, children[2]->maxV, true) > 0 ? children[1]->maxV : children[2]->maxV);
+          }
+        break;
+
+      case BVPLUS:
+      case BVSUB:
+        if (allKnown)
+          {
+            // Nothing is known if a sum can overflow.
+            const bool minus = (BVSUB == n.GetKind());
+            result = createInterval(copyCBV(children[0]->minV), copyCBV(children[0]->maxV));
+            bool overflow = false;
+            for (int i = 1; i < number_children && !overflow; i++)
+              {
+                bool carry = false;
+                overflow |= CONSTANTBV::BitVector_compute(result->minV, result->minV, minus ? children[i]->maxV : children[i]->minV, minus, &carry);
+                carry = false;
+                overflow |= CONSTANTBV::BitVector_compute(result->maxV, result->maxV, minus ? children[i]->minV : children[i]->maxV, minus, &carry);
+              }
+            if (overflow)
+              result = NULL;
+          }
+        break;
+
+      case BVUMINUS:
+        if (allKnown && compare(children[0]->minV, signedMin(width), true) != 0)
+          {
+            result = createInterval(makeCBV(width), makeCBV(width));
+            CONSTANTBV::BitVector_Negate(result->minV, children[0]->maxV);
+            CONSTANTBV::BitVector_Negate(result->maxV, children[0]->minV);
+          }
+        break;
+
+      case BVNEG:
+        if (allKnown)
+          {
+            result = createInterval(copyCBV(children[0]->maxV), copyCBV(children[0]->minV));
+            CONSTANTBV::BitVector_Flip(result->minV);
+            CONSTANTBV::BitVector_Flip(result->maxV);
+          }
+        break;
+
+      case BVMULT:
+        if (allKnown)
+          {
+            // The products of the ends, at double the width so they can't overflow.
+            result = children[0];
+            CBV a = CONSTANTBV::BitVector_Create(2 * width, true);
+            CBV b = CONSTANTBV::BitVector_Create(2 * width, true);
+            CBV product = CONSTANTBV::BitVector_Create(2 * width, true);
+            for (int i = 1; i < number_children && result != NULL; i++)
+              {
+                IntervalType* next = NULL;
+                CBV ends[2][2] = {{result->minV, result->maxV}, {children[i]->minV, children[i]->maxV}};
+                for (int x = 0; x < 2 && result != NULL; x++)
+                  for (int y = 0; y < 2 && result != NULL; y++)
+                    {
+                      signExtend(a, ends[0][x], width);
+                      signExtend(b, ends[1][y], width);
+                      CONSTANTBV::ErrCode e = CONSTANTBV::BitVector_Multiply(product, a, b);
+                      assert(0 == e);
+                      (void) e;
+
+                      // Does it fit in the width?
+                      const bool sign = CONSTANTBV::BitVector_bit_test(product, width - 1);
+                      for (int j = width; j < 2 * width && result != NULL; j++)
+                        if (CONSTANTBV::BitVector_bit_test(product, j) != sign)
+                          result = NULL;
+                      if (result == NULL)
+                        break;
+
+                      CBV p = makeCBV(width);
+                      CONSTANTBV::BitVector_Interval_Copy(p, product, 0, 0, width);
+                      if (next == NULL)
+                        next = createInterval(p, p);
+                      else if (compare(p, next->minV, true) < 0)
+                        next->minV = p;
+                      else if (compare(p, next->maxV, true) > 0)
+                        next->maxV = p;
+                    }
+                if (result != NULL)
+                  result = next;
+              }
+            CONSTANTBV::BitVector_Destroy(a);
+            CONSTANTBV::BitVector_Destroy(b);
+            CONSTANTBV::BitVector_Destroy(product);
+          }
+        break;
+
+      case BVSRSHIFT:
+        if (children[0] != NULL && BVCONST == n[1].GetKind())
+          {
+            // Shifting by the width or more leaves just the sign.
+            unsigned shift = width;
+            if (CONSTANTBV::Set_Max(n[1].GetBVConst()) < 32)
+              shift = std::min((unsigned)width, n[1].GetUnsignedConst());
+            result = createInterval(copyCBV(children[0]->minV), copyCBV(children[0]->maxV));
+            for (unsigned i = 0; i < shift; i++)
+              {
+                CONSTANTBV::BitVector_shift_right(result->minV, CONSTANTBV::BitVector_bit_test(result->minV, width - 1));
+                CONSTANTBV::BitVector_shift_right(result->maxV, CONSTANTBV::BitVector_bit_test(result->maxV, width - 1));
+              }
+          }
+        break;
+
+      case BVEXTRACT:
+        if (children[0] != NULL && 0 == n[2].GetUnsignedConst())
+          {
+            // If both ends fit in the narrower width, everything between does.
+            const int from = n[0].GetValueWidth();
+            bool fits = true;
+            for (int j = width; j < from; j++)
+              {
+                fits &= CONSTANTBV::BitVector_bit_test(children[0]->minV, j) == CONSTANTBV::BitVector_bit_test(children[0]->minV, width - 1);
+                fits &= CONSTANTBV::BitVector_bit_test(children[0]->maxV, j) == CONSTANTBV::BitVector_bit_test(children[0]->maxV, width - 1);
+              }
+            if (fits)
+              {
+                result = createInterval(makeCBV(width), makeCBV(width));
+                CONSTANTBV::BitVector_Interval_Copy(result->minV, children[0]->minV, 0, 0, width);
+                CONSTANTBV::BitVector_Interval_Copy(result->maxV, children[0]->maxV, 0, 0, width);
+              }
+          }
+        break;
+
+      default:
+        break;
+        }
+      return result;
+    }
+
+    // dst (of twice the width) = src sign extended.
+    static void signExtend(CBV dst, const CBV src, int width)
+    {
+      CONSTANTBV::BitVector_Empty(dst);
+      CONSTANTBV::BitVector_Interval_Copy(dst, src, 0, 0, width);
+      if (CONSTANTBV::BitVector_bit_test(src, width - 1))
+        CONSTANTBV::BitVector_Interval_Fill(dst, width, 2 * width - 1);
+    }
+
     // A single pass through the problem replacing things that must be true of false.
-    // clockwise are intervals that go clockwise around the circle from low to high.
-    IntervalType* visit(const ASTNode& n, map<const ASTNode, IntervalType*> & visited, map<const ASTNode, IntervalType*> & clockwise)
+    // The unsigned intervals go in visited, and the signed ones in signedIntervals.
+    IntervalType* visit(const ASTNode& n, NodeToInterval & visited, NodeToInterval & signedIntervals)
     {
-      map<const ASTNode, IntervalType*>::iterator it;
-      if ((it = visited.find(n)) != visited.end())
-        return it->second;
+      IntervalType** memo = visited.find(n);
+      if (memo != NULL)
+        return *memo;
 
       const int number_children = n.Degree();
       vector<IntervalType* > children;
       children.reserve(number_children);
       for (int i=0; i < number_children;i++)
         {
-          children.push_back(visit(n[i],visited,clockwise));
+          children.push_back(visit(n[i],visited,signedIntervals));
         }
 
       IntervalType * result = NULL;
@@ -407,79 +802,36 @@ namespace BEEV
     		  || (CONSTANTBV::BitVector_Lexicompare(children[0]->minV,children[1]->maxV) >0))
     		  result = createInterval(littleZero, littleZero);
       }
-        break;
-      case BVGT:
-      case BVSGT:
-      if (
-          (BVGT == n.GetKind() && knownC0 && knownC1) ||
-          (BVSGT == n.GetKind() && knownC0 && knownC1
-              && !CONSTANTBV::BitVector_bit_test(children[0]->maxV, n[0].GetValueWidth()-1)
-              && !CONSTANTBV::BitVector_bit_test(children[1]->maxV, n[0].GetValueWidth()-1)
-          ))
+        if (result == NULL && BITVECTOR_TYPE == n[0].GetType())
           {
-              if (CONSTANTBV::BitVector_Lexicompare(children[0]->minV,children[1]->maxV) >0)
-                result = createInterval(littleOne, littleOne);
-
-              if (CONSTANTBV::BitVector_Lexicompare(children[1]->minV,children[0]->maxV) >=0)
-                result = createInterval(littleZero, littleZero);
+            // Or if the signed intervals don't overlap.
+            IntervalType** s0 = signedIntervals.find(n[0]);
+            IntervalType** s1 = signedIntervals.find(n[1]);
+            if (s0 != NULL && *s0 != NULL && s1 != NULL && *s1 != NULL
+                && (compare((*s1)->minV, (*s0)->maxV, true) > 0 || compare((*s0)->minV, (*s1)->maxV, true) > 0))
+              result = createInterval(littleZero, littleZero);
           }
-      if (BVSGT == n.GetKind() && result ==NULL)
-        {
-          map<const ASTNode, IntervalType*>::iterator clock_it;
-          clock_it = clockwise.find(n[0]);
-          IntervalType* clock0 = NULL;
-          IntervalType* clock1 = NULL;
-          if (clock_it != clockwise.end())
-            clock0 = clock_it->second;
-          clock_it = clockwise.find(n[1]);
-          if (clock_it != clockwise.end())
-            clock1 = clock_it->second;
-
-          if (clock0 != NULL || clock1 !=NULL)
-            {
-              if (clock0 == NULL)
-                clock0 = children[0];
-              if (clock1 == NULL)
-                clock1 = children[1];
-
-              if (clock0 != NULL && clock1 != NULL)
-                {
-/*
-                  clock0->print();
-                  clock1->print();
-                  cerr << clock0->crossesSignedUnsigned(n[0].GetValueWidth()) << endl;
-                  cerr << clock1->crossesSignedUnsigned(n[0].GetValueWidth()) << endl;
-                  cerr << n;
-*/
-
-                  // if the rhs doesn't cross +ve/-ve boundary, and the min > max
-                  if (!clock0->crossesSignedUnsigned(n[0].GetValueWidth())  && !clock1->crossesSignedUnsigned(n[1].GetValueWidth()))
-                    {
-                      if (CONSTANTBV::BitVector_Compare(clock0->minV,clock1->maxV) >0)
-                        result = createInterval(littleOne, littleOne);
-
-                      if (CONSTANTBV::BitVector_Compare(clock1->minV,clock0->maxV) >=0)
-                        result = createInterval(littleZero, littleZero);
-                    }
-                }
-            }
-        }
-
-      break;
+        break;
+      case BVGT:
       case BVGE:
+        result = compareIntervals(children[0], children[1], BVGE == n.GetKind(), false);
+        break;
+      case BVLT:
+      case BVLE:
+        result = compareIntervals(children[1], children[0], BVLE == n.GetKind(), false);
+        break;
+      case BVSGT:
       case BVSGE:
-      if ((BVGE == n.GetKind() && knownC0 && knownC1) ||
-               (BVSGE == n.GetKind() && knownC0 && knownC1
-              && !CONSTANTBV::BitVector_bit_test(children[0]->maxV, n[0].GetValueWidth()-1)
-              && !CONSTANTBV::BitVector_bit_test(children[1]->maxV, n[0].GetValueWidth()-1)
-          ))
-        {
-          if (CONSTANTBV::BitVector_Lexicompare(children[0]->minV,children[1]->maxV) >=0)
-            result = createInterval(littleOne, littleOne);
-          if (CONSTANTBV::BitVector_Lexicompare(children[1]->minV,children[0]->maxV) > 0)
-            result = createInterval(littleZero, littleZero);
+      case BVSLT:
+      case BVSLE:
+        {
+          const bool greater = (BVSGT == n.GetKind() || BVSGE == n.GetKind());
+          const bool orEqual = (BVSGE == n.GetKind() || BVSLE == n.GetKind());
+          IntervalType** s0 = signedIntervals.find(n[greater ? 0 : 1]);
+          IntervalType** s1 = signedIntervals.find(n[greater ? 1 : 0]);
+          result = compareIntervals(s0 == NULL ? NULL : *s0, s1 == NULL ? NULL : *s1, orEqual, true);
         }
-      break;
+        break;
       case BVDIV:
       if (knownC1)
       {
@@ -547,24 +899,6 @@ namespace BEEV
         	  for (unsigned i=n[0].GetValueWidth(); i < n.GetValueWidth();i++)
         		  CONSTANTBV::BitVector_Bit_Off(result->maxV,i);
     	  }
-      } else if (knownC1)
-      {
-          // Ignores what's already there for now..
-
-          IntervalType * circ_result = freshUnsignedInterval(n.GetValueWidth());
-          for (int i=0; i < (int)n[0].GetValueWidth()-1;i++)
-          {
-              CONSTANTBV::BitVector_Bit_On(circ_result->maxV,i);
-              CONSTANTBV::BitVector_Bit_Off(circ_result->minV,i);
-          }
-
-          for (int i = (int)n[0].GetValueWidth()-1; i < (int)n.GetValueWidth();i++)
-          {
-              CONSTANTBV::BitVector_Bit_Off(circ_result->maxV,i);
-              CONSTANTBV::BitVector_Bit_On(circ_result->minV,i);
-          }
-
-          clockwise.insert(make_pair(n, circ_result));
       }
 
       break;
@@ -664,14 +998,91 @@ namespace BEEV
             result = NULL;
         }
       break;
-      //case BVLEFTSHIFT:
-      // case BVAND:
-      //case BVSRSHIFT:
-       {
-          // Todo two cases.
-          // 1) The maximum shift of the maximum value doesn't overflow, and,
-          // 2) The minimum shift of the minimum value completely overflows (to zero).
-       }
+      case BVSUB:
+      if (knownC0 && knownC1 && CONSTANTBV::BitVector_Lexicompare(children[0]->minV, children[1]->maxV) >= 0)
+        {
+          // Can't go below zero.
+          result = freshUnsignedInterval(width);
+          bool borrow = false;
+          CONSTANTBV::BitVector_sub(result->minV, children[0]->minV, children[1]->maxV, &borrow);
+          borrow = false;
+          CONSTANTBV::BitVector_sub(result->maxV, children[0]->maxV, children[1]->minV, &borrow);
+        }
+      break;
+      case BVLEFTSHIFT:
+      if (knownC0 && BVCONST == n[1].GetKind() && CONSTANTBV::Set_Max(n[1].GetBVConst()) < 32)
+        {
+          // When the maximum doesn't overflow, nothing does.
+          const unsigned shift = n[1].GetUnsignedConst();
+          const long top = CONSTANTBV::Set_Max(children[0]->maxV);
+          if (shift < width && top + shift < width)
+            {
+              result = freshUnsignedInterval(width);
+              CONSTANTBV::BitVector_Copy(result->minV, children[0]->minV);
+              CONSTANTBV::BitVector_Copy(result->maxV, children[0]->maxV);
+              for (unsigned i = 0; i < shift; i++)
+                {
+                  CONSTANTBV::BitVector_shift_left(result->minV, 0);
+                  CONSTANTBV::BitVector_shift_left(result->maxV, 0);
+                }
+            }
+        }
+      break;
+      case BVEXTRACT:
+      if (knownC0)
+        {
+          // If the ends agree above the top bit, the values between them
+          // are the ends with those bits removed.
+          const unsigned high = n[1].GetUnsignedConst();
+          const unsigned low = n[2].GetUnsignedConst();
+          const unsigned from = n[0].GetValueWidth();
+          bool same = true;
+          for (unsigned i = high + 1; i < from && same; i++)
+            same = CONSTANTBV::BitVector_bit_test(children[0]->minV, i) == CONSTANTBV::BitVector_bit_test(children[0]->maxV, i);
+          if (same)
+            {
+              result = freshUnsignedInterval(width);
+              CONSTANTBV::BitVector_Interval_Copy(result->minV, children[0]->minV, 0, low, width);
+              CONSTANTBV::BitVector_Interval_Copy(result->maxV, children[0]->maxV, 0, low, width);
+            }
+        }
+      break;
+      case BVAND:
+      case BVOR:
+        {
+          // An AND is at most its smallest operand, and an OR is at least its largest.
+          // An OR has no more significant bits than its widest operand.
+          const bool isAnd = (BVAND == n.GetKind());
+          IntervalType* extreme = NULL;
+          long top = -1;
+          bool allKnown = true;
+          for (int i = 0; i < number_children; i++)
+            {
+              if (children[i] == NULL)
+                {
+                  allKnown = false;
+                  continue;
+                }
+              if (extreme == NULL
+                  || (isAnd && CONSTANTBV::BitVector_Lexicompare(children[i]->maxV, extreme->maxV) < 0)
+                  || (!isAnd && CONSTANTBV::BitVector_Lexicompare(children[i]->minV, extreme->minV) > 0))
+                extreme = children[i];
+              top = std::max(top, CONSTANTBV::Set_Max(children[i]->maxV));
+            }
+          if (extreme != NULL && isAnd)
+            {
+              result = freshUnsignedInterval(width);
+              CONSTANTBV::BitVector_Copy(result->maxV, extreme->maxV);
+            }
+          else if (extreme != NULL)
+            {
+              result = freshUnsignedInterval(width);
+              CONSTANTBV::BitVector_Copy(result->minV, extreme->minV);
+              if (allKnown && top + 1 < (long)width)
+                CONSTANTBV::BitVector_Interval_Empty(result->maxV, top + 1, width - 1);
+            }
+        }
+      break;
 
       case BVRIGHTSHIFT:
       if (knownC0 || knownC1)
@@ -804,6 +1215,28 @@ namespace BEEV
       }
       }
 
+      if (BITVECTOR_TYPE == n.GetType())
+        {
+          // Bring in the bounds from the conjuncts, and what each domain
+          // says about the other.
+          IntervalType** bound = unsignedBounds.find(n);
+          if (bound != NULL)
+            result = intersect(result, *bound, false);
+
+          IntervalType* sresult = visitSigned(n, signedIntervals);
+          sresult = intersect(sresult, sameInBoth(result, width), true);
+          bound = signedBounds.find(n);
+          if (bound != NULL)
+            sresult = intersect(sresult, *bound, true);
+          result = intersect(result, sameInBoth(sresult, width), false);
+
+          if (sresult != NULL && isComplete(sresult, width, true))
+            sresult = NULL;
+          if (sresult != NULL)
+            assert(compare(sresult->minV, sresult->maxV, true) <= 0);
+          signedIntervals.insert(n, sresult);
+        }
+
       if (result != NULL && result->isComplete())
         result = NULL;
 
@@ -811,7 +1244,7 @@ namespace BEEV
           result->checkUnsignedInvariant();
 
       // result will often be null (which we take to mean the maximum range).
-      visited.insert(make_pair(n,result));
+      visited.insert(n,result);
       return result;
     }
 
@@ -821,7 +1254,7 @@ namespace BEEV
     NodeFactory *nf;
 
   public:
-    EstablishIntervals(STPMgr& _bm) : bm(_bm)
+    EstablishIntervals(STPMgr& _bm) : conflict(false), bm(_bm)
     {
       littleZero = makeCBV(1);
       littleOne = makeCBV(1);
@@ -831,14 +1264,10 @@ namespace BEEV
 
     ~EstablishIntervals()
     {
-      for (size_t i =0; i < toDeleteLater.size();i++)
-        delete toDeleteLater[i];
-
       for (size_t i =0; i < likeAutoPtr.size();i++)
         CONSTANTBV::BitVector_Destroy(likeAutoPtr[i]);
 
       likeAutoPtr.clear();
-      toDeleteLater.clear();
     }
   };
 }
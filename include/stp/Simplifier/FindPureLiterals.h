@@ -37,6 +37,7 @@ THE SOFTWARE.
 
 #include <map>
 #include "stp/AST/AST.h"
+#include "stp/AST/NodeSideTable.h"
 #include "stp/STPManager/STPManager.h"
 #include "stp/Simplifier/simplifier.h"
 
@@ -51,7 +52,7 @@ class FindPureLiterals //not copyable
   const static polarity_type falsePolarity = 2;
   const static polarity_type bothPolarity = 3;
 
-  map<ASTNode, polarity_type> nodeToPolarity;
+  NodeSideTable<polarity_type> nodeToPolarity;
 
   int swap(polarity_type polarity)
   {
@@ -82,11 +83,10 @@ public:
     build(n , truePolarity);
     bool changed = false;
 
-    map<ASTNode, polarity_type>::const_iterator it = nodeToPolarity.begin();
-    while (it != nodeToPolarity.end())
+    for (size_t i = 0; i < nodeToPolarity.size(); i++)
       {
-        const ASTNode& n = it->first;
-        const polarity_type polarity = it->second;
+        const ASTNode& n = nodeToPolarity.key(i);
+        const polarity_type polarity = nodeToPolarity.value(i);
         if (n.GetType() == BOOLEAN_TYPE && n.GetKind() == SYMBOL && polarity != bothPolarity)
           {
               if (polarity == truePolarity)
@@ -98,7 +98,6 @@ public:
               }
             changed = true;
           }
-        it++;
       }
     stp->GetRunTimes()->stop(RunTimes::PureLiterals);
     return changed;
@@ -110,18 +109,18 @@ public:
     if (n.isConstant())
       return;
 
-    map<ASTNode, polarity_type>::iterator it = nodeToPolarity.find(n);
-    if (it != nodeToPolarity.end())
+    polarity_type* lookup = nodeToPolarity.find(n);
+    if (lookup != NULL)
       {
-        int lookupPolarity = it->second;
+        int lookupPolarity = *lookup;
         if ((polarity | lookupPolarity) == lookupPolarity )
           return; // already traversed.
 
-        it->second |= polarity;
+        *lookup |= polarity;
       }
     else
       {
-        nodeToPolarity.insert(std::make_pair(n,polarity));
+        nodeToPolarity.insert(n,polarity);
       }
     const Kind k = n.GetKind();
     switch (k)
@@ -37,7 +37,7 @@ namespace BEEV
 {
   class MutableASTNode
   {
-    static vector<MutableASTNode*> all;
+    static thread_local vector<MutableASTNode*> all;
 
   public:
     typedef std::set<MutableASTNode *> ParentsType;
@@ -0,0 +1,106 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef NARROWWIDTHS_H
+#define NARROWWIDTHS_H
+
+#include "stp/AST/AST.h"
+#include "stp/AST/NodeSideTable.h"
+
+namespace simplifier
+{
+  namespace constantBitP
+  {
+    class NodeToFixedBitsMap;
+  }
+}
+
+namespace BEEV
+{
+  class STPMgr;
+
+  /******************************************************************
+   * Class NarrowWidths:                                            *
+   *                                                                *
+   * Does multiplications, divisions, additions and comparisons at  *
+   * the width their operands need, rather than at the width they   *
+   * are written at. For instance, a 64-bit product of two values   *
+   * that fit in 16 bits is a 32-bit product, zero extended. The    *
+   * cost of bit-blasting a multiplier or divider is quadratic in   *
+   * its width, so this can shrink the CNF a lot.                   *
+   *                                                                *
+   * How many of the top bits of a term are zeroes, or copies of    *
+   * the sign bit, is worked out from the operations that make the  *
+   * term: concatenations with zero, extractions, extensions and    *
+   * so on. The bits that constant bit propagation fixed, when it's *
+   * been run, add what the formula says about the top bits of the  *
+   * variables. Those facts only hold when the formula does, so     *
+   * they're conjoined to it.                                       *
+   ******************************************************************/
+  class NarrowWidths //not copyable
+  {
+  public:
+    NarrowWidths(STPMgr& bm);
+
+    // "fixed" holds the bits that constant bit propagation found when
+    // "top", or a formula it was simplified from, is true. It may be NULL.
+    ASTNode topLevel(const ASTNode& top, const simplifier::constantBitP::NodeToFixedBitsMap* fixed);
+
+    // The number of operations made narrower by the last topLevel().
+    size_t numberNarrowed() const
+    {
+      return narrowed;
+    }
+
+  private:
+    NarrowWidths(const NarrowWidths&);
+    NarrowWidths& operator=(const NarrowWidths&);
+
+    // The bits of a term from "zeroFrom" up are zero, and the bits
+    // from "signFrom"-1 up are all the same. Both are at most the
+    // width of the term.
+    struct Widths
+    {
+      unsigned zeroFrom;
+      unsigned signFrom;
+    };
+
+    STPMgr& bm;
+    NodeFactory* nf;
+
+    NodeSideTable<Widths> widths;
+    NodeSideTable<ASTNode> cache;
+    ASTVec assumed;
+    size_t narrowed;
+
+    Widths visit(const ASTNode& n, const simplifier::constantBitP::NodeToFixedBitsMap* fixed);
+    ASTNode rewrite(const ASTNode& n);
+
+    ASTNode extract(const ASTNode& n, unsigned width);
+    ASTNode zeroExtend(const ASTNode& n, unsigned width);
+    ASTNode signExtend(const ASTNode& n, unsigned width);
+  };
+} // end namespace BEEV
+#endif
@@ -63,6 +63,9 @@ namespace BEEV
 
     NodeFactory* nf;
 
+    // The simplifier that replace() records substitutions in.
+    Simplifier* simp;
+
   public:
 
     RemoveUnconstrained(STPMgr& bm);
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "stp/AST/AST.h"
 #include "stp/STPManager/STPManager.h"
+#include "stp/AST/NodeSideTable.h"
 #include "stp/AST/NodeFactory/SimplifyingNodeFactory.h"
 #include "stp/Simplifier/VariablesInExpression.h"
 
@@ -65,6 +66,71 @@ namespace BEEV
     loops(const ASTNode& n0, const ASTNode& n1);
 
     size_t substitutionsLastApplied;
+
+    // The keys, in the order they were added.
+    ASTVec keysAdded;
+
+    // Union-find over the symbols that have been found equal to each
+    // other. Each symbol in a class, other than the representative, is
+    // in the map as the representative, or as its parent, which is
+    // mapped in turn. So a chain like x1=x2, x2=x3, ... doesn't give
+    // a long chain of lookups, or long loop checks.
+    struct SymbolClass
+    {
+      ASTNode parent; // Null for a representative.
+      unsigned rank;
+
+      SymbolClass() :
+        rank(0)
+      {
+      }
+    };
+    NodeSideTable<SymbolClass> classes;
+    bool classesCompressed;
+
+    // What applySubstitutionMap() gave for each node, and in which
+    // round. A round starts when it's called after keys were added.
+    // As the map only grows (until it's cleared), a result stays right
+    // unless one of the keys added since is in a node that was looked
+    // up to get it. The result isn't enough, as a key that isn't a
+    // symbol can take away a symbol that was looked up on the way:
+    // with x = y and extract(y) = 5, extract(x) gives 5, which must
+    // change if y gets a value. That's checked with a 64 bit signature
+    // of the symbols below each node, so the results are kept between
+    // calls, and only the parts of the DAG that new keys might be in
+    // are rebuilt.
+    struct Applied
+    {
+      ASTNode result;
+      size_t round;
+      uint64_t used; // The signature of the nodes that were looked up.
+    };
+    NodeSideTable<Applied> applied;
+    NodeSideTable<uint64_t> signatures;
+    std::vector<size_t> roundKeys; // How many keys there were.
+    std::vector<uint64_t> roundAdded; // The signature of the keys added since.
+
+    uint64_t
+    signature(const ASTNode& n);
+    void
+    startRound();
+    ASTNode
+    applyMemoised(const ASTNode& n, uint64_t& used);
+
+    ASTNode
+    findRepresentative(const ASTNode& symbol);
+    bool
+    unionSymbols(const ASTNode& e0, const ASTNode& e1);
+    void
+    compressClasses();
+
+    void
+    add(const ASTNode& key, const ASTNode& value)
+    {
+      (*SolverMap)[key] = value;
+      keysAdded.push_back(key);
+    }
+
   public:
 
     bool
@@ -99,6 +165,7 @@ namespace BEEV
       SolverMap = new ASTNodeMap(INITIAL_TABLE_SIZE);
       loopCount = 0;
       substitutionsLastApplied = 0;
+      classesCompressed = true;
       nf = bm->defaultNodeFactory;
     }
 
@@ -106,9 +173,32 @@ namespace BEEV
     clear()
     {
       SolverMap->clear();
+      keysAdded.clear();
+      classes.clear();
+      classesCompressed = true;
+      clearCache();
       haveAppliedSubstitutionMap();
     }
 
+    // Forgets the results of earlier applySubstitutionMap() calls.
+    void
+    clearCache()
+    {
+      applied.clear();
+      signatures.clear();
+      roundKeys.clear();
+      roundAdded.clear();
+    }
+
+    // Everything that has been substituted for since the map was last
+    // cleared, in order. So keysAdded()[i], for i from some earlier
+    // size(), are the new ones.
+    const ASTVec&
+    getKeysAdded() const
+    {
+      return keysAdded;
+    }
+
     virtual
     ~SubstitutionMap();
 
@@ -139,7 +229,7 @@ namespace BEEV
         {
         //cerr << "from" << key << "to" <<value;
         buildDepends(key, value);
-        (*SolverMap)[key] = value;
+        add(key, value);
         return true;
         }
       return false;
@@ -169,7 +259,7 @@ namespace BEEV
     {
       assert(e0.GetKind() == SYMBOL);
       assert(!CheckSubstitutionMap(e0));
-      (*SolverMap)[e0] = e1;
+      add(e0, e1);
       return true;
     }
 
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #define UseITEContext_H_
 
 #include "stp/AST/AST.h"
+#include "stp/AST/NodeSideTable.h"
 #include "stp/STPManager/STPManager.h"
 
 namespace BEEV
@@ -67,7 +68,7 @@ namespace BEEV
     // So we limit how often each node is visited.
 
     ASTNode
-    visit(const ASTNode &n, map<ASTNode,int>& visited, ASTNodeSet& visited_empty, ASTNodeSet& context)
+    visit(const ASTNode &n, NodeSideTable<int>& visited, ASTNodeSet& visited_empty, ASTNodeSet& context)
     {
       if (n.isConstant())
         return n;
@@ -131,7 +132,7 @@ namespace BEEV
     topLevel(const ASTNode& n)
     {
       runtimes->start(RunTimes::UseITEContext);
-      map<ASTNode,int> visited;
+      NodeSideTable<int> visited;
       ASTNodeSet context;
       ASTNodeSet empty;
       ASTNode result= visit(n,visited,empty,context);
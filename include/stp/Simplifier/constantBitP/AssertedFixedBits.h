@@ -0,0 +1,126 @@
+// -*- c++ -*-
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#ifndef ASSERTEDFIXEDBITS_H_
+#define ASSERTEDFIXEDBITS_H_
+
+#include <vector>
+#include "stp/AST/AST.h"
+#include "stp/Simplifier/constantBitP/NodeToFixedBitsMap.h"
+
+namespace BEEV
+{
+  class Simplifier;
+}
+
+namespace simplifier
+{
+  namespace constantBitP
+  {
+    /******************************************************************
+     * Class AssertedFixedBits:                                       *
+     *                                                                *
+     * The fixed bits that hold whenever the assertions do, kept from *
+     * one query to the next. update() is called at each query, and   *
+     * only propagates through the assertions that have been added    *
+     * since it was last called. push() takes a checkpoint, and pop() *
+     * goes back to it, undoing the fixings that were made since from *
+     * a trail. Each context's assertions are propagated on their own *
+     * and before the next context's, so a pop only undoes what was   *
+     * found from the popped context.                                 *
+     *                                                                *
+     * The fixings are consequences of the assertions, so they hold   *
+     * in every model of a query against them. Propagation only uses  *
+     * them once the top is set to true, so they're conjoined with    *
+     * the formula, never substituted into it.                        *
+     ******************************************************************/
+    class AssertedFixedBits //not copyable
+    {
+      AssertedFixedBits(const AssertedFixedBits&);
+      AssertedFixedBits& operator=(const AssertedFixedBits&);
+
+      struct Checkpoint
+      {
+        size_t trail;
+        size_t propagated;
+        bool unsatisfiable;
+
+        // The number of assertions when it was taken.
+        size_t asserted;
+      };
+
+      NodeToFixedBitsMap fixings;
+
+      // What each changed node was fixed to before, NULL if it wasn't there.
+      std::vector<std::pair<BEEV::ASTNode, FixedBits*> > trail;
+      std::vector<Checkpoint> checkpoints;
+
+      // The assertions that the fixings were found from.
+      BEEV::ASTVec propagated;
+
+      // Propagation found the assertions to be contradictory.
+      bool unsatisfiable;
+
+      // Propagates through the assertions up to "to". If "undoable", the
+      // fixings that are changed go on the trail.
+      void
+      propagate(const BEEV::ASTVec& asserts, size_t to, bool undoable, BEEV::Simplifier* simp,
+                NodeFactory* nf);
+
+      void
+      restore(const Checkpoint& c);
+
+      void
+      reset();
+
+    public:
+      AssertedFixedBits();
+      ~AssertedFixedBits();
+
+      // Brings the fixings up to date with the assertions. If the ones seen
+      // before aren't at the start, it starts over.
+      void
+      update(const BEEV::ASTVec& asserts, BEEV::Simplifier* simp, NodeFactory* nf);
+
+      // "asserted" is the number of assertions so far.
+      void
+      push(size_t asserted);
+
+      void
+      pop();
+
+      // NULL if there's nothing to use.
+      const NodeToFixedBitsMap*
+      get() const
+      {
+        if (unsatisfiable || fixings.map->empty())
+          return NULL;
+        return &fixings;
+      }
+    };
+  }
+}
+
+#endif /* ASSERTEDFIXEDBITS_H_ */
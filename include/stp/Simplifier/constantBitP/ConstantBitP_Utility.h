@@ -41,6 +41,8 @@ using std::endl;
 using std::pair;
 
 Result makeEqual(FixedBits& a, FixedBits& b, unsigned from, unsigned to);
+Result makeEqual(FixedBits& a, unsigned aFrom, FixedBits& b, unsigned bFrom, unsigned length);
+Result fixRangeTo(FixedBits& a, unsigned from, unsigned to, bool value);
 void setSignedMinMax(FixedBits& v, BEEV::CBV min, BEEV::CBV max);
 void setUnsignedMinMax(const FixedBits& v, BEEV::CBV min, BEEV::CBV max);
 unsigned cbvTOInt(const BEEV::CBV v);
@@ -66,6 +66,13 @@ namespace simplifier
 
       bool topFixed;
 
+      // Print the worklist's statistics when it's deleted.
+      bool printStats;
+
+      // Fixings that hold whenever the assertions do. They're only added once
+      // the top is set to true, so they're conjoined rather than substituted.
+      const NodeToFixedBitsMap* asserted;
+
       // A vector that's reused.
       std::vector< unsigned > previousChildrenFixedCount;
 
@@ -81,6 +88,13 @@ namespace simplifier
       void
       scheduleDown(const ASTNode& n);
 
+      void
+      addAsserted();
+
+      // False if "from" clashes with what's known about "n".
+      bool
+      addAsserted(const ASTNode& n, const FixedBits& from);
+
 public:
       NodeToFixedBitsMap* fixedMap;
       MultiplicationStatsMap* msm;
@@ -91,7 +105,13 @@ public:
       }
 
       // propagates.
-      ConstantBitPropagation(BEEV::Simplifier* _sm, NodeFactory* _nf, const ASTNode & top);
+      ConstantBitPropagation(BEEV::Simplifier* _sm, NodeFactory* _nf, const ASTNode & top,
+                             const NodeToFixedBitsMap* _asserted = NULL);
+
+      // Sets the top to true, then propagates from the "start" nodes only. The
+      // fixings in "_asserted" must already be at a fixed point.
+      ConstantBitPropagation(BEEV::Simplifier* _sm, NodeFactory* _nf, const ASTNode & top,
+                             const NodeToFixedBitsMap* _asserted, const ASTVec& start);
 
       ~ConstantBitPropagation()
       {
@@ -110,6 +130,8 @@ public:
         fixedMap = NULL;
         delete dependents;
         dependents = NULL;
+        if (printStats && workList != NULL)
+          workList->printStats();
         delete workList;
         workList = NULL;
         delete msm;
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #define DEPENDENCIES_H_
 
 #include "stp/AST/AST.h"
+#include "stp/AST/NodeSideTable.h"
 namespace simplifier
 {
   namespace constantBitP
@@ -41,100 +42,190 @@ namespace simplifier
     class Dependencies
     {
     private:
+      /* The parents are stored in compressed sparse row form. Each non-constant
+       * node has a row, and the node in row r is rows.key(r). The parents of row
+       * r are the rows in parents[start[r]] .. parents[start[r] + count[r] - 1].
+       * The rows made by build() are laid out together; a row added later by
+       * replaceFresh() has its parents appended to the end of the array (the
+       * overflow). Removing a parent swaps it with the row's last parent.
+       */
+      NodeSideTable<unsigned> rows;
+      vector<unsigned> start;
+      vector<unsigned> count;
+      vector<unsigned> parents;
+
+      enum
+      {
+        NONE = ~0u
+      };
 
-      typedef hash_map<BEEV::ASTNode, set<BEEV::ASTNode>*, BEEV::ASTNode::ASTNodeHasher, BEEV::ASTNode::ASTNodeEqual>
-          NodeToDependentNodeMap;
-      NodeToDependentNodeMap dependents;
-
-      const set<ASTNode> empty;
+      unsigned
+      rowOf(const ASTNode& n) const
+      {
+        if (n.isConstant()) // don't care about what depends on constants.
+          return NONE;
+        const unsigned* r = rows.find(n);
+        return (r == NULL) ? NONE : *r;
+      }
 
-    public:
-      // All the nodes that depend on the value of a particular node.
-      void
-      build(const ASTNode & current, const ASTNode & prior)
+      // Gives rows to the node and its descendants, and records each (child, parent) pair once.
+      unsigned
+      build(const ASTNode & current, vector<std::pair<unsigned, unsigned> >& edges, vector<unsigned>& lastParent)
       {
-        if (current.isConstant()) // don't care about what depends on constants.
-          return;
+        if (current.isConstant())
+          return NONE;
 
-        set<ASTNode> * vec;
-        const NodeToDependentNodeMap::iterator it = dependents.find(current);
-        if (dependents.end() == it)
-          {
-            // add it in with a reference to the vector.
-            vec = new set<ASTNode> ();
+        const unsigned* found = rows.find(current);
+        if (found != NULL)
+          return *found;
 
-            dependents.insert(std::pair<ASTNode, set<ASTNode>*>(current, vec));
-          }
-        else
-          {
-            vec = it->second;
-          }
+        const unsigned row = start.size();
+        rows.insert(current, row);
+        start.push_back(0);
+        count.push_back(0);
+        lastParent.push_back(NONE);
 
-        if (prior != current) // initially called with both the same.
-          {
-            if (vec->count(prior) == 0)
-              vec->insert(prior);
-            else
-              return; // already been added in.
-          }
+        const ASTVec& children = current.GetChildren();
+        for (unsigned i = 0; i < children.size(); i++)
+          build(children[i], edges, lastParent);
 
-        for (unsigned int i = 0; i < current.GetChildren().size(); i++)
+        // A child can appear more than once, but is only given the parent once.
+        for (unsigned i = 0; i < children.size(); i++)
           {
-            build(current.GetChildren()[i], current);
+            const unsigned child = rowOf(children[i]);
+            if (child == NONE || lastParent[child] == row)
+              continue;
+            lastParent[child] = row;
+            count[child]++;
+            edges.push_back(std::make_pair(child, row));
           }
+        return row;
+      }
+
+      void
+      removeParent(unsigned row, unsigned parent)
+      {
+        unsigned* first = &parents[start[row]];
+        for (unsigned i = 0; i < count[row]; i++)
+          if (first[i] == parent)
+            {
+              first[i] = first[count[row] - 1];
+              count[row]--;
+              return;
+            }
       }
 
       Dependencies(const Dependencies&); // Shouldn't needed to copy or assign.
       Dependencies& operator=(const Dependencies&);
 
     public:
-      Dependencies(const ASTNode &top)
+      // The nodes that read the value of a node.
+      class Range
       {
-        build(top, top);
-        checkInvariant();
-      }
+        const Dependencies* d;
+        const unsigned* first;
+        unsigned length;
+
+      public:
+        Range(const Dependencies* _d, const unsigned* _first, unsigned _length) :
+            d(_d), first(_first), length(_length)
+        {
+        }
+
+        unsigned
+        size() const
+        {
+          return length;
+        }
+
+        const ASTNode&
+        operator[](unsigned i) const
+        {
+          assert(i < length);
+          return d->rows.key(first[i]);
+        }
+      };
 
-      ~Dependencies()
+      Dependencies(const ASTNode &top)
       {
-        NodeToDependentNodeMap::iterator it = dependents.begin();
-        for (/**/; it != dependents.end(); it++)
+        // One pass over the DAG to find the edges, then a counting sort puts
+        // each child's parents together.
+        vector<std::pair<unsigned, unsigned> > edges;
+        vector<unsigned> cursor;
+        build(top, edges, cursor);
+
+        unsigned total = 0;
+        for (unsigned r = 0; r < start.size(); r++)
           {
-            //set<BEEV::ASTNode>*
-            delete it->second;
+            start[r] = total;
+            cursor[r] = total;
+            total += count[r];
           }
+
+        parents.resize(total);
+        for (size_t i = 0; i < edges.size(); i++)
+          parents[cursor[edges[i].first]++] = edges[i].second;
+
+        checkInvariant();
       }
 
-      void replaceFresh(const ASTNode& old, const ASTNode& newN, set<ASTNode> *newNDepends,
+      // The fresh node "newN", read by the "newNDepends" nodes, stands in for "old".
+      void replaceFresh(const ASTNode& old, const ASTNode& newN, const ASTVec& newNDepends,
                         ASTVec& variables)
       {
-        NodeToDependentNodeMap::const_iterator it = dependents.find(old);
-        if (it == dependents.end())
+        if (rowOf(old) == NONE)
           return;
 
-        it->second->erase(old);
-        dependents.insert(make_pair(newN,newNDepends));
+        unsigned row = rowOf(newN);
+        if (row == NONE)
+          {
+            row = start.size();
+            rows.insert(newN, row);
+            start.push_back(0);
+            count.push_back(0);
+          }
+
+        // Its parents go in the overflow at the end.
+        const unsigned previous = count[row];
+        const unsigned at = parents.size();
+        parents.resize(at + previous);
+        for (unsigned i = 0; i < previous; i++)
+          parents[at + i] = parents[start[row] + i];
+        start[row] = at;
+
+        for (unsigned i = 0; i < newNDepends.size(); i++)
+          {
+            const unsigned p = rowOf(newNDepends[i]);
+            assert(p != NONE);
+            parents.push_back(p);
+            count[row]++;
+          }
         variables.push_back(newN);
       }
 
       // The "toRemove" node is being removed. Used by unconstrained elimination.
       void removeNode(const ASTNode& toRemove, ASTVec& variables)
       {
+        const unsigned removed = rowOf(toRemove);
+        if (removed == NONE)
+          return;
+
         for (unsigned i = 0; i < toRemove.GetChildren().size(); i++)
           {
             const ASTNode child = toRemove.GetChildren()[i];
 
-            NodeToDependentNodeMap::const_iterator it = dependents.find(child);
-            if (it == dependents.end())
+            const unsigned row = rowOf(child);
+            if (row == NONE)
               continue;
 
-            it->second->erase(toRemove);
-            if (it->second->size() == 0)
+            removeParent(row, removed);
+            if (count[row] == 0)
               {
                 removeNode(child,variables);
                 continue;
               }
 
-            if (child.GetKind() == SYMBOL && it->second->size() ==1)
+            if (child.GetKind() == SYMBOL && count[row] ==1)
               {
                 variables.push_back(child);
               }
@@ -144,19 +235,13 @@ namespace simplifier
       void
       print() const
       {
-        NodeToDependentNodeMap::const_iterator it = dependents.begin();
-        for (/**/; it != dependents.end(); it++)
+        for (unsigned r = 0; r < start.size(); r++)
           {
-            cout << (it->first).GetNodeNum();
-
-            const set<ASTNode>* dep = it->second;
+            cout << rows.key(r).GetNodeNum();
 
-            set<ASTNode>::iterator it = dep->begin();
-            while (it != dep->end())
-              {
-                cout << " " << (*it).GetNodeNum();
-                it++;
-              }
+            const Range dep = getDependents(rows.key(r));
+            for (unsigned i = 0; i < dep.size(); i++)
+              cout << " " << dep[i].GetNodeNum();
             cout << endl;
           }
       }
@@ -164,19 +249,37 @@ namespace simplifier
       void
       checkInvariant() const
       {
-        // only one node with a single dependent.
+        assert(start.size() == count.size());
+        assert(start.size() == rows.size());
+      }
+
+      // The number of non-constant nodes, which are node(0) .. node(size() - 1).
+      unsigned
+      size() const
+      {
+        return start.size();
+      }
+
+      const ASTNode&
+      node(unsigned i) const
+      {
+        return rows.key(i);
       }
 
-      const set<ASTNode>*
+      bool
+      contains(const ASTNode& n) const
+      {
+        return rowOf(n) != NONE;
+      }
+
+      Range
       getDependents(const ASTNode n) const
       {
-        if (n.isConstant())
-          return &empty;
-        const NodeToDependentNodeMap::const_iterator it = dependents.find(n);
-        if (it == dependents.end())
-          return &empty;
+        const unsigned row = rowOf(n);
+        if (row == NONE || count[row] == 0)
+          return Range(this, NULL, 0);
 
-        return it->second;
+        return Range(this, &parents[start[row]], count[row]);
       }
 
       // The higher node depends on the lower node.
@@ -184,8 +287,11 @@ namespace simplifier
       bool
       nodeDependsOn(const ASTNode& higher, const ASTNode& lower) const
       {
-        const set<ASTNode> *s = getDependents(lower);
-        return s->count(higher) > 0;
+        const Range s = getDependents(lower);
+        for (unsigned i = 0; i < s.size(); i++)
+          if (s[i] == higher)
+            return true;
+        return false;
       }
 
       bool isUnconstrained(const ASTNode& n)
@@ -193,23 +299,10 @@ namespace simplifier
         if (n.GetKind() != SYMBOL)
           return false;
 
-        NodeToDependentNodeMap::const_iterator it = dependents.find(n);
-        assert(it != dependents.end());
-        return it->second->size() ==1;
+        const unsigned row = rowOf(n);
+        assert(row != NONE);
+        return count[row] ==1;
       }
-
-#if 0
-      void
-      getAllVariables(ASTVec& v)
-      {
-        for (NodeToDependentNodeMap::const_iterator it = dependents.begin(); it != dependents. end(); it++)
-          {
-            if (it->first.GetKind() == SYMBOL)
-              v.push_back(it->first);
-          }
-      }
-#endif
-
     };
 
   }
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <stdint.h>
+#include <algorithm>
 
 class MTRand;
 
@@ -49,26 +51,43 @@ namespace simplifier
 #define CONSTANTBITP_UTILITY_XSTR(s) CONSTANTBITP_UTILITY_STR(s)
 #define LOCATION __FILE__ ":"  CONSTANTBITP_UTILITY_XSTR(__LINE__) ": "
 
-    static int staticUniqueId = 1;
+    static thread_local int staticUniqueId = 1;
 
     // Bits can be fixed, or unfixed. Fixed bits are fixed to either zero or one.
     class FixedBits
     {
+    public:
+      // The bits are packed into words, so the transfer functions can
+      // work on 64 of them at once. Bit i is bit (i % 64) of word (i / 64).
+      typedef uint64_t Word;
+      static const unsigned bitsPerWord = 64;
+
     private:
-      bool* fixed;
-      bool* values;
+      // Which bits are fixed, and what they're fixed to. Bits past the
+      // width are always zero in both. The value of an unfixed bit is
+      // meaningless.
+      Word* fixed;
+      Word* values;
       unsigned width;
       bool representsBoolean;
 
+      // Most are narrow, so a single word of each is kept here rather
+      // than on the heap.
+      Word local[2];
+
       void
-      init(const FixedBits& copy);
-      int uniqueId;
+      allocate();
 
-      bool
-      unsignedHolds_new(unsigned val);
-      bool
-      unsignedHolds_old(unsigned val);
+      void
+      release()
+      {
+        if (fixed != local)
+          delete[] fixed;
+      }
 
+      void
+      init(const FixedBits& copy);
+      int uniqueId;
 
     public:
       FixedBits(unsigned n, bool isBoolean);
@@ -88,8 +107,7 @@ namespace simplifier
 
       ~FixedBits()
       {
-        delete[] fixed;
-        delete[] values;
+        release();
       }
 
       bool
@@ -123,12 +141,142 @@ namespace simplifier
         if (this == &copy)
           return *this;
 
-        delete[] fixed;
-        delete[] values;
+        release();
         init(copy);
         return *this;
       }
 
+      static unsigned
+      popcount(Word w)
+      {
+#ifdef __GNUC__
+        return __builtin_popcountll(w);
+#else
+        unsigned result = 0;
+        for (; w != 0; w &= w - 1)
+          result++;
+        return result;
+#endif
+      }
+
+      // Position of the lowest one. w mustn't be zero.
+      static unsigned
+      lowestOne(Word w)
+      {
+        assert(w != 0);
+#ifdef __GNUC__
+        return __builtin_ctzll(w);
+#else
+        unsigned result = 0;
+        for (; (w & 1) == 0; w >>= 1)
+          result++;
+        return result;
+#endif
+      }
+
+      // Position of the highest one. w mustn't be zero.
+      static unsigned
+      highestOne(Word w)
+      {
+        assert(w != 0);
+#ifdef __GNUC__
+        return bitsPerWord - 1 - __builtin_clzll(w);
+#else
+        unsigned result = 0;
+        for (; w > 1; w >>= 1)
+          result++;
+        return result;
+#endif
+      }
+
+      // The lowest n bits.
+      static Word
+      lowBits(unsigned n)
+      {
+        assert(n <= bitsPerWord);
+        return n == bitsPerWord ? ~(Word) 0 : (((Word) 1 << n) - 1);
+      }
+
+      unsigned
+      numberOfWords() const
+      {
+        return (width + bitsPerWord - 1) / bitsPerWord;
+      }
+
+      // The bits of word w that are inside the width.
+      Word
+      widthMask(unsigned w) const
+      {
+        assert(w < numberOfWords());
+        if (w + 1 < numberOfWords())
+          return ~(Word) 0;
+        return lowBits(width - w * bitsPerWord);
+      }
+
+      Word
+      getFixedWord(unsigned w) const
+      {
+        assert(w < numberOfWords());
+        return fixed[w];
+      }
+
+      // Only the bits that are fixed are meaningful.
+      Word
+      getValueWord(unsigned w) const
+      {
+        assert(w < numberOfWords());
+        return values[w];
+      }
+
+      // Fixes the bits of word w that are in mask to the values in v.
+      void
+      fixWord(unsigned w, Word mask, Word v)
+      {
+        assert(w < numberOfWords());
+        mask &= widthMask(w);
+        fixed[w] |= mask;
+        values[w] = (values[w] & ~mask) | (v & mask);
+      }
+
+      void
+      unfixWord(unsigned w, Word mask)
+      {
+        assert(w < numberOfWords());
+        fixed[w] &= ~mask;
+      }
+
+      // The bitsPerWord bits from bit "from" up, zero past the width.
+      Word
+      getFixedAt(unsigned from) const
+      {
+        return getAt(fixed, from);
+      }
+
+      Word
+      getValueAt(unsigned from) const
+      {
+        return getAt(values, from);
+      }
+
+      // Fixes the bits from bit "from" up that are in mask to the values in v.
+      void
+      fixAt(unsigned from, Word mask, Word v);
+
+    private:
+      Word
+      getAt(const Word* words, unsigned from) const
+      {
+        const unsigned w = from / bitsPerWord;
+        const unsigned offset = from % bitsPerWord;
+        if (w >= numberOfWords())
+          return 0;
+        Word result = words[w] >> offset;
+        if (offset != 0 && w + 1 < numberOfWords())
+          result |= words[w + 1] << (bitsPerWord - offset);
+        return result;
+      }
+
+    public:
       //All values are fixed to false.
       void
       fixToZero();
@@ -145,14 +293,7 @@ namespace simplifier
       {
         assert(isTotallyFixed());
         assert(getWidth() <= 32);
-        unsigned result = 0;
-
-        for (unsigned i = 0; i < width; i++) {
-          if (getValue(i))
-            result += (1 << i);
-        }
-
-        return result;
+        return (unsigned) values[0];
       }
 
       // True if all bits are fixed (irrespective of what value they are fixed to).
@@ -164,103 +305,93 @@ namespace simplifier
       setValue(unsigned n, bool value)
       {
         assert(((char)value) == 0 || (char)value ==1 );
-        assert(n < width && fixed[n]);
-        values[n] = value;
+        assert(n < width && isFixed(n));
+        const Word bit = (Word) 1 << (n % bitsPerWord);
+        if (value)
+          values[n / bitsPerWord] |= bit;
+        else
+          values[n / bitsPerWord] &= ~bit;
       }
 
       bool
       getValue(unsigned n) const
       {
-        assert(n < width && fixed[n]);
-        return values[n];
+        assert(n < width && isFixed(n));
+        return (values[n / bitsPerWord] >> (n % bitsPerWord)) & 1;
       }
 
       //returns -1 if it's zero.
       int
       topmostPossibleLeadingOne()
       {
-        int i;
-        for (i = (int)getWidth() - 1; i >= 0; i--)
+        for (int w = (int)numberOfWords() - 1; w >= 0; w--)
           {
-            if (!isFixed(i) || getValue(i))
-              break;
+            const Word possibleOne = (~fixed[w] | values[w]) & widthMask(w);
+            if (possibleOne != 0)
+              return w * bitsPerWord + highestOne(possibleOne);
           }
-        return i;
+        return -1;
       }
 
       unsigned
       minimum_trailingOne()
       {
-        unsigned i = 0;
-        for (; i < getWidth(); i++)
-          {
-            if (!isFixed(i) || getValue(i))
-              break;
-          }
-        return i;
+        return minimum_numberOfTrailingZeroes();
       }
 
       unsigned
       maximum_trailingOne()
       {
-        unsigned i = 0;
-        for (; i < getWidth(); i++)
-          {
-            if (isFixed(i) && getValue(i))
-              break;
-          }
-        return i;
+        return maximum_numberOfTrailingZeroes();
       }
 
-
-
       unsigned
       minimum_numberOfTrailingZeroes()
       {
-        unsigned i = 0;
-        for (; i < getWidth(); i++)
+        for (unsigned w = 0; w < numberOfWords(); w++)
           {
-            if (!isFixed(i) || getValue(i))
-              break;
+            const Word possibleOne = (~fixed[w] | values[w]) & widthMask(w);
+            if (possibleOne != 0)
+              return w * bitsPerWord + lowestOne(possibleOne);
           }
-        return i;
+        return width;
       }
 
       unsigned
       maximum_numberOfTrailingZeroes()
       {
-        unsigned i = 0;
-        for (; i < getWidth(); i++)
+        for (unsigned w = 0; w < numberOfWords(); w++)
           {
-            if (isFixed(i) && getValue(i))
-              break;
+            const Word one = fixed[w] & values[w];
+            if (one != 0)
+              return w * bitsPerWord + lowestOne(one);
           }
-        return i;
+        return width;
       }
 
       //Returns the position of the first non-fixed value.
       unsigned
       leastUnfixed() const
       {
-        unsigned i = 0;
-        for (; i < getWidth(); i++)
+        for (unsigned w = 0; w < numberOfWords(); w++)
           {
-            if (!isFixed(i))
-              break;
+            const Word unfixed = ~fixed[w] & widthMask(w);
+            if (unfixed != 0)
+              return w * bitsPerWord + lowestOne(unfixed);
           }
-        return i;
+        return width;
       }
 
       int
       mostUnfixed() const
       {
-        int i = (int)getWidth()-1;
-        for (; i >=0; i--)
+        for (int w = (int)numberOfWords() - 1; w >= 0; w--)
           {
-            if (!isFixed(i))
-              break;
+            const Word unfixed = ~fixed[w] & widthMask(w);
+            if (unfixed != 0)
+              return w * bitsPerWord + highestOne(unfixed);
           }
-        return i;
+        return -1;
       }
 
       // is this bit fixed to zero?
@@ -282,7 +413,7 @@ namespace simplifier
       isFixed(unsigned n) const
       {
         assert(n <width);
-        return fixed[n];
+        return (fixed[n / bitsPerWord] >> (n % bitsPerWord)) & 1;
       }
 
       // set bit n to either fixed or unfixed.
@@ -290,7 +421,11 @@ namespace simplifier
       setFixed(unsigned n, bool value)
       {
         assert(n <width);
-        fixed[n] = value;
+        const Word bit = (Word) 1 << (n % bitsPerWord);
+        if (value)
+          fixed[n / bitsPerWord] |= bit;
+        else
+          fixed[n / bitsPerWord] &= ~bit;
       }
 
 
@@ -303,17 +438,11 @@ namespace simplifier
       {
         assert(getWidth() >= a.getWidth());
 
-        for (unsigned i = 0; i < a.getWidth(); i++)
+        for (unsigned w = 0; w < a.numberOfWords(); w++)
           {
-            if (a.isFixed(i))
-              {
-                setFixed(i, true);
-                setValue(i, a.getValue(i));
-              }
-            else
-              {
-                setFixed(i, false);
-              }
+            const Word mask = a.widthMask(w);
+            fixed[w] = (fixed[w] & ~mask) | a.fixed[w];
+            values[w] = (values[w] & ~a.fixed[w]) | (a.values[w] & a.fixed[w]);
           }
       }
 
@@ -321,15 +450,12 @@ namespace simplifier
       void
       copyIn(const FixedBits& a)
       {
-        unsigned to = std::min(getWidth(), a.getWidth());
-        for (unsigned i = 0; i < to; i++)
+        const unsigned to = std::min(getWidth(), a.getWidth());
+        for (unsigned w = 0; w * bitsPerWord < to; w++)
           {
-            assert(!isFixed(i));
-            if (a.isFixed(i))
-              {
-                setFixed(i, true);
-                setValue(i, a.getValue(i));
-              }
+            const Word mask = a.fixed[w] & lowBits(std::min(to - w * bitsPerWord, bitsPerWord));
+            assert((fixed[w] & lowBits(std::min(to - w * bitsPerWord, bitsPerWord))) == 0);
+            fixWord(w, mask, a.values[w]);
           }
       }
 
@@ -337,10 +463,9 @@ namespace simplifier
       bool
       containsZero() const
       {
-        for (unsigned i = 0; i < getWidth(); i++) {
-          if (isFixed(i) && getValue(i))
+        for (unsigned w = 0; w < numberOfWords(); w++)
+          if ((fixed[w] & values[w]) != 0)
             return false;
-        }
 
         return true;
       }
@@ -349,10 +474,8 @@ namespace simplifier
       countFixed() const
       {
         unsigned result = 0;
-        for (unsigned i = 0; i < width; i++) {
-          if (isFixed(i))
-            result++;
-        }
+        for (unsigned w = 0; w < numberOfWords(); w++)
+          result += popcount(fixed[w]);
 
         return result;
       }
@@ -372,14 +495,8 @@ namespace simplifier
       mergeIn(const FixedBits& a)
       {
         assert(a.getWidth() == getWidth());
-        for (unsigned i= 0; i < width;i++)
-          {
-          if (a.isFixed(i) && !isFixed(i))
-            {
-            setFixed(i,true);
-            setValue(i,a.getValue(i));
-            }
-          }
+        for (unsigned w = 0; w < numberOfWords(); w++)
+          fixWord(w, a.fixed[w] & ~fixed[w], a.values[w]);
       }
 
 
@@ -26,6 +26,8 @@ THE SOFTWARE.
 #ifndef WORKLIST_H_
 #define WORKLIST_H_
 
+#include "stp/AST/NodeSideTable.h"
+
 namespace simplifier
 {
   namespace constantBitP
@@ -35,31 +37,102 @@ namespace simplifier
 
     class WorkList
     {
-      /* Rough worklist. Constraint Programming people have lovely structures to do this
-       * The set (on my machine), is implemented by red-black trees. Deleting just from one end may unbalance the tree??
+      /* Nodes are kept in buckets, one for each topological depth and operator
+       * cost. The lowest node is worked on first, so a node usually sees all the
+       * changes to its children before it's worked on. At the same depth the
+       * cheap operators go before the multiplications and divisions. Each node
+       * is in the queue at most once.
        */
 
     private:
+      enum
+      {
+        CHEAP = 0, EXPENSIVE, NUMBER_OF_COSTS
+      };
+
+      struct Entry
+      {
+        unsigned bucket;
+        bool queued;
+        bool popped; // Has been worked on before.
+        unsigned visited; // The last initWorkList call that visited it.
+      };
+
+      // Slots are handed out in the order nodes are first seen, so the node in
+      // slot i is slots.key(i).
+      BEEV::NodeSideTable<unsigned> slots;
+      vector<Entry> entries;
 
-      // select nodes from the cheap_worklist first.
-      set<BEEV::ASTNode> cheap_workList; // Nodes to work on.
-      set<BEEV::ASTNode> expensive_workList; // Nodes to work on.
+      vector<vector<unsigned> > buckets;
+      unsigned lowest; // The buckets below this are empty.
+
+      unsigned queued;
+      unsigned visitCount;
+
+      // Statistics.
+      long pushes;
+      long pops;
+      long requeues;
 
       WorkList(const WorkList&); // Shouldn't needed to copy or assign.
       WorkList&
       operator=(const WorkList&);
 
+      static unsigned
+      cost(const Kind k)
+      {
+        switch (k)
+          {
+        case BVMULT:
+        case BVPLUS:
+        case BVDIV:
+        case BVMOD:
+        case SBVDIV:
+        case SBVREM:
+        case SBVMOD:
+          return EXPENSIVE;
+        default:
+          return CHEAP;
+          }
+      }
+
+      // The slot of the node, giving it (and its descendants) one if it hasn't one.
+      unsigned
+      slotOf(const ASTNode& n)
+      {
+        const unsigned* found = slots.find(n);
+        if (found != NULL)
+          return *found;
+
+        // The longest path to a leaf.
+        unsigned depth = 0;
+        for (unsigned i = 0; i < n.Degree(); i++)
+          depth = std::max(depth, entries[slotOf(n[i])].bucket / NUMBER_OF_COSTS + 1);
+
+        Entry e;
+        e.bucket = depth * NUMBER_OF_COSTS + cost(n.GetKind());
+        e.queued = false;
+        e.popped = false;
+        e.visited = 0;
+
+        const unsigned slot = entries.size();
+        entries.push_back(e);
+        slots.insert(n, slot);
+        return slot;
+      }
+
       // We add to the worklist any node that immediately depends on a constant.
        void
-       addToWorklist(const ASTNode& n, ASTNodeSet& visited)
+       addToWorklist(const ASTNode& n)
        {
          if (n.isConstant())
              return;
 
-         if (visited.find(n) != visited.end())
+         Entry& e = entries[slotOf(n)];
+         if (e.visited == visitCount)
            return;
 
-         visited.insert(n);
+         e.visited = visitCount;
 
          bool alreadyAdded = false;
 
@@ -70,7 +143,7 @@ namespace simplifier
                  alreadyAdded = true;
                  push(n);
                }
-             addToWorklist(n[i], visited);
+             addToWorklist(n[i]);
            }
        }
 
@@ -79,19 +152,33 @@ namespace simplifier
 
       WorkList(const ASTNode& top)
       {
+        lowest = 0;
+        queued = 0;
+        visitCount = 0;
+        pushes = pops = requeues = 0;
+
         initWorkList(top);
       }
 
+      // Starts empty.
+      WorkList()
+      {
+        lowest = 0;
+        queued = 0;
+        visitCount = 0;
+        pushes = pops = requeues = 0;
+      }
+
       int size()
       {
-        return cheap_workList.size() + expensive_workList.size();
+        return queued;
       }
 
       void
       initWorkList(const ASTNode&n)
       {
-        ASTNodeSet visited;
-        addToWorklist(n, visited);
+        visitCount++;
+        addToWorklist(n);
       }
 
 
@@ -101,60 +188,65 @@ namespace simplifier
         if (n.isConstant()) // don't ever add constants to the worklist.
           return;
 
-        //cerr << "WorkList Inserting:" << n.GetNodeNum() << endl;
-        if (n.GetKind() == BVMULT || n.GetKind() == BVPLUS || n.GetKind() == BVDIV)
-          expensive_workList.insert(n);
-        else
-          cheap_workList.insert(n);
+        Entry& e = entries[slotOf(n)];
+        if (e.queued)
+          return;
 
+        //cerr << "WorkList Inserting:" << n.GetNodeNum() << endl;
+        e.queued = true;
+        queued++;
+        pushes++;
+        if (e.popped)
+          requeues++;
+
+        if (e.bucket >= buckets.size())
+          buckets.resize(e.bucket + 1);
+        buckets[e.bucket].push_back(*slots.find(n));
+        lowest = std::min(lowest, e.bucket);
       }
 
       BEEV::ASTNode
       pop()
       {
         assert(!isEmpty());
-        if (cheap_workList.size() > 0)
-          {
-            ASTNode ret = *cheap_workList.begin();
-            cheap_workList.erase(cheap_workList.begin());
-            return ret;
-          }
-        else
-          {
-            assert (expensive_workList.size() > 0);
-            ASTNode ret = *expensive_workList.begin();
-            expensive_workList.erase(expensive_workList.begin());
-            return ret;
-          }
+        while (buckets[lowest].empty())
+          lowest++;
+
+        const unsigned slot = buckets[lowest].back();
+        buckets[lowest].pop_back();
+
+        Entry& e = entries[slot];
+        e.queued = false;
+        e.popped = true;
+        queued--;
+        pops++;
+        return slots.key(slot);
       }
 
       bool
       isEmpty()
       {
-        return cheap_workList.empty() && expensive_workList.empty();
+        return queued == 0;
       }
 
       void
       print()
       {
         cerr << "+Worklist" << endl;
-        set<BEEV::ASTNode>::const_iterator it = cheap_workList.begin();
-        while (it != cheap_workList.end())
-          {
-            cerr << *it << " ";
-            it++;
-          }
-
-        it = expensive_workList.begin();
-        while (it != expensive_workList.end())
-          {
-            cerr << *it << " ";
-            it++;
-          }
+        for (unsigned b = lowest; b < buckets.size(); b++)
+          for (unsigned i = 0; i < buckets[b].size(); i++)
+            cerr << slots.key(buckets[b][i]) << " ";
 
         cerr << "-Worklist" << endl;
 
       }
+
+      void
+      printStats()
+      {
+        std::cout << "Constant bit propagation worklist. Pushes: " << pushes
+                  << " Pops: " << pops << " Requeues: " << requeues << endl;
+      }
     };
   }
 }
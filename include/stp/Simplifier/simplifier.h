@@ -34,7 +34,10 @@ THE SOFTWARE.
 namespace BEEV
 {
   ASTNode NonMemberBVConstEvaluator(const ASTNode& t);
-  ASTNode NonMemberBVConstEvaluator(STPMgr* _bm , const Kind k, const ASTVec& input_children, unsigned int inputwidth);
+  // Without "fast64", values of 64 bits or less are folded by the general
+  // code too, so that the fast path can be checked against it.
+  ASTNode NonMemberBVConstEvaluator(STPMgr* _bm , const Kind k, const ASTVec& input_children, unsigned int inputwidth,
+                                    bool fast64 = true);
 
   class Simplifier  //not copyable
   {
@@ -274,6 +277,12 @@ namespace BEEV
     	substitutionMap.haveAppliedSubstitutionMap();
     }
 
+    // What has been substituted for, in the order it was added.
+    const ASTVec& getSubstitutedKeys() const
+    {
+      return substitutionMap.getKeysAdded();
+    }
+
 
     void ClearAllTables(void) 
     {
@@ -295,6 +304,7 @@ namespace BEEV
         SimplifyMap->clear();
         SimplifyNegMap->clear();
         getVariablesInExpression().ClearAllTables();
+        substitutionMap.clearCache();
     }
 
     VariablesInExpression& getVariablesInExpression()
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "extlib-abc/cnf_short.h"
 #include "extlib-abc/dar.h"
 #include "stp/ToSat/ToSATBase.h"
+#include "stp/AST/NodeSideTable.h"
 
 typedef Cnf_Dat_t_ CNFData;
 typedef Aig_Obj_t AIGNode;
@@ -52,7 +53,7 @@ public:
         Aig_Man_t *aigMgr;
 
         // Map from symbols to their AIG nodes.
-        typedef std::map<ASTNode, vector<BBNodeAIG> > SymbolToBBNode;
+        typedef NodeSideTable<vector<BBNodeAIG> > SymbolToBBNode;
 
         SymbolToBBNode symbolToBBNode;
 
@@ -142,23 +143,22 @@ public:
                 // booleans have width 0.
                 const unsigned width = std::max((unsigned)1, n.GetValueWidth());
 
-                SymbolToBBNode::iterator it;
-                it = symbolToBBNode.find(n);
-                if (symbolToBBNode.end() == it)
+                vector<BBNodeAIG>* bits = symbolToBBNode.find(n);
+                if (bits == NULL)
                 {
-                        symbolToBBNode[n] = vector<BBNodeAIG> (width);
-                        it = symbolToBBNode.find(n);
+                        bits = &symbolToBBNode[n];
+                        bits->resize(width);
                 }
 
-                assert(it->second.size() == width);
+                assert(bits->size() == width);
                 assert(i < width);
 
-                if (!it->second[i].IsNull())
-                        return it->second[i];
+                if (!(*bits)[i].IsNull())
+                        return (*bits)[i];
 
-                it->second[i] = BBNodeAIG(Aig_ObjCreatePi(aigMgr));
-                it->second[i].symbol_index = aigMgr->vPis->nSize-1;
-                return it->second[i];
+                (*bits)[i] = BBNodeAIG(Aig_ObjCreatePi(aigMgr));
+                (*bits)[i].symbol_index = aigMgr->vPis->nSize-1;
+                return (*bits)[i];
         }
 
         BBNodeAIG CreateNode(Kind kind, vector<BBNodeAIG>& children)
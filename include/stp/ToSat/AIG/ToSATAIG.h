@@ -60,11 +60,23 @@ namespace BEEV
     {
         count = 0;
         first = true;
+        aigNodes = cnfVars = cnfClauses = -1;
+        solveSeconds = 0;
     }
 
-    static int cnf_calls;
+    void solve(SATSolver& satSolver);
+
+    static thread_local int cnf_calls;
 
   public:
+    // The sizes of the encoding, -1 until something is encoded, and
+    // the time spent solving. They're logged to calibrate the
+    // difficulty scores.
+    int aigNodes;
+    int cnfVars;
+    int cnfClauses;
+    double solveSeconds;
+
     bool cbIsDestructed()
     {
     	return cb == NULL;
@@ -103,6 +115,10 @@ namespace BEEV
 
     bool  CallSAT(SATSolver& satSolver, const ASTNode& input, bool needAbsRef);
 
+    // The first part of the first call to CallSAT: bitblasts input and
+    // sends the CNF to the solver, without solving it.
+    void  Encode(SATSolver& satSolver, const ASTNode& input, bool needAbsRef);
+
   };
 }
 
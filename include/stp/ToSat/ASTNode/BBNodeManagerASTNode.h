@@ -32,7 +32,6 @@ THE SOFTWARE.
 
 namespace BEEV {
 class ASTNode;
-typedef std::vector<ASTNode> ASTVec;
 
 // Called by the bitblaster. This returns ASTNodes after applying the
 // CreateSimpForm(..) simplifications.
@@ -73,7 +72,8 @@ public:
 
 	// CreateSimpForm removes IFF which aren't handled by the cnf converter.
 	ASTNode CreateNode(Kind kind, vector<ASTNode>& children) {
-		return stp->CreateSimpForm(kind, children);
+		ASTVec c(children.begin(), children.end());
+		return stp->CreateSimpForm(kind, c);
 	}
 
 	ASTNode CreateNode(Kind kind, const ASTNode& child0) {
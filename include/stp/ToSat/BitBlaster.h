@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include <cassert>
 #include <map>
 #include "stp/STPManager/STPManager.h"
+#include "stp/AST/NodeSideTable.h"
 #include <list>
 #include "stp/Simplifier/constantBitP/MultiplicationStats.h"
 
@@ -51,7 +52,6 @@ namespace BEEV
 
   class Simplifier;
   class ASTNode;
-  typedef std::vector<ASTNode> ASTVec;
 
   template<class BBNode, class BBNodeManagerT>
     class BitBlaster;
@@ -64,12 +64,12 @@ namespace BEEV
       // Memo table for bit blasted terms.  If a node has already been
       // bitblasted, it is mapped to a vector of Boolean formulas for
       // the
-      std::map<ASTNode, vector<BBNode> > BBTermMemo;
+      NodeSideTable<vector<BBNode> > BBTermMemo;
 
       // Memo table for bit blasted formulas.  If a node has already
       // been bitblasted, it is mapped to a node representing the
       // bitblasted equivalent
-      std::map<ASTNode, BBNode> BBFormMemo;
+      NodeSideTable<BBNode> BBFormMemo;
 
       /****************************************************************
        * Private Member Functions                                     *
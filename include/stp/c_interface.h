@@ -73,7 +73,25 @@ extern "C" {
     SMS,
     CMS2,
     CMS4,
-    MSP
+    MSP,
+  /*! EXPRDELETE_ON_POP: boolean, default false. If this flag is set,
+    vc_pop deletes the objects (of the kinds that EXPRDELETE covers)
+    that were created since the matching vc_push, so that a long run
+    of push/pop rounds doesn't keep growing. They mustn't be used after
+    the pop. */
+    EXPRDELETE_ON_POP,
+  /*! COMPONENT_THREADS: int, default 1. A query whose constraints split
+    into groups that share no variables has each group solved by its
+    own SAT solver. This is how many of them are solved at once. */
+    COMPONENT_THREADS,
+  /*! QUERY_SLICING: boolean, default false. If this flag is set,
+    vc_query only sends the assertions that are connected to the query
+    (through chains of assertions sharing variables) to the solver.
+    That's sound as long as the assertions are satisfiable on their
+    own, as they are on a feasible path in symbolic execution. The
+    counterexample gives the variables that are only in the left out
+    assertions arbitrary values, which needn't satisfy them. */
+    QUERY_SLICING
 
   };
   void vc_setInterfaceFlags(VC vc, enum ifaceflag_t f, int param_value);
@@ -82,7 +100,22 @@ extern "C" {
   // avoids division by zero errors.
   void make_division_total(VC vc);
 
+  // Appends a line to fileName for each query solved: the predicted
+  // difficulty, the real number of AIG nodes and CNF variables and
+  // clauses, the solve time, and what the prediction was made from.
+  // fit_difficulty fits the difficulty model to such a log.
+  void vc_logDifficulty(VC vc, const char* fileName);
+
+  // Reads the difficulty model's coefficients from a file that
+  // fit_difficulty wrote. Returns 0, leaving the model unchanged, if
+  // the file can't be read.
+  int vc_loadDifficultyModel(VC vc, const char* fileName);
+
   //! Flags can be NULL
+  // Separate VCs can be used from separate threads at the same time, but
+  // each VC (and its expressions) must only be used by one thread at a
+  // time. Calls that take only an Expr work on the VC that the calling
+  // thread last used. Parsing is serialised across threads.
   VC vc_createValidityChecker(void);
 
   // Basic types
@@ -229,7 +262,7 @@ extern "C" {
   // will abort automatically. The soft timeout is checked sometimes in the code,
   // and if the time has passed, then "timeout" will be returned. It's only checked
   // sometimes though, so the actual timeout may be larger. Cryptominisat doesn't check
-  // the timeout yet..
+  // the timeout yet.. The time is wall clock time from the start of the query.
 
   // The C-language doesn't allow default arguments, so to get it compiling, I've split
   // it into two functions.
@@ -74,7 +74,7 @@ namespace BEEV
       }
     };
     vector<Entry> cache;
-    vector<vector<ASTNode> > symbols;
+    vector<ASTVec> symbols;
 
     struct Function
     {
@@ -28,6 +28,17 @@ namespace BEEV
 {
   const ASTVec ASTBVConst::astbv_empty_children;
 
+  // The value of a CBV that's 64 bits or less.
+  static const unsigned InlineWordsOf64 = sizeof(uint64_t) / sizeof(unsigned int);
+
+  static uint64_t GetUint64Of(CBV bv)
+  {
+    uint64_t v = 0;
+    for (unsigned i = 0; i < size_(bv) && i < InlineWordsOf64; i++)
+      v |= ((uint64_t) bv[i]) << (i * sizeof(unsigned int) * 8);
+    return v;
+  }
+
   /****************************************************************
    * ASTBVConst Member Function definitions                       *
    ****************************************************************/
@@ -36,26 +47,76 @@ namespace BEEV
   ASTBVConst::ASTBVConst(CBV bv, unsigned int width) :
     ASTInternal(BVCONST)
   {
-    _bvconst = CONSTANTBV::BitVector_Clone(bv);
     _value_width = width;
     cbv_managed_outside =false;
+    if (isInline())
+      setInline(GetUint64Of(bv));
+    else
+      _bvconst = CONSTANTBV::BitVector_Clone(bv);
   } //End of ASTBVConst constructor
 
+  // Doesn't copy wide CBVs, used for temporary keys.
+  ASTBVConst::ASTBVConst(CBV bv, unsigned int width, enum CBV_LIFETIME l) :
+    ASTInternal(BVCONST)
+  {
+    _value_width = width;
+    cbv_managed_outside =true;
+    if (isInline())
+      setInline(GetUint64Of(bv));
+    else
+      _bvconst = bv;
+  }
+
+  ASTBVConst::ASTBVConst(uint64_t value, unsigned int width) :
+    ASTInternal(BVCONST)
+  {
+    assert(width > 0 && width <= 64);
+    _value_width = width;
+    cbv_managed_outside =false;
+    setInline(value);
+  }
+
   // Copy constructor.
   ASTBVConst::ASTBVConst(const ASTBVConst &sym) :
     ASTInternal(sym._kind)
   {
-    _bvconst = CONSTANTBV::BitVector_Clone(sym._bvconst);
     _value_width = sym._value_width;
     cbv_managed_outside =false;
+    if (isInline())
+      setInline(sym.GetUint64());
+    else
+      _bvconst = CONSTANTBV::BitVector_Clone(sym._bvconst);
   } //End of copy constructor()
 
+  void ASTBVConst::setInline(uint64_t value)
+  {
+    assert(isInline());
+    _bvconst = _inline + 3;
+    bits_(_bvconst) = _value_width;
+    size_(_bvconst) = CONSTANTBV::BitVector_Size(_value_width);
+    mask_(_bvconst) = CONSTANTBV::BitVector_Mask(_value_width);
+
+    // Bits above the width are dropped, as they are in CBVs, and the
+    // unused words are left zero so GetUint64() can read them all.
+    if (_value_width < 64)
+      value &= (((uint64_t) 1) << _value_width) - 1;
+    for (unsigned i = 0; i < InlineWords; i++)
+      _inline[3 + i] = (unsigned int) (value >> (i * sizeof(unsigned int) * 8));
+  }
+
   // Call this when deleting a node that has been stored in the the
   // unique table
   void ASTBVConst::CleanUp()
   {
-    (ParserBM)->_bvconst_unique_table.erase(this);
-    delete this;
+    // The STPMgr that made the node, which needn't be the one bound
+    // to this thread.
+    STPMgr* bm = NodeSlab::of(this).getOwner();
+    bm->_bvconst_unique_table.erase(this);
+#ifdef STP_NODE_HANDLES
+    ReleaseHandle();
+#endif
+    this->~ASTBVConst();
+    bm->bvconst_slab.release(this);
   } //End of Cleanup()
 
   // Print function for bvconst -- return _bvconst value in bin
@@ -122,6 +183,11 @@ namespace BEEV
 
   size_t ASTBVConst::ASTBVConstHasher::operator()(const ASTBVConst * bvc) const
   {
+    if (bvc->isInline())
+      {
+        uint64_t h = (bvc->GetUint64() ^ bvc->_value_width) * 0x9E3779B97F4A7C15ULL;
+        return (size_t) (h ^ (h >> 29));
+      }
     return CONSTANTBV::BitVector_Hash(bvc->_bvconst);
   } //End of ASTBVConstHasher operator
 
@@ -133,6 +199,8 @@ namespace BEEV
       {
         return false;
       }
+    if (bvc1->isInline())
+      return bvc1->GetUint64() == bvc2->GetUint64();
     return (0 == 
             CONSTANTBV::BitVector_Compare(bvc1->_bvconst,
                                           bvc2->_bvconst));
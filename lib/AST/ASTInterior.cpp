@@ -34,8 +34,15 @@ namespace BEEV
   // the unique table
   void ASTInterior::CleanUp()
   {
-    (ParserBM)->_interior_unique_table.erase(this);
-    delete this;
+    // The STPMgr that made the node, which needn't be the one bound
+    // to this thread.
+    STPMgr* bm = NodeSlab::of(this).getOwner();
+    bm->_interior_unique_table.erase(this);
+#ifdef STP_NODE_HANDLES
+    ReleaseHandle();
+#endif
+    this->~ASTInterior();
+    bm->interior_slab.release(this);
   } //End of Cleanup()
 
   // Returns kinds.  "lispprinter" handles printing of parenthesis
@@ -23,6 +23,7 @@ THE SOFTWARE.
 ********************************************************************/
 
 #include <sstream>
+#include <mutex>
 #include "stp/AST/AST.h"
 #include "stp/STPManager/STP.h"
 
@@ -31,15 +32,48 @@ THE SOFTWARE.
 ********************************************************************/
 namespace BEEV 
 {
-    uint8_t ASTNode::getIteration() const
-    {
-        return _int_node_ptr->iteration;
-    }
+#ifdef STP_NODE_HANDLES
+  ASTInternal** ASTInternal::handle_pages[1 << (32 - HandlePageBits)];
 
-    void ASTNode::setIteration(uint8_t v) const
-    {
-        _int_node_ptr->iteration = v;
-    }
+  // Guards the free list and the allocation of pages.
+  static std::mutex handle_lock;
+  static vector<uint32_t> free_handles;
+  static uint64_t next_handle = 1; // 0 is the null node.
+
+  void ASTInternal::AssignHandle()
+  {
+    std::lock_guard<std::mutex> guard(handle_lock);
+    if (free_handles.empty())
+      {
+        if (next_handle > UINT32_MAX)
+          FatalError("AssignHandle: more than 2^32 live nodes");
+        _handle = (uint32_t) next_handle++;
+        ASTInternal**& page = handle_pages[_handle >> HandlePageBits];
+        if (page == NULL)
+          page = new ASTInternal*[HandlePageSize]();
+      }
+    else
+      {
+        _handle = free_handles.back();
+        free_handles.pop_back();
+      }
+    handle_pages[_handle >> HandlePageBits][_handle & (HandlePageSize - 1)] = this;
+  }
+
+  void ASTInternal::ReleaseHandle()
+  {
+    assert(LookupHandle(_handle) == this);
+    std::lock_guard<std::mutex> guard(handle_lock);
+    handle_pages[_handle >> HandlePageBits][_handle & (HandlePageSize - 1)] = NULL;
+    free_handles.push_back(_handle);
+  }
+
+  size_t ASTInternal::GetHandleCount()
+  {
+    std::lock_guard<std::mutex> guard(handle_lock);
+    return (size_t) (next_handle - 1 - free_handles.size());
+  }
+#endif
 
 
 
@@ -47,7 +81,11 @@ namespace BEEV
   //
   // creates a new pointer, increments refcount of pointed-to object.
   ASTNode::ASTNode(ASTInternal *in) :
+#ifdef STP_NODE_HANDLES
+    _handle(in ? in->_handle : 0)
+#else
     _int_node_ptr(in)
+#endif
   {
     if (in)
       {
@@ -57,51 +95,70 @@ namespace BEEV
 
   // Copy constructor.  Maintain _ref_count
   ASTNode::ASTNode(const ASTNode &n) :
+#ifdef STP_NODE_HANDLES
+    _handle(n._handle)
+#else
     _int_node_ptr(n._int_node_ptr)
+#endif
   {
-    if (n._int_node_ptr)
+    ASTInternal * in = n.internal();
+    if (in)
       {
-        n._int_node_ptr->IncRef();
+        in->IncRef();
       }
   } //End of Copy Constructor for ASTNode
 
+#ifdef STP_NODE_HANDLES
+  ASTInternal * ASTNode::internal() const
+  {
+    if (_handle == 0)
+      return NULL;
+    return ASTInternal::LookupHandle(_handle);
+  } //End of internal()
+#endif
+
   // ASTNode accessor function.
   Kind ASTNode::GetKind() const
   {
     //cout << "GetKind: " << _int_node_ptr;
-    return _int_node_ptr->GetKind();
+    return internal()->GetKind();
   } //End of GetKind()
 
   // Declared here because of same ordering problem as GetKind.
   const ASTVec &ASTNode::GetChildren() const
   {
-    return _int_node_ptr->GetChildren();
+    return internal()->GetChildren();
   } //End of GetChildren()
 
   // Access node number
   int ASTNode::GetNodeNum() const
   {
-    return _int_node_ptr->_node_num;
+    return internal()->_node_num;
   } //End of GetNodeNum()
 
+  unsigned int ASTNode::GetRefCount() const
+  {
+    return internal()->_ref_count;
+  }
+
   unsigned int ASTNode::GetIndexWidth() const
   {
-    return _int_node_ptr->_index_width;
+    return internal()->_index_width;
   } //End of GetIndexWidth()
 
   void ASTNode::SetIndexWidth(unsigned int iw) const
   {
-    _int_node_ptr->_index_width = iw;
+    internal()->_index_width = iw;
   } //End of SetIndexWidth()
 
   unsigned int ASTNode::GetValueWidth() const
   {
-    return _int_node_ptr->_value_width;
+    return internal()->_value_width;
   } //End of GetValueWidth()
 
   void ASTNode::SetValueWidth(unsigned int vw) const
   {
-    _int_node_ptr->_value_width = vw;
+    internal()->_value_width = vw;
   } //End of SetValueWidth()
 
   //return the type of the ASTNode: 
@@ -121,36 +178,46 @@ namespace BEEV
   // Assignment
   ASTNode& ASTNode::operator=(const ASTNode& n)
   {
-    if (n._int_node_ptr)
+    ASTInternal * in = n.internal();
+    if (in)
       {
-        n._int_node_ptr->IncRef();
+        in->IncRef();
       }
-    if (_int_node_ptr)
+    ASTInternal * old = internal();
+    if (old)
       {
-        _int_node_ptr->DecRef();
+        old->DecRef();
       }
+#ifdef STP_NODE_HANDLES
+    _handle = n._handle;
+#else
     _int_node_ptr = n._int_node_ptr;
+#endif
     return *this;
   } //End of operator=
 
   // Destructor
   ASTNode::~ASTNode()
   {
-    if (_int_node_ptr)
+    ASTInternal * in = internal();
+    if (in)
       {
-        _int_node_ptr->DecRef();
+        in->DecRef();
       }
   } //End of Destructor()
 
   STPMgr* ASTNode::GetSTPMgr() const
   {
-    return ParserBM;
+    ASTInternal * in = internal();
+    if (in == NULL)
+      return ParserBM;
+    return NodeSlab::of(in).getOwner();
   } //End of GetSTPMgr()
 
   // Print the node
   void ASTNode::nodeprint(ostream& os, bool c_friendly) const
   {
-    _int_node_ptr->nodeprint(os, c_friendly);
+    internal()->nodeprint(os, c_friendly);
   } //End of nodeprint()
 
   // Get the name from a symbol (char *).  It's an error if kind !=
@@ -159,7 +226,7 @@ namespace BEEV
   {
     if (GetKind() != SYMBOL)
       FatalError("GetName: Called GetName on a non-symbol: ", *this);
-    return ((ASTSymbol *) _int_node_ptr)->GetName();
+    return ((ASTSymbol *) internal())->GetName();
   } //End of GetName()
 
   // Get the value of bvconst from a bvconst.  It's an error if kind
@@ -169,7 +236,7 @@ namespace BEEV
   {
     if (GetKind() != BVCONST)
       FatalError("GetBVConst: non bitvector-constant: ", *this);
-    return ((ASTBVConst *) _int_node_ptr)->GetBVConst();
+    return ((ASTBVConst *) internal())->GetBVConst();
   } //End of GetBVConst()
 
   unsigned int ASTNode::GetUnsignedConst() const
@@ -233,13 +300,13 @@ namespace BEEV
   bool
   ASTNode::isSimplfied() const
   {
-    return _int_node_ptr->isSimplified();
+    return internal()->isSimplified();
   }
 
   void
   ASTNode::hasBeenSimplfied() const
   {
-    _int_node_ptr->hasBeenSimplified();
+    internal()->hasBeenSimplified();
   }
 
 
@@ -50,9 +50,16 @@ namespace BEEV
   // unique table
   void ASTSymbol::CleanUp()
   {
-    (ParserBM)->_symbol_unique_table.erase(this);
+    // The STPMgr that made the node, which needn't be the one bound
+    // to this thread.
+    STPMgr* bm = NodeSlab::of(this).getOwner();
+    bm->_symbol_unique_table.erase(this);
     free((char*) this->_name);
-    delete this;
+#ifdef STP_NODE_HANDLES
+    ReleaseHandle();
+#endif
+    this->~ASTSymbol();
+    bm->symbol_slab.release(this);
   }//End of cleanup()
 
   unsigned long long hash(unsigned char *str)
@@ -51,7 +51,7 @@ namespace BEEV
   //the function will then print the stats that it has collected.
   void CountersAndStats(const char * functionname, STPMgr * bm)
   {
-    static function_counters s;
+    static thread_local function_counters s;
     if (bm->UserFlags.stats_flag)
       {
 
@@ -65,6 +65,7 @@ namespace BEEV
                    << it->first 
                    << ": is called: " 
                    << it->second << endl;
+            bm->printNodeAllocationStats();
             return;
           }
         s[functionname] += 1;
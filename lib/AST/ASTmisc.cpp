@@ -272,12 +272,12 @@ namespace BEEV
 
   void SortByExprNum(ASTVec& v)
   {
-    sort(v.begin(), v.end(), exprless);
+    std::sort(v.begin(), v.end(), exprless);
   }
 
   void SortByArith(ASTVec& v)
   {
-    sort(v.begin(), v.end(), arithless);
+    std::sort(v.begin(), v.end(), arithless);
   }
 
   bool isAtomic(Kind kind)
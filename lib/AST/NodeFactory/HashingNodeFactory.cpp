@@ -55,8 +55,9 @@ BEEV::ASTNode HashingNodeFactory::CreateNode(const Kind kind, const BEEV::ASTVec
 		SortByArith(children);
 	}
 
-        ASTInterior *n_ptr = new ASTInterior(kind,children);
-	ASTNode n(bm.LookupOrCreateInterior(n_ptr));
+        ASTInterior temp_interior(kind);
+        temp_interior._children.swap(children);
+	ASTNode n(bm.LookupOrCreateInterior(temp_interior));
 	return n;
 }
 
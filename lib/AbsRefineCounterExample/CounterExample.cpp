@@ -52,7 +52,15 @@ namespace BEEV
     assert(CounterExampleMap.size() == 0);
 
     CopySolverMap_To_CounterExample();
+    CopySATModel_To_CounterExample(newS, satVarToSymbol);
+    CopyArrayReads_To_CounterExample();
+  } //End of ConstructCounterExample
 
+  // Adds the values that the solver gives the symbols.
+  void
+  AbsRefine_CounterExample::CopySATModel_To_CounterExample(SATSolver& newS,
+      ToSATBase::ASTNodeToSATVar& satVarToSymbol)
+  {
     for (ToSATBase::ASTNodeToSATVar::const_iterator it = satVarToSymbol.begin(); it
         != satVarToSymbol.end(); it++)
       {
@@ -98,7 +106,12 @@ namespace BEEV
 			CounterExampleMap[symbol] = BoolVectoBVConst(&bitVector_array, symbol.GetValueWidth());
         }
       }
+  }
 
+  // Adds the array reads, which need the values of the symbols first.
+  void
+  AbsRefine_CounterExample::CopyArrayReads_To_CounterExample(void)
+  {
         for (ArrayTransformer::ArrType::const_iterator it = ArrayTransform->arrayToIndexToRead.begin(), itend =
         ArrayTransform->arrayToIndexToRead.end(); it != itend; it++)
       {
@@ -126,7 +139,7 @@ namespace BEEV
               CounterExampleMap[key] = value;
           }
       }
-  } //End of ConstructCounterExample
+  }
 
 
   // FUNCTION: accepts a non-constant term, and returns the
@@ -964,50 +977,82 @@ namespace BEEV
             ToSAT::ASTNodeToSATVar m = tosat->SATVar_to_SymbolIndexMap();
             PrintSATModel(SatSolver, m);
           }
-        //check if the counterexample is good or not
-        if (bm->counterexample_checking_during_refinement)
-          bm->bvdiv_exception_occured = false;
-        ASTNode orig_result = ComputeFormulaUsingModel(original_input);
-        if (!(ASTTrue == orig_result || ASTFalse == orig_result))
-          FatalError("TopLevelSat: Original input must compute to "
-                     "true or false against model");
-
-        bm->GetRunTimes()->stop(RunTimes::CounterExampleGeneration);
-
-        // if the counterexample is indeed a good one, then return
-        // invalid
-        if (ASTTrue == orig_result)
-          {
-            if (bm->UserFlags.check_counterexample_flag)
-                                CheckCounterExample(SatSolver.okay());
+        return CheckSATModel(original_input);
+      }
+    else
+      {
+        //Control should never reach here
+        //PrintOutput(true);
+        return SOLVER_ERROR;
+      }
+  } //end of CALLSAT_ResultCheck
 
-            if (bm->UserFlags.stats_flag
-                || bm->UserFlags.print_counterexample_flag)
-              {
-            PrintCounterExample(SatSolver.okay());
-            PrintCounterExample_InOrder(SatSolver.okay());
-              }
-            return SOLVER_INVALID;
-          }
-        // counterexample is bogus: flag it
-        else
+  SOLVER_RETURN_TYPE
+  AbsRefine_CounterExample::CallSAT_ResultCheck(const vector<SATSolver*>& solvers,
+      const vector<ToSATBase*>& tosats, const ASTNode& original_input)
+  {
+    assert(solvers.size() == tosats.size());
+
+    bm->GetRunTimes()->start(RunTimes::CounterExampleGeneration);
+    CounterExampleMap.clear();
+    ComputeFormulaMap.clear();
+
+    if (bm->UserFlags.construct_counterexample_flag)
+      {
+        CopySolverMap_To_CounterExample();
+        for (size_t i = 0; i < solvers.size(); i++)
           {
-            if (bm->UserFlags.stats_flag && bm->UserFlags.print_nodes_flag)
-              {
-                cout << "Supposedly bogus one: \n";
-                PrintCounterExample(true);
-              }
+            assert(solvers[i]->okay());
+            CopySATModel_To_CounterExample(*solvers[i], tosats[i]->SATVar_to_SymbolIndexMap());
+          }
+        CopyArrayReads_To_CounterExample();
+      }
 
-            assert (bm->UserFlags.solver_to_use != UserDefinedFlags::MINISAT_PROPAGATORS); // The array solver shouldn't have returned undecided..
+    return CheckSATModel(original_input);
+  }
+
+  // Evaluates the original input against the counterexample, which has
+  // been built from a satisfying assignment.
+  SOLVER_RETURN_TYPE
+  AbsRefine_CounterExample::CheckSATModel(const ASTNode& original_input)
+  {
+    //check if the counterexample is good or not
+    if (bm->counterexample_checking_during_refinement)
+      bm->bvdiv_exception_occured = false;
+    ASTNode orig_result = ComputeFormulaUsingModel(original_input);
+    if (!(ASTTrue == orig_result || ASTFalse == orig_result))
+      FatalError("TopLevelSat: Original input must compute to "
+                 "true or false against model");
+
+    bm->GetRunTimes()->stop(RunTimes::CounterExampleGeneration);
+
+    // if the counterexample is indeed a good one, then return
+    // invalid
+    if (ASTTrue == orig_result)
+      {
+        if (bm->UserFlags.check_counterexample_flag)
+          CheckCounterExample(true);
 
-            return SOLVER_UNDECIDED;
+        if (bm->UserFlags.stats_flag
+            || bm->UserFlags.print_counterexample_flag)
+          {
+            PrintCounterExample(true);
+            PrintCounterExample_InOrder(true);
           }
+        return SOLVER_INVALID;
       }
+    // counterexample is bogus: flag it
     else
       {
-        //Control should never reach here
-        //PrintOutput(true);
-        return SOLVER_ERROR;
+        if (bm->UserFlags.stats_flag && bm->UserFlags.print_nodes_flag)
+          {
+            cout << "Supposedly bogus one: \n";
+            PrintCounterExample(true);
+          }
+
+        assert (bm->UserFlags.solver_to_use != UserDefinedFlags::MINISAT_PROPAGATORS); // The array solver shouldn't have returned undecided..
+
+        return SOLVER_UNDECIDED;
       }
-  } //end of CALLSAT_ResultCheck()     
+  }     
 }
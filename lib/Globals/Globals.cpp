@@ -34,14 +34,14 @@ THE SOFTWARE.
 
 namespace BEEV
 {
-  enum inputStatus input_status = NOT_DECLARED;
+  thread_local enum inputStatus input_status = NOT_DECLARED;
 
   //Originally just used by the parser, now used elesewhere.
-  STP     * GlobalSTP;
-  STPMgr  * ParserBM;
+  thread_local STP     * GlobalSTP;
+  thread_local STPMgr  * ParserBM;
 
   // Used exclusively for parsing.
-  Cpp_interface * parserInterface;
+  thread_local Cpp_interface * parserInterface;
 
   // FIXME: This isn't in Globals.h so how can anyone use this?
   void (*vc_error_hdlr)(const char* err_msg) = 0;
@@ -25,16 +25,22 @@ THE SOFTWARE.
 
 #include <stdlib.h>
 #include <assert.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include "stp/Interface/fdstream.h"
 #include "stp/Printer/printers.h"
 #include "stp/cpp_interface.h"
+#include "stp/STPManager/NodeIterator.h"
 // FIXME: External library
 #include "extlib-abc/cnf_short.h"
 
 #ifdef _MSC_VER
 #include <compdep.h>
 #else
-#include <signal.h>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 #endif
 
 using std::cout;
@@ -55,14 +61,213 @@ typedef BEEV::BVSolver*                  bvsolverstar;
 typedef BEEV::AbsRefine_CounterExample * ctrexamplestar;
 typedef BEEV::ASTVec                     nodelist;
 typedef BEEV::CompleteCounterExample*    CompleteCEStar;
-BEEV::ASTVec *decls = NULL;
-SimplifyingNodeFactory *simpNF = NULL;
 //vector<BEEV::ASTNode *> created_exprs;
 
-// persist holds a copy of ASTNodes so that the reference count of
-// objects we have pointers to doesn't hit zero.
-vector<BEEV::ASTNode*> persist;
-bool cinterface_exprdelete_on_flag = true;
+// Indexes the assertions by the symbols in them, so that a query can be
+// given just the assertions that are connected to it. The assertions are
+// kept in the order that GetAsserts() returns them, which is a stack, so
+// popping a context removes a suffix.
+class AssertSlicer //not copyable
+{
+  typedef hash_map<BEEV::ASTNode, vector<size_t>, BEEV::ASTNode::ASTNodeHasher,
+      BEEV::ASTNode::ASTNodeEqual> SymbolToAsserts;
+
+  bmstar bm;
+  BEEV::ASTVec asserts;
+  vector<BEEV::ASTVec> symbols; // of each assertion.
+  SymbolToAsserts bySymbol;     // ascending, so a pop removes from the back.
+  vector<size_t> ground;        // assertions without symbols.
+
+  AssertSlicer(const AssertSlicer&);
+  AssertSlicer& operator=(const AssertSlicer&);
+
+  void getSymbols(const BEEV::ASTNode& n, BEEV::ASTVec& out)
+  {
+    BEEV::NodeIterator ni(n, bm->ASTUndefined, *bm);
+    BEEV::ASTNode current;
+    while ((current = ni.next()) != ni.end())
+      if (current.GetKind() == BEEV::SYMBOL)
+        out.push_back(current);
+  }
+
+public:
+  explicit AssertSlicer(bmstar b) :
+    bm(b)
+  {
+  }
+
+  size_t size() const
+  {
+    return asserts.size();
+  }
+
+  void add(const BEEV::ASTNode& a)
+  {
+    const size_t i = asserts.size();
+    asserts.push_back(a);
+    symbols.push_back(BEEV::ASTVec());
+    getSymbols(a, symbols.back());
+
+    const BEEV::ASTVec& s = symbols.back();
+    if (s.empty())
+      ground.push_back(i);
+    for (size_t j = 0; j < s.size(); j++)
+      bySymbol[s[j]].push_back(i);
+  }
+
+  // Forgets all but the first n assertions.
+  void truncate(size_t n)
+  {
+    while (asserts.size() > n)
+      {
+        const size_t i = asserts.size() - 1;
+        const BEEV::ASTVec& s = symbols.back();
+        if (s.empty())
+          {
+            assert(ground.back() == i);
+            ground.pop_back();
+          }
+        for (size_t j = 0; j < s.size(); j++)
+          {
+            SymbolToAsserts::iterator it = bySymbol.find(s[j]);
+            assert(it != bySymbol.end() && it->second.back() == i);
+            it->second.pop_back();
+            if (it->second.empty())
+              bySymbol.erase(it);
+          }
+        symbols.pop_back();
+        asserts.pop_back();
+      }
+  }
+
+  // Brings the index up to date with current, the assertions as
+  // GetAsserts() gives them. Normally they've all been added already.
+  void sync(const BEEV::ASTVec& current)
+  {
+    size_t same = 0;
+    while (same < asserts.size() && same < current.size()
+           && asserts[same] == current[same])
+      same++;
+    truncate(same);
+    for (size_t i = same; i < current.size(); i++)
+      add(current[i]);
+  }
+
+  // The assertions that share a symbol with the query, or with one of
+  // the assertions that do, and so on, along with those that have no
+  // symbols. They're in the same order as in the index.
+  BEEV::ASTVec slice(const BEEV::ASTNode& query)
+  {
+    vector<bool> taken(asserts.size(), false);
+    for (size_t i = 0; i < ground.size(); i++)
+      taken[ground[i]] = true;
+
+    BEEV::ASTVec todo;
+    getSymbols(query, todo);
+    BEEV::ASTNodeSet seen(todo.begin(), todo.end());
+    while (!todo.empty())
+      {
+        const BEEV::ASTNode symbol = todo.back();
+        todo.pop_back();
+        SymbolToAsserts::const_iterator it = bySymbol.find(symbol);
+        if (it == bySymbol.end())
+          continue;
+        for (size_t j = 0; j < it->second.size(); j++)
+          {
+            const size_t i = it->second[j];
+            if (taken[i])
+              continue;
+            taken[i] = true;
+            for (size_t k = 0; k < symbols[i].size(); k++)
+              if (seen.insert(symbols[i][k]).second)
+                todo.push_back(symbols[i][k]);
+          }
+      }
+
+    BEEV::ASTVec result;
+    for (size_t i = 0; i < asserts.size(); i++)
+      if (taken[i])
+        result.push_back(asserts[i]);
+    return result;
+  }
+};
+
+// Everything the C interface keeps for one validity checker. It is an
+// STP, and a VC points at the STP part, so a VC can still be cast to
+// stpstar.
+struct CInterfaceVC : public BEEV::STP
+{
+  CInterfaceVC(bmstar b, simpstar s, bvsolverstar bvsolver,
+               BEEV::ArrayTransformer * at, BEEV::ToSAT * tosat,
+               ctrexamplestar ce) :
+    BEEV::STP(b, s, bvsolver, at, tosat, ce),
+    simpNF(NULL), exprdelete_on_flag(true), exprdelete_on_pop_flag(false),
+    query_slicing_flag(false), slicer(b)
+  {
+  }
+
+  // The variables created through the interface, for printing.
+  BEEV::ASTVec decls;
+  SimplifyingNodeFactory *simpNF;
+
+  // persist holds a copy of ASTNodes so that the reference count of
+  // objects we have pointers to doesn't hit zero.
+  vector<BEEV::ASTNode*> persist;
+  bool exprdelete_on_flag;
+  bool exprdelete_on_pop_flag;
+
+  // Whether queries only get the assertions connected to them.
+  bool query_slicing_flag;
+  AssertSlicer slicer;
+
+  // The sizes of decls, persist and slicer at each vc_push, so that
+  // vc_pop can let go of what was made since.
+  vector<size_t> decls_marks;
+  vector<size_t> persist_marks;
+  vector<size_t> slicer_marks;
+
+  // Whether each of decls was declared in a context that has been
+  // popped. Those are dropped once nothing else refers to them.
+  vector<bool> decls_popped;
+
+  void addDecl(const BEEV::ASTNode& n)
+  {
+    decls.push_back(n);
+    decls_popped.push_back(false);
+  }
+
+  void dropUnusedPoppedDecls()
+  {
+    size_t j = 0;
+    for (size_t i = 0; i < decls.size(); i++)
+      if (!decls_popped[i] || decls[i].GetRefCount() > 1)
+        {
+          decls[j] = decls[i];
+          decls_popped[j++] = decls_popped[i];
+        }
+    decls.resize(j);
+    decls_popped.resize(j);
+  }
+};
+
+static CInterfaceVC * context(VC vc) {
+  return static_cast<CInterfaceVC*>((stpstar)vc);
+}
+
+// Makes vc the calling thread's current instance (which the parsers,
+// printers and node clean up use), and returns its STPMgr. Each thread
+// has its own current instance, so different VCs can be used from
+// different threads at the same time.
+static bmstar bindVC(VC vc) {
+  stpstar stp = (stpstar)vc;
+  BEEV::GlobalSTP = stp;
+  BEEV::ParserBM = stp->bm;
+  return stp->bm;
+}
+
+// The flex/bison parsers keep their state in globals, so only one
+// thread parses at a time.
+static std::mutex parser_lock;
 
 // GLOBAL FUNCTION: parser
 extern int cvcparse(void*);
@@ -70,21 +275,30 @@ extern int smtparse(void*);
 
 //TODO remove this, it's really ugly
 void vc_setFlags(VC vc, char c, int param_value) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   process_argument(c, b);
 }
 
 //TODO remove this, it's really ugly
 void vc_setFlag(VC vc, char c) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   process_argument(c, b);
 }
 
 void vc_setInterfaceFlags(VC vc, enum ifaceflag_t f, int param_value) {
-    bmstar b = (bmstar)(((stpstar)vc)->bm);
+    bmstar b = bindVC(vc);
     switch (f) {
   case EXPRDELETE:
-    cinterface_exprdelete_on_flag = param_value != 0;
+    context(vc)->exprdelete_on_flag = param_value != 0;
+    break;
+  case EXPRDELETE_ON_POP:
+    context(vc)->exprdelete_on_pop_flag = param_value != 0;
+    break;
+  case COMPONENT_THREADS:
+    b->UserFlags.set("component-threads", std::to_string(param_value));
+    break;
+  case QUERY_SLICING:
+    context(vc)->query_slicing_flag = param_value != 0;
     break;
   case MS:
       b->UserFlags.solver_to_use = BEEV::UserDefinedFlags::MINISAT_SOLVER;
@@ -109,10 +323,22 @@ void vc_setInterfaceFlags(VC vc, enum ifaceflag_t f, int param_value) {
 
 void make_division_total(VC vc)
 {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   b->UserFlags.division_by_zero_returns_one_flag = true;
 }
 
+void vc_logDifficulty(VC vc, const char* fileName)
+{
+  bmstar b = bindVC(vc);
+  b->UserFlags.set("difficulty-log", fileName);
+}
+
+int vc_loadDifficultyModel(VC vc, const char* fileName)
+{
+  bmstar b = bindVC(vc);
+  return b->difficultyModel.load(fileName) ? 1 : 0;
+}
+
 //Create a validity Checker. This is the global STPMgr
 VC vc_createValidityChecker(void) {
   CONSTANTBV::ErrCode c = CONSTANTBV::BitVector_Boot();
@@ -133,17 +359,16 @@ VC vc_createValidityChecker(void) {
                                        arrayTransformer
                                        );
 
-  BEEV::ParserBM = bm;
-  stpstar stp =
-    new BEEV::STP(bm, simp, 
-                  bvsolver, arrayTransformer, 
-                  tosat, Ctr_Example);
+  CInterfaceVC * ctx =
+    new CInterfaceVC(bm, simp, 
+                     bvsolver, arrayTransformer, 
+                     tosat, Ctr_Example);
+  stpstar stp = ctx;
   
-  simpNF = new SimplifyingNodeFactory(*(bm->hashingNodeFactory), *bm);
-  bm->defaultNodeFactory = simpNF;
+  ctx->simpNF = new SimplifyingNodeFactory(*(bm->hashingNodeFactory), *bm);
+  bm->defaultNodeFactory = ctx->simpNF;
 
-  BEEV::GlobalSTP = stp;
-  decls = new BEEV::ASTVec();
+  bindVC((VC)stp);
   //created_exprs.clear();
   vc_setFlags(stp,'d');
   return (VC)stp;
@@ -173,7 +398,7 @@ char * vc_printSMTLIB(VC vc, Expr e)
 // prints Expr 'e' to stdout as C code
 void vc_printExprCCode(VC vc, Expr e) {
   BEEV::ASTNode q = (*(nodestar)e);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   // print variable declarations
   BEEV::ASTVec declsFromParser = (nodelist)b->ListOfDeclaredVars;
@@ -209,8 +434,9 @@ void vc_printExprFile(VC vc, Expr e, int fd) {
 }
 
 static void vc_printVarDeclsToStream(VC vc, ostream &os) {
-  for(BEEV::ASTVec::iterator i = decls->begin(),
-        iend=decls->end();i!=iend;i++) {
+  BEEV::ASTVec& decls = context(vc)->decls;
+  for(BEEV::ASTVec::iterator i = decls.begin(),
+        iend=decls.end();i!=iend;i++) {
     node a = *i;
     switch(a.GetType()) {
     case BEEV::BITVECTOR_TYPE:
@@ -246,11 +472,12 @@ void vc_printVarDecls(VC vc) {
 }
 
 void vc_clearDecls(VC vc) {
-  decls->clear();
+  context(vc)->decls.clear();
+  context(vc)->decls_popped.clear();
 }
 
 static void vc_printAssertsToStream(VC vc, ostream &os, int simplify_print) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   BEEV::ASTVec v = b->GetAsserts();
   BEEV::Simplifier * simp = new BEEV::Simplifier(b);
   for(BEEV::ASTVec::iterator i=v.begin(),iend=v.end();i!=iend;i++) {
@@ -281,7 +508,7 @@ void vc_printQueryStateToBuffer(VC vc, Expr e,
   assert(e);
   assert(buf);
   assert(len);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   BEEV::Simplifier * simp = new BEEV::Simplifier(b);
 
   // formate the state of the query
@@ -320,7 +547,7 @@ void vc_printCounterExampleToBuffer(VC vc, char **buf, unsigned long *len) {
   assert(vc);
   assert(buf);
   assert(len);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
 
   // formate the state of the query
@@ -347,7 +574,7 @@ void vc_printCounterExampleToBuffer(VC vc, char **buf, unsigned long *len) {
 
 void vc_printExprToBuffer(VC vc, Expr e, char **buf, unsigned long * len) {
   stringstream os;
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = bindVC(vc);
   BEEV::ASTNode q = *((nodestar)e);
   // b->Begin_RemoveWrites = true;
   //   BEEV::ASTNode q = b->SimplifyFormula_TopLevel(*((nodestar)e),false);
@@ -364,7 +591,7 @@ void vc_printExprToBuffer(VC vc, Expr e, char **buf, unsigned long * len) {
 
 void vc_printQuery(VC vc){
   ostream& os = std::cout;
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   os << "QUERY(";
   //b->Begin_RemoveWrites = true;
   //BEEV::ASTNode q = b->SimplifyFormula_TopLevel(b->GetQuery(),false);
@@ -375,11 +602,12 @@ void vc_printQuery(VC vc){
   os << ");" << endl;
 }
 
-nodestar persistNode(node n)
+static nodestar persistNode(VC vc, node n)
 {
+  CInterfaceVC * ctx = context(vc);
   nodestar np = new node(n);
-  if (cinterface_exprdelete_on_flag)
-    persist.push_back(np);
+  if (ctx->exprdelete_on_flag)
+    ctx->persist.push_back(np);
   return np;
 }
 
@@ -389,7 +617,7 @@ nodestar persistNode(node n)
 /////////////////////////////////////////////////////////////////////////////
 //! Create an array type
 Type vc_arrayType(VC vc, Type typeIndex, Type typeData) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar ti = (nodestar)typeIndex;
   nodestar td = (nodestar)typeData;
 
@@ -407,12 +635,12 @@ Type vc_arrayType(VC vc, Type typeIndex, Type typeData) {
     }
   node output = b->CreateNode(BEEV::ARRAY,(*ti)[0],(*td)[0]);
 
-  return persistNode(output);
+  return persistNode(vc, output);
 }
 
 //! Create an expression for the value of array at the given index
 Expr vc_readExpr(VC vc, Expr array, Expr index) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)array;
   nodestar i = (nodestar)index;
 
@@ -428,7 +656,7 @@ Expr vc_readExpr(VC vc, Expr array, Expr index) {
 
 // //! Array update; equivalent to "array WITH [index] := newValue"
 Expr vc_writeExpr(VC vc, Expr array, Expr index, Expr newValue) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)array;
   nodestar i = (nodestar)index;
   nodestar n = (nodestar)newValue;
@@ -452,19 +680,67 @@ Expr vc_writeExpr(VC vc, Expr array, Expr index, Expr newValue) {
 /*! The formula must have Boolean type. */
 void vc_assertFormula(VC vc, Expr e) {
   nodestar a = (nodestar)e;
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   if(!BEEV::is_Form_kind(a->GetKind()))
     BEEV::FatalError("Trying to assert a NON formula: ",*a);
 
   assert(BVTypeCheck(*a));
   b->AddAssert(*a);
+
+  CInterfaceVC * ctx = context(vc);
+  if (ctx->query_slicing_flag)
+    ctx->slicer.add(*a);
 }
 
-void soft_time_out(int ignored)
+#if !defined(__MINGW32__) && !defined(__MINGW64__) && !defined(_MSC_VER)
+// Sets the "expired" flag once timeout_ms of wall clock time has
+// passed. This is per query rather than a process wide SIGVTALRM timer,
+// so that queries on other threads aren't affected. The CPU time of the
+// calling thread wouldn't do, as it stops while the parts of a query are
+// solved on other threads.
+class SoftTimeout
 {
-  BEEV::ParserBM->soft_timeout_expired = true;
-}
+  typedef std::chrono::steady_clock Clock;
+
+  volatile bool & expired;
+  Clock::time_point deadline;
+  bool finished;
+  std::mutex lock;
+  std::condition_variable wake;
+  std::thread watcher;
+
+  void watch()
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    while (!finished)
+      {
+        if (wake.wait_until(guard, deadline) == std::cv_status::timeout && !finished)
+          {
+            expired = true;
+            return;
+          }
+      }
+  }
+
+public:
+  SoftTimeout(volatile bool & e, int timeout_ms) :
+    expired(e), deadline(Clock::now() + std::chrono::milliseconds(timeout_ms)), finished(false)
+  {
+    watcher = std::thread(&SoftTimeout::watch, this);
+  }
+
+  ~SoftTimeout()
+  {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      finished = true;
+    }
+    wake.notify_one();
+    watcher.join();
+  }
+};
+#endif /* !defined(__MINGW32__) && !defined(__MINGW64__) && !defined(_MSC_VER) */
 
 //! Check validity of e in the current context. e must be a FORMULA
 //
@@ -484,22 +760,26 @@ int vc_query(VC vc, Expr e)
   return vc_query_with_timeout(vc,e,-1);
 }
 
+// Propagates what's been asserted since the last query. Nothing is
+// done at a push, so levels that are never queried cost nothing.
+static void updateAssertedFixedBits(VC vc, const BEEV::ASTVec& asserts)
+{
+  bmstar b = bindVC(vc);
+  if (b->UserFlags.bitConstantProp_flag && b->UserFlags.isSet("asserted-constant-bits", "1"))
+    ((stpstar)vc)->assertedFixedBits.update(asserts, ((stpstar)vc)->simp, b->defaultNodeFactory);
+}
+
 int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
   nodestar a = (nodestar)e;
   stpstar stp = ((stpstar)vc);
-  bmstar b = (bmstar)(stp->bm);
+  bmstar b = bindVC(vc);
 
-  assert(!BEEV::ParserBM->soft_timeout_expired);
+  assert(!b->soft_timeout_expired);
 #if !defined(__MINGW32__) && !defined(__MINGW64__) && !defined(_MSC_VER)
+  std::unique_ptr<SoftTimeout> timer;
   if (timeout_ms != -1)
   {
-      itimerval timeout;
-      signal(SIGVTALRM, soft_time_out);
-      timeout.it_interval.tv_usec = 0;
-      timeout.it_interval.tv_sec  = 0;
-      timeout.it_value.tv_usec    = 1000 * (timeout_ms % 1000);
-      timeout.it_value.tv_sec     = timeout_ms / 1000;
-      setitimer(ITIMER_VIRTUAL, &timeout, NULL);
+      timer.reset(new SoftTimeout(b->soft_timeout_expired, timeout_ms));
   }
 #else
   if (timeout_ms != -1)
@@ -516,7 +796,23 @@ int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
   assert(BVTypeCheck(*a));
   b->AddQuery(*a);
 
-  const BEEV::ASTVec v = b->GetAsserts();
+  BEEV::ASTVec v = b->GetAsserts();
+  CInterfaceVC * ctx = context(vc);
+  updateAssertedFixedBits(vc, v);
+
+  const bool check_counterexample = b->UserFlags.check_counterexample_flag;
+  if (ctx->query_slicing_flag)
+    {
+      ctx->slicer.sync(v);
+      const size_t all = v.size();
+      v = ctx->slicer.slice(*a);
+
+      // The counterexample is still checked against what's solved, but
+      // needn't satisfy the assertions that were left out.
+      if (v.size() != all)
+        b->UserFlags.check_counterexample_flag = false;
+    }
+
   node o;
   int output;
   if(!v.empty()) 
@@ -534,13 +830,14 @@ int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
     {
       output = stp->TopLevelSTP(b->CreateNode(BEEV::TRUE),*a);
     }
+  b->UserFlags.check_counterexample_flag = check_counterexample;
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__) && !defined(__MINGW64__)
   if (timeout_ms !=-1)
   {
-    // Reset the timer.
-    setitimer(ITIMER_VIRTUAL, NULL, NULL);
-    BEEV::ParserBM->soft_timeout_expired = false;
+    // Stop the timer.
+    timer.reset();
+    b->soft_timeout_expired = false;
   }
 #endif /* !defined(_MSC_VER) && !defined(__MINGW32__) && !defined(__MINGW64__) */
 
@@ -572,18 +869,59 @@ int vc_query_with_timeout(VC vc, Expr e, int timeout_ms) {
 // }
 
 void vc_push(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
+  CInterfaceVC * ctx = context(vc);
   ((stpstar)vc)->ClearAllTables();
+  ctx->dropUnusedPoppedDecls();
+  ctx->decls_marks.push_back(ctx->decls.size());
+  ctx->persist_marks.push_back(ctx->persist.size());
+  ctx->slicer_marks.push_back(ctx->slicer.size());
+  ((stpstar)vc)->assertedFixedBits.push(b->getAssertCount());
   b->Push();
 }
 
+// What was made since the matching vc_push, and that nothing but the
+// VC refers to, is released so that it's freed. The counterexample is
+// kept, so it can still be read after the pop; the variables it refers
+// to are let go of at a later push or pop.
 void vc_pop(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
+  CInterfaceVC * ctx = context(vc);
+
+  // Before the pop, so the symbols it drops aren't held on to.
+  if (ctx->slicer_marks.empty())
+    ctx->slicer.truncate(0);
+  else
+    {
+      ctx->slicer.truncate(std::min(ctx->slicer_marks.back(), ctx->slicer.size()));
+      ctx->slicer_marks.pop_back();
+    }
+  ((stpstar)vc)->assertedFixedBits.pop();
+
   b->Pop();
+
+  if (!ctx->decls_marks.empty())
+    {
+      for (size_t i = ctx->decls_marks.back(); i < ctx->decls.size(); i++)
+        ctx->decls_popped[i] = true;
+      ctx->decls_marks.pop_back();
+
+      if (ctx->exprdelete_on_pop_flag)
+        {
+          const size_t mark = std::min(ctx->persist_marks.back(), ctx->persist.size());
+          for (size_t i = mark; i < ctx->persist.size(); i++)
+            delete ctx->persist[i];
+          ctx->persist.resize(mark);
+        }
+      ctx->persist_marks.pop_back();
+
+      ctx->simp->ClearCaches();
+      ctx->dropUnusedPoppedDecls();
+    }
 }
 
 void vc_printCounterExample(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);
 
   bool currentPrint = b->UserFlags.print_counterexample_flag;
@@ -603,6 +941,7 @@ void vc_printCounterExample(VC vc) {
 //  */
 
 Expr vc_getCounterExample(VC vc, Expr e) {
+  bindVC(vc);
   nodestar a = (nodestar)e;
   ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
 
@@ -615,6 +954,7 @@ Expr vc_getCounterExample(VC vc, Expr e) {
 }
 
 void vc_getCounterExampleArray(VC vc, Expr e, Expr **indices, Expr **values, int *size) {
+  bindVC(vc);
   nodestar a = (nodestar)e;
   ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
 
@@ -641,7 +981,7 @@ int vc_counterexample_size(VC vc) {
 }
 
 WholeCounterExample vc_getWholeCounterExample(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
 
   CompleteCEStar c = new BEEV::CompleteCounterExample(ce->GetCompleteCounterExample(),b);
@@ -649,6 +989,7 @@ WholeCounterExample vc_getWholeCounterExample(VC vc) {
 }
 
 Expr vc_getTermFromCounterExample(VC vc, Expr e, WholeCounterExample cc) {
+  bindVC(vc);
   nodestar n = (nodestar)e;
   CompleteCEStar c = (CompleteCEStar)cc;
 
@@ -680,7 +1021,7 @@ int vc_getBVLength(VC vc, Expr ex) {
 /*! The type cannot be a function type. */
 Expr vc_varExpr1(VC vc, const char* name,
                  int indexwidth, int valuewidth) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   node o = b->CreateSymbol(name,indexwidth,valuewidth);
 
@@ -689,12 +1030,12 @@ Expr vc_varExpr1(VC vc, const char* name,
   assert(BVTypeCheck(*output));
 
   //store the decls in a vector for printing purposes
-  decls->push_back(o);
+  context(vc)->addDecl(o);
   return output;
 }
 
 Expr vc_varExpr(VC vc, const char * name, Type type) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)type;
 
   unsigned indexWidth;
@@ -725,14 +1066,14 @@ Expr vc_varExpr(VC vc, const char * name, Type type) {
   assert(BVTypeCheck(*output));
 
   //store the decls in a vector for printing purposes
-  decls->push_back(o);
+  context(vc)->addDecl(o);
   return output;
 }
 
 //! Create an equality expression.  The two children must have the
 //same type.
 Expr vc_eqExpr(VC vc, Expr ccc0, Expr ccc1) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   nodestar a = (nodestar)ccc0;
   nodestar aa = (nodestar)ccc1;
@@ -746,10 +1087,10 @@ Expr vc_eqExpr(VC vc, Expr ccc0, Expr ccc1) {
 }
 
 Expr vc_boolType(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   node output = b->CreateNode(BEEV::BOOLEAN);
-  return persistNode(output);
+  return persistNode(vc, output);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -758,7 +1099,7 @@ Expr vc_boolType(VC vc) {
 // The following functions create Boolean expressions.  The children
 // provided as arguments must be of type Boolean.
 Expr vc_trueExpr(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   node c = b->CreateNode(BEEV::TRUE);
 
   nodestar d = new node(c);
@@ -767,7 +1108,7 @@ Expr vc_trueExpr(VC vc) {
 }
 
 Expr vc_falseExpr(VC vc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   node c = b->CreateNode(BEEV::FALSE);
 
   nodestar d = new node(c);
@@ -776,7 +1117,7 @@ Expr vc_falseExpr(VC vc) {
 }
 
 Expr vc_notExpr(VC vc, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
 
   node o = b->CreateNode(BEEV::NOT,*a);
@@ -788,7 +1129,7 @@ Expr vc_notExpr(VC vc, Expr ccc) {
 }
 
 Expr vc_andExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -801,7 +1142,7 @@ Expr vc_andExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr vc_orExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -813,7 +1154,7 @@ Expr vc_orExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr vc_xorExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -826,7 +1167,7 @@ Expr vc_xorExpr(VC vc, Expr left, Expr right) {
 
 
 Expr vc_andExprN(VC vc, Expr* cc, int n) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar * c = (nodestar *)cc;
   nodelist d;
 
@@ -843,7 +1184,7 @@ Expr vc_andExprN(VC vc, Expr* cc, int n) {
 
 
 Expr vc_orExprN(VC vc, Expr* cc, int n) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar * c = (nodestar *)cc;
   nodelist d;
 
@@ -859,7 +1200,7 @@ Expr vc_orExprN(VC vc, Expr* cc, int n) {
 }
 
 Expr vc_bvPlusExprN(VC vc, int n_bits, Expr* cc, int n) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar * c = (nodestar *)cc;
   nodelist d;
 
@@ -876,7 +1217,7 @@ Expr vc_bvPlusExprN(VC vc, int n_bits, Expr* cc, int n) {
 
 
 Expr vc_iteExpr(VC vc, Expr cond, Expr thenpart, Expr elsepart){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar c = (nodestar)cond;
   nodestar t = (nodestar)thenpart;
   nodestar e = (nodestar)elsepart;
@@ -900,7 +1241,7 @@ Expr vc_iteExpr(VC vc, Expr cond, Expr thenpart, Expr elsepart){
 }
 
 Expr vc_impliesExpr(VC vc, Expr antecedent, Expr consequent){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar c = (nodestar)antecedent;
   nodestar t = (nodestar)consequent;
 
@@ -916,7 +1257,7 @@ Expr vc_impliesExpr(VC vc, Expr antecedent, Expr consequent){
 }
 
 Expr vc_iffExpr(VC vc, Expr e0, Expr e1){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar c = (nodestar)e0;
   nodestar t = (nodestar)e1;
 
@@ -932,7 +1273,7 @@ Expr vc_iffExpr(VC vc, Expr e0, Expr e1){
 }
 
 Expr vc_boolToBVExpr(VC vc, Expr form) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar c = (nodestar)form;
 
   assert(BVTypeCheck(*c));
@@ -954,7 +1295,7 @@ Expr vc_boolToBVExpr(VC vc, Expr form) {
 }
 
 Expr vc_paramBoolExpr(VC vc, Expr boolvar, Expr parameter){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar c = (nodestar)boolvar;
   nodestar t = (nodestar)parameter;
 
@@ -974,7 +1315,7 @@ Expr vc_paramBoolExpr(VC vc, Expr boolvar, Expr parameter){
 // BITVECTOR EXPR Creation methods                                         //
 /////////////////////////////////////////////////////////////////////////////
 Type vc_bvType(VC vc, int num_bits) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   if(!(0 < num_bits))
     {
@@ -985,7 +1326,7 @@ Type vc_bvType(VC vc, int num_bits) {
 
   node e = b->CreateBVConst(32, num_bits);
   node output = (b->CreateNode(BEEV::BITVECTOR,e));
-  return persistNode(output);
+  return persistNode(vc, output);
 }
 
 Type vc_bv32Type(VC vc) {
@@ -996,7 +1337,7 @@ Expr vc_bvConstExprFromDecStr(VC vc,
                               int width, 
                               const char* decimalInput ) 
 {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   std::string str(decimalInput);
   node n = b->CreateBVConst(str, 10, width);
   assert(BVTypeCheck(n));
@@ -1006,7 +1347,7 @@ Expr vc_bvConstExprFromDecStr(VC vc,
 
 
 Expr vc_bvConstExprFromStr(VC vc, const char* binary_repr) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   node n = b->CreateBVConst(binary_repr,2);
   assert(BVTypeCheck(n));
@@ -1018,7 +1359,7 @@ Expr vc_bvConstExprFromStr(VC vc, const char* binary_repr) {
 Expr vc_bvConstExprFromInt(VC vc,
                            int n_bits,
                            unsigned int value) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   unsigned long long int v = (unsigned long long int)value;
   unsigned long long int max_n_bits = 0xFFFFFFFFFFFFFFFFULL >> (64-n_bits);
@@ -1030,13 +1371,13 @@ Expr vc_bvConstExprFromInt(VC vc,
   }
   node n = b->CreateBVConst(n_bits, v);
   assert(BVTypeCheck(n));
-  return persistNode(n);
+  return persistNode(vc, n);
 }
 
 Expr vc_bvConstExprFromLL(VC vc,
                           int n_bits,
                           unsigned long long value) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
 
   node n = b->CreateBVConst(n_bits, value);
   assert(BVTypeCheck(n));
@@ -1046,7 +1387,7 @@ Expr vc_bvConstExprFromLL(VC vc,
 }
 
 Expr vc_bvConcatExpr(VC vc, Expr left, Expr right) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -1062,7 +1403,7 @@ Expr vc_bvConcatExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr createBinaryTerm(VC vc, int n_bits, Kind k, Expr left, Expr right){
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar l = (nodestar)left;
   nodestar r = (nodestar)right;
 
@@ -1123,7 +1464,7 @@ Expr vc_bv32MultExpr(VC vc, Expr left, Expr right) {
 
 Expr createBinaryNode(VC vc, Kind k, Expr left, Expr right)
 {
-    bmstar b = (bmstar)(((stpstar)vc)->bm);
+    bmstar b = bindVC(vc);
     nodestar l = (nodestar)left;
     nodestar r = (nodestar)right;
     assert(BVTypeCheck(*l));
@@ -1180,7 +1521,7 @@ Expr vc_bvSignedRightShiftExprExpr(VC vc,int n_bits, Expr left, Expr right)
 
 
 Expr vc_bvUMinusExpr(VC vc, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
   assert(BVTypeCheck(*a));
 
@@ -1207,7 +1548,7 @@ Expr vc_bvXorExpr(VC vc, Expr left, Expr right) {
 }
 
 Expr vc_bvNotExpr(VC vc, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
 
   assert(BVTypeCheck(*a));
@@ -1219,7 +1560,7 @@ Expr vc_bvNotExpr(VC vc, Expr ccc) {
 }
 
 Expr vc_bvLeftShiftExpr(VC vc, int sh_amt, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
   assert(BVTypeCheck(*a));
 
@@ -1239,7 +1580,7 @@ Expr vc_bvLeftShiftExpr(VC vc, int sh_amt, Expr ccc) {
 }
 
 Expr vc_bvRightShiftExpr(VC vc, int sh_amt, Expr ccc) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
   assert(BVTypeCheck(*a));
 
@@ -1373,7 +1714,7 @@ Expr vc_bvVar32RightShiftExpr(VC vc, Expr sh_amt, Expr child) {
 }
 
 Expr vc_bvExtract(VC vc, Expr ccc, int hi_num, int low_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1387,7 +1728,7 @@ Expr vc_bvExtract(VC vc, Expr ccc, int hi_num, int low_num) {
 }
 
 Expr vc_bvBoolExtract(VC vc, Expr ccc, int bit_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1403,7 +1744,7 @@ Expr vc_bvBoolExtract(VC vc, Expr ccc, int bit_num) {
 }
 
 Expr vc_bvBoolExtract_Zero(VC vc, Expr ccc, int bit_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1419,7 +1760,7 @@ Expr vc_bvBoolExtract_Zero(VC vc, Expr ccc, int bit_num) {
 }
 
 Expr vc_bvBoolExtract_One(VC vc, Expr ccc, int bit_num) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
   BVTypeCheck(*a);
 
@@ -1435,7 +1776,7 @@ Expr vc_bvBoolExtract_One(VC vc, Expr ccc, int bit_num) {
 }
 
 Expr vc_bvSignExtend(VC vc, Expr ccc, int nbits) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar a = (nodestar)ccc;
 
   //width of the expr which is being sign extended. nbits is the
@@ -1507,6 +1848,7 @@ unsigned long long int getBVUnsignedLongLong(Expr e) {
 
 
 Expr vc_simplify(VC vc, Expr e) {
+  bindVC(vc);
   nodestar a = (nodestar)e;
   simpstar simp = (simpstar)(((stpstar)vc)->simp);
 
@@ -1626,7 +1968,8 @@ static char *val_to_binary_str(unsigned nbits, unsigned long long val) {
 #endif
 
 Expr vc_parseExpr(VC vc, const char* infile) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
+  std::lock_guard<std::mutex> guard(parser_lock);
   extern FILE *cvcin, *smtin;
   const char * prog = "stp";
 
@@ -1715,7 +2058,7 @@ void vc_registerErrorHandler(void (*error_hdlr)(const char* err_msg)) {
 int vc_getHashQueryStateToBuffer(VC vc, Expr query) {
   assert(vc);
   assert(query);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   nodestar qry = (nodestar)query;
   BEEV::ASTVec v = b->GetAsserts();
   BEEV::ASTNode out = b->CreateNode(BEEV::AND,b->CreateNode(BEEV::NOT,*qry),v);
@@ -1769,25 +2112,28 @@ void vc_Destroy(VC vc) {
   //     delete aaa;
   //   }
 
-  if (cinterface_exprdelete_on_flag) {
-    for (vector<nodestar>::iterator it = persist.begin(); it!= persist.end();it++)
+  bmstar b = bindVC(vc);
+  CInterfaceVC * ctx = context(vc);
+
+  if (ctx->exprdelete_on_flag) {
+    for (vector<nodestar>::iterator it = ctx->persist.begin(); it!= ctx->persist.end();it++)
       delete *it;
-    persist.clear();
+    ctx->persist.clear();
   }
 
   Cnf_ClearMemory();
 
-  delete decls;
-  delete (stpstar)vc;
+  SimplifyingNodeFactory * simpNF = ctx->simpNF;
+  delete ctx;
   BEEV::GlobalSTP = NULL;
-  delete  BEEV::ParserBM;
+  delete b;
   BEEV::ParserBM = NULL;
   delete simpNF;
 }
 
 void vc_DeleteExpr(Expr e) {
   nodestar input = (nodestar)e;
-  //bmstar b = (bmstar)(((stpstar)vc)->bm);
+  //bmstar b = bindVC(vc);
   delete input;
 }
 
@@ -1830,7 +2176,7 @@ int getIWidth (Expr ex) {
 
 void vc_printCounterExampleFile(VC vc, int fd) {
   fdostream os(fd);
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
   ctrexamplestar ce = (ctrexamplestar)(((stpstar)vc)->Ctr_Example);  
   
   bool currentPrint = b->UserFlags.print_counterexample_flag;
@@ -1873,7 +2219,8 @@ int smt_scan_string(const char *yy_str);
 int cvc_scan_string(const char *yy_str);
 
 int vc_parseMemExpr(VC vc, const char* s, Expr* oquery, Expr* oasserts ) {
-  bmstar b = (bmstar)(((stpstar)vc)->bm);
+  bmstar b = bindVC(vc);
+  std::lock_guard<std::mutex> guard(parser_lock);
 
 #if 0
  BEEV::GlobalSTP = (stpstar)vc;
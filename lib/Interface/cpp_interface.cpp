@@ -314,8 +314,6 @@ namespace BEEV
     if (symbols.size() == 1)
       FatalError("Can't pop away the default base element.");
 
-    bm.Pop();
-
     // These tables might hold references to symbols that have been
     // removed.
     resetSolver();
@@ -326,6 +324,10 @@ namespace BEEV
       letMgr->_parser_symbol_table.erase(current[i]);
 
     symbols.erase(symbols.end() - 1);
+
+    // Last, so that the references above are gone, and the nodes made
+    // in this context can be reclaimed.
+    bm.Pop();
     checkInvariant();
   }
 
@@ -43,15 +43,15 @@ static string tolower(const char * name)
 
 
 	//Map from ASTNodes to LetVars
-	BEEV::ASTNodeMap NodeLetVarMap;
+	thread_local BEEV::ASTNodeMap NodeLetVarMap;
 
 	//This is a vector which stores the Node to LetVars pairs. It
 	//allows for sorted printing, as opposed to NodeLetVarMap
-	std::vector<pair<ASTNode, ASTNode> > NodeLetVarVec;
+	thread_local std::vector<pair<ASTNode, ASTNode> > NodeLetVarVec;
 
 	//a partial Map from ASTNodes to LetVars. Needed in order to
 	//correctly print shared subterms inside the LET itself
-	BEEV::ASTNodeMap NodeLetVarMap1;
+	thread_local BEEV::ASTNodeMap NodeLetVarMap1;
 
 	  // copied from Presentation Langauge printer.
 	  ostream& SMTLIB_Print(ostream &os, const ASTNode n, const int indentation, void (*SMTLIB1_Print1)(ostream&, const ASTNode , int , bool ), bool smtlib1)
@@ -0,0 +1,112 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#include "stp/STPManager/DifficultyModel.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace BEEV
+{
+  DifficultyModel::DifficultyModel()
+  {
+    // These scores are approximately the number of AIG nodes created when
+    // no input values are known.
+    for (int k = 0; k < numberOfKinds; k++)
+      set((Kind) k, 1, 0);
+
+    set(BVMULT, 0, 5);
+    set(BVMOD, 0, 15);
+    set(BVDIV, 0, 20);
+    set(SBVDIV, 0, 20);
+    set(SBVREM, 0, 20);
+    set(SBVMOD, 0, 20);
+
+    // no harder.
+    set(BVCONCAT, 0, 0);
+    set(BVEXTRACT, 0, 0);
+    set(NOT, 0, 0);
+
+    // We convert subtract to a + (-b), we want the difficulty scores to be same.
+    set(BVSUB, 1.5, 0);
+  }
+
+  bool
+  DifficultyModel::kindFromName(const std::string& name, Kind& k)
+  {
+    for (int i = 0; i < numberOfKinds; i++)
+      if (name == _kind_names[i])
+        {
+          k = (Kind) i;
+          return true;
+        }
+    return false;
+  }
+
+  bool
+  DifficultyModel::read(std::istream& in)
+  {
+    struct Entry
+    {
+      Kind k;
+      double l, q;
+    };
+    std::vector<Entry> entries;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name) || name[0] == '#')
+          continue;
+
+        Entry e;
+        if (!kindFromName(name, e.k) || !(fields >> e.l >> e.q))
+          return false;
+        entries.push_back(e);
+      }
+
+    for (size_t i = 0; i < entries.size(); i++)
+      set(entries[i].k, entries[i].l, entries[i].q);
+    return true;
+  }
+
+  bool
+  DifficultyModel::load(const std::string& fileName)
+  {
+    std::ifstream in(fileName.c_str());
+    return in && read(in);
+  }
+
+  void
+  DifficultyModel::write(std::ostream& out) const
+  {
+    const std::streamsize precision = out.precision(10);
+    out << "# kind linear quadratic" << std::endl;
+    for (int k = 0; k < numberOfKinds; k++)
+      out << _kind_names[k] << " " << linear[k] << " " << quadratic[k] << std::endl;
+    out.precision(precision);
+  }
+}
@@ -0,0 +1,168 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#include <ctime>
+#include <sstream>
+#include <iomanip>
+#include "stp/STPManager/PassManager.h"
+#include "stp/STPManager/STPManager.h"
+
+namespace BEEV
+{
+  PassManager::PassManager(STPMgr* _bm) :
+    bm(_bm), minimumYield(0)
+  {
+  }
+
+  void PassManager::add(const std::string& name, Pass pass, Condition enabled)
+  {
+    Entry e;
+    e.name = name;
+    e.run = pass;
+    e.enabled = enabled;
+    e.runs = e.changes = e.skipped = 0;
+    e.seconds = 0;
+    e.nodesRemoved = e.difficultyRemoved = 0;
+    e.recentYield = 0;
+    pipeline.push_back(passes.size());
+    passes.push_back(e);
+  }
+
+  void PassManager::setPipeline(const std::string& names)
+  {
+    if (names.empty())
+      {
+        pipeline.clear();
+        for (size_t i = 0; i < passes.size(); i++)
+          pipeline.push_back(i);
+        return;
+      }
+
+    std::vector<size_t> result;
+    std::istringstream in(names);
+    std::string name;
+    while (std::getline(in, name, ','))
+      {
+        size_t i = 0;
+        while (i < passes.size() && passes[i].name != name)
+          i++;
+        if (i == passes.size())
+          FatalError(("PassManager: unknown pass in pipeline: " + name).c_str());
+        result.push_back(i);
+      }
+    pipeline = result;
+  }
+
+  void PassManager::setMinimumYield(double yield)
+  {
+    minimumYield = yield;
+  }
+
+  ASTNode PassManager::runPass(Entry& e, const ASTNode& input, bool inFixedPoint)
+  {
+    if (e.enabled && !e.enabled())
+      return input;
+
+    // Nothing has changed since the pass last ran.
+    if (input == e.unchanged)
+      return input;
+
+    // A minimum yield of zero never skips, so that measuring the yield
+    // for the statistics can't change which passes run.
+    if (inFixedPoint && minimumYield > 0 && e.runs >= 2 && e.recentYield < minimumYield)
+      {
+        e.skipped++;
+        return input;
+      }
+
+    const std::clock_t start = std::clock();
+    ASTNode output = e.run(input);
+    e.seconds += double(std::clock() - start) / CLOCKS_PER_SEC;
+    e.runs++;
+
+    double yield = 0;
+    if (output == input)
+      e.unchanged = input;
+    else
+      {
+        e.changes++;
+
+        // Measuring is a traversal each, so is only done when the
+        // numbers are wanted.
+        if (bm->UserFlags.stats_flag || minimumYield != 0)
+          {
+            const long before = difficulty.score(input);
+            const long removed = before - difficulty.score(output);
+            e.difficultyRemoved += removed;
+            if (before > 0)
+              yield = double(removed) / before;
+          }
+        if (bm->UserFlags.stats_flag)
+          e.nodesRemoved += (long) bm->NodeSize(input) - (long) bm->NodeSize(output);
+      }
+
+    e.recentYield = (e.runs == 1) ? yield : (e.recentYield + yield) / 2;
+    return output;
+  }
+
+  ASTNode PassManager::runOnce(const ASTNode& input)
+  {
+    ASTNode result = input;
+    for (size_t i = 0; i < pipeline.size(); i++)
+      result = runPass(passes[pipeline[i]], result, false);
+    return result;
+  }
+
+  ASTNode PassManager::runToFixedPoint(const ASTNode& input)
+  {
+    ASTNode result = input;
+    while (true)
+      {
+        if (bm->soft_timeout_expired)
+          return result;
+
+        const ASTNode last = result;
+        for (size_t i = 0; i < pipeline.size(); i++)
+          result = runPass(passes[pipeline[i]], result, true);
+        if (result == last)
+          return result;
+      }
+  }
+
+  void PassManager::printStats(std::ostream& os) const
+  {
+    os << "Pass statistics (runs, changes, skipped, seconds, nodes removed, difficulty removed):" << std::endl;
+    for (size_t i = 0; i < passes.size(); i++)
+      {
+        const Entry& e = passes[i];
+        if (e.runs == 0 && e.skipped == 0)
+          continue;
+        os << "  " << std::left << std::setw(24) << e.name << std::right
+           << " " << e.runs << " " << e.changes << " " << e.skipped
+           << " " << std::fixed << std::setprecision(3) << e.seconds
+           << " " << e.nodesRemoved << " " << e.difficultyRemoved << std::endl;
+      }
+    os.unsetf(std::ios::floatfield);
+  }
+} // end namespace BEEV
@@ -24,6 +24,7 @@ THE SOFTWARE.
 
 #include "stp/STPManager/STP.h"
 #include "stp/STPManager/DifficultyScore.h"
+#include "stp/STPManager/NodeIterator.h"
 #include "stp/ToSat/AIG/ToSATAIG.h"
 #include "stp/Simplifier/constantBitP/ConstantBitPropagation.h"
 #include "stp/Simplifier/constantBitP/NodeToFixedBitsMap.h"
@@ -40,10 +41,19 @@ THE SOFTWARE.
 #include "stp/Simplifier/RemoveUnconstrained.h"
 #include "stp/Simplifier/FindPureLiterals.h"
 #include "stp/Simplifier/EstablishIntervals.h"
+#include "stp/Simplifier/NarrowWidths.h"
 #include "stp/Simplifier/UseITEContext.h"
 #include "stp/Simplifier/AlwaysTrue.h"
 #include "stp/Simplifier/AIGSimplifyPropositionalCore.h"
+#include "stp/Simplifier/VariablesInExpression.h"
 #include <memory>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
 
 namespace BEEV {
 
@@ -55,6 +65,7 @@ namespace BEEV {
   const  static string bitvec_message =  "After Bit-vector Solving. ";
   const  static string size_inc_message= "After Speculative Simplifications. ";
   const  static string pe_message=       "After Propagating Equalities. ";
+  const  static string nw_message=       "After Narrowing Widths. ";
 
 
 
@@ -76,10 +87,33 @@ namespace BEEV {
     else
       original_input = inputasserts;
 
+    SATSolver *newS = newSATSolver();
+    SATSolver& NewSolver = *newS;
+
+	SOLVER_RETURN_TYPE result;
+    result = TopLevelSTPAux(NewSolver,
+			      original_input);
+
+    delete newS;
+
+    bm->UserFlags.ackermannisation =saved_ack;
+    return result;
+
+  } //End of TopLevelSTP()
+
+  SATSolver*
+  STP::newSATSolver()
+  {
+    return newSATSolver(bm->soft_timeout_expired);
+  }
+
+  SATSolver*
+  STP::newSATSolver(volatile bool& interrupt)
+  {
     SATSolver *newS = NULL;
     switch(bm->UserFlags.solver_to_use) {
         case UserDefinedFlags::SIMPLIFYING_MINISAT_SOLVER:
-            newS = new SimplifyingMinisat(bm->soft_timeout_expired);
+            newS = new SimplifyingMinisat(interrupt);
             break;
         case UserDefinedFlags::CRYPTOMINISAT_SOLVER:
             newS = new CryptoMinisat;
@@ -94,10 +128,10 @@ namespace BEEV {
             #endif
             break;
         case UserDefinedFlags::MINISAT_SOLVER:
-            newS = new MinisatCore<Minisat::Solver>(bm->soft_timeout_expired);
+            newS = new MinisatCore<Minisat::Solver>(interrupt);
             break;
         case UserDefinedFlags::MINISAT_PROPAGATORS:
-            newS = new MinisatCore_prop<Minisat::Solver_prop>(bm->soft_timeout_expired);
+            newS = new MinisatCore_prop<Minisat::Solver_prop>(interrupt);
             break;
         default:
             std::cerr << "ERROR: Undefined solver to use." << endl;
@@ -105,40 +139,24 @@ namespace BEEV {
             break;
     };
 
-    SATSolver& NewSolver = *newS;
-
 
     if(bm->UserFlags.stats_flag)
       {
-	NewSolver.setVerbosity(1);
+	newS->setVerbosity(1);
       }
     
     if(bm->UserFlags.random_seed_flag)
       {
-        NewSolver.setSeed(bm->UserFlags.random_seed);
+        newS->setSeed(bm->UserFlags.random_seed);
       }
 
-	SOLVER_RETURN_TYPE result;
-    result = TopLevelSTPAux(NewSolver,
-			      original_input);
-
-    delete newS;
-
-    bm->UserFlags.ackermannisation =saved_ack;
-    return result;
-
-  } //End of TopLevelSTP()
+    return newS;
+  }
   
   ASTNode
-  STP::callSizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe, const int initial_difficulty_score, int & actualBBSize)
+  STP::callSizeReducing(ASTNode simplified_solved_InputToSAT, PassManager& sizeReducing, const int initial_difficulty_score, int & actualBBSize)
   {
-    while (true)
-      {
-        ASTNode last = simplified_solved_InputToSAT;
-        simplified_solved_InputToSAT = sizeReducing(last, bvSolver,pe);
-        if (last == simplified_solved_InputToSAT)
-          break;
-      }
+    simplified_solved_InputToSAT = sizeReducing.runToFixedPoint(simplified_solved_InputToSAT);
 
     actualBBSize=-1;
 
@@ -177,80 +195,512 @@ namespace BEEV {
 
 
   // These transformations should never increase the size of the DAG.
-   ASTNode
-  STP::sizeReducing(ASTNode simplified_solved_InputToSAT, BVSolver* bvSolver, PropagateEqualities *pe)
+  // They're run in this order unless the "pipeline" option gives
+  // another.
+  void
+  STP::addSizeReducingPasses(PassManager& passes, BVSolver* bvSolver, PropagateEqualities *pe)
   {
-
-    simplified_solved_InputToSAT = pe->topLevel(simplified_solved_InputToSAT, arrayTransformer);
-    if (simp->hasUnappliedSubstitutions())
+    passes.add("propagate-equalities", [=](const ASTNode& in)
       {
-        simplified_solved_InputToSAT = simp->applySubstitutionMap(simplified_solved_InputToSAT);
-        simp->haveAppliedSubstitutionMap();
-        bm->ASTNodeStats(pe_message.c_str(), simplified_solved_InputToSAT);
-      }
+        ASTNode out = pe->topLevel(in, arrayTransformer);
+        if (simp->hasUnappliedSubstitutions())
+          {
+            out = simp->applySubstitutionMap(out);
+            simp->haveAppliedSubstitutionMap();
+            bm->ASTNodeStats(pe_message.c_str(), out);
+          }
+        return out;
+      });
 
-    if (bm->UserFlags.isSet("enable-unconstrained", "1"))
+    passes.add("remove-unconstrained", [=](const ASTNode& in)
       {
-        // Remove unconstrained.
         RemoveUnconstrained r1(*bm);
-        simplified_solved_InputToSAT = r1.topLevel(simplified_solved_InputToSAT, simp);
-        bm->ASTNodeStats(uc_message.c_str(), simplified_solved_InputToSAT);
-      }
+        ASTNode out = r1.topLevel(in, simp);
+        bm->ASTNodeStats(uc_message.c_str(), out);
+        return out;
+      },
+      [=]() { return bm->UserFlags.isSet("enable-unconstrained", "1"); });
 
-    if (bm->UserFlags.isSet("use-intervals", "1"))
+    passes.add("intervals", [=](const ASTNode& in)
       {
         EstablishIntervals intervals(*bm);
-        simplified_solved_InputToSAT = intervals.topLevel_unsignedIntervals(simplified_solved_InputToSAT);
-        bm->ASTNodeStats(int_message.c_str(), simplified_solved_InputToSAT);
-      }
+        ASTNode out = intervals.topLevel_unsignedIntervals(in);
+        bm->ASTNodeStats(int_message.c_str(), out);
+        return out;
+      },
+      [=]() { return bm->UserFlags.isSet("use-intervals", "1"); });
 
-    if (bm->UserFlags.bitConstantProp_flag)
+    passes.add("constant-bits", [=](const ASTNode& in)
       {
         bm->GetRunTimes()->start(RunTimes::ConstantBitPropagation);
-        simplifier::constantBitP::ConstantBitPropagation cb(simp, bm->defaultNodeFactory, simplified_solved_InputToSAT);
-        simplified_solved_InputToSAT = cb.topLevelBothWays(simplified_solved_InputToSAT, true,false);
+        simplifier::constantBitP::ConstantBitPropagation cb(simp, bm->defaultNodeFactory, in, assertedFixedBits.get());
+        ASTNode out = cb.topLevelBothWays(in, true,false);
 
         bm->GetRunTimes()->stop(RunTimes::ConstantBitPropagation);
 
         if (cb.isUnsatisfiable())
-          simplified_solved_InputToSAT = bm->ASTFalse;
+          out = bm->ASTFalse;
 
         if (simp->hasUnappliedSubstitutions())
           {
-          simplified_solved_InputToSAT = simp->applySubstitutionMap(simplified_solved_InputToSAT);
+          out = simp->applySubstitutionMap(out);
           simp->haveAppliedSubstitutionMap();
           }
 
-        bm->ASTNodeStats(cb_message.c_str(), simplified_solved_InputToSAT);
-      }
+        bm->ASTNodeStats(cb_message.c_str(), out);
+        return out;
+      },
+      [=]() { return bm->UserFlags.bitConstantProp_flag; });
 
-    // Find pure literals.
-    if (bm->UserFlags.isSet("pure-literals", "1"))
+    passes.add("pure-literals", [=](const ASTNode& in)
       {
         FindPureLiterals fpl;
-        bool changed = fpl.topLevel(simplified_solved_InputToSAT, simp, bm);
-        if (changed)
+        ASTNode n = in;
+        bool changed = fpl.topLevel(n, simp, bm);
+        if (!changed)
+          return n;
+
+        ASTNode out = simp->applySubstitutionMap(n);
+        simp->haveAppliedSubstitutionMap();
+        bm->ASTNodeStats(pl_message.c_str() , out);
+        return out;
+      },
+      [=]() { return bm->UserFlags.isSet("pure-literals", "1"); });
+
+    passes.add("always-true", [=](const ASTNode& in)
+      {
+        AlwaysTrue always (simp,bm,bm->defaultNodeFactory);
+        ASTNode n = in;
+        ASTNode out = always.topLevel(n);
+        bm->ASTNodeStats("After removing always true: ", out);
+        return out;
+      },
+      [=]() { return bm->UserFlags.isSet("always-true", "0"); });
+
+    passes.add("bv-solver", [=](const ASTNode& in)
+      {
+        ASTNode out = bvSolver->TopLevelBVSolve(in, false);
+        bm->ASTNodeStats(bitvec_message.c_str(), out);
+        return out;
+      },
+      [=]() { return bm->UserFlags.wordlevel_solve_flag && bm->UserFlags.optimize_flag; });
+
+    passes.setPipeline(bm->UserFlags.get("pipeline", ""));
+    passes.setMinimumYield(atof(bm->UserFlags.get("pass-min-yield", "0").c_str()));
+  }
+
+  ASTNode
+  STP::simplifyRound(const ASTNode& input, BVSolver* bvSolver, PropagateEqualities *pe)
+  {
+    ASTNode simplified = input;
+
+    if (bm->UserFlags.optimize_flag)
+      {
+        simplified = pe->topLevel(simplified, arrayTransformer);
+
+        // Imagine:
+        // The simplifier simplifies (0 + T) to T
+        // Then bvsolve introduces (0 + T)
+        // Then CreateSubstitutionMap decides T maps to a constant, but leaving another (0+T).
+        // When we go to simplify (0 + T) will still be in the simplify cache, so will be mapped to T.
+        // But it shouldn't be T, it should be a constant.
+        // Applying the substitution map fixes this case.
+        //
+        if (simp->hasUnappliedSubstitutions())
           {
-            simplified_solved_InputToSAT = simp->applySubstitutionMap(simplified_solved_InputToSAT);
+            simplified = simp->applySubstitutionMap(simplified);
             simp->haveAppliedSubstitutionMap();
-            bm->ASTNodeStats(pl_message.c_str() , simplified_solved_InputToSAT);
           }
+
+        bm->ASTNodeStats(pe_message.c_str(), simplified);
+
+        simplified = simp->SimplifyFormula_TopLevel(simplified, false);
+
+        bm->ASTNodeStats(size_inc_message.c_str(), simplified);
       }
 
-    if (bm->UserFlags.isSet("always-true", "0"))
+    if (bm->UserFlags.wordlevel_solve_flag && bm->UserFlags.optimize_flag)
       {
-        AlwaysTrue always (simp,bm,bm->defaultNodeFactory);
-        simplified_solved_InputToSAT = always.topLevel(simplified_solved_InputToSAT);
-        bm->ASTNodeStats("After removing always true: ", simplified_solved_InputToSAT);
+        simplified = bvSolver->TopLevelBVSolve(simplified);
+        bm->ASTNodeStats(bitvec_message.c_str(), simplified);
       }
 
-    if (bm->UserFlags.wordlevel_solve_flag && bm->UserFlags.optimize_flag)
+    return simplified;
+  }
+
+  // Appends the conjuncts of the top level AND of n.
+  static void
+  topLevelConjuncts(const ASTNode& n, ASTVec& out)
+  {
+    if (n.GetKind() == AND)
+      out.insert(out.end(), n.GetChildren().begin(), n.GetChildren().end());
+    else if (n != n.GetSTPMgr()->ASTTrue)
+      out.push_back(n);
+  }
+
+  static ASTNode
+  conjoin(STPMgr* bm, const ASTVec& conjuncts)
+  {
+    if (conjuncts.empty())
+      return bm->ASTTrue;
+    if (conjuncts.size() == 1)
+      return conjuncts[0];
+    return bm->CreateNode(AND, conjuncts);
+  }
+
+  namespace
+  {
+    // The conjuncts that the last round left alone, indexed by the
+    // symbols they contain, so that when something is substituted
+    // for, the conjuncts that it appears in can be found.
+    class SettledConjuncts
+    {
+      STPMgr* bm;
+      ASTVec conjuncts; // ASTUndefined once woken.
+      hash_map<ASTNode, std::vector<size_t>, ASTNode::ASTNodeHasher, ASTNode::ASTNodeEqual> bySymbol;
+
+    public:
+      explicit SettledConjuncts(STPMgr* _bm) :
+        bm(_bm)
       {
-        simplified_solved_InputToSAT = bvSolver->TopLevelBVSolve(simplified_solved_InputToSAT, false);
-        bm->ASTNodeStats(bitvec_message.c_str(), simplified_solved_InputToSAT);
       }
 
-    return simplified_solved_InputToSAT;
+      void
+      add(const ASTNode& c)
+      {
+        const size_t i = conjuncts.size();
+        conjuncts.push_back(c);
+        NodeIterator ni(c, bm->ASTUndefined, *bm);
+        ASTNode current;
+        while ((current = ni.next()) != ni.end())
+          if (current.GetKind() == SYMBOL)
+            bySymbol[current].push_back(i);
+      }
+
+      // Moves the conjuncts that contain a symbol in key to woken.
+      void
+      wake(const ASTNode& key, ASTVec& woken)
+      {
+        NodeIterator ni(key, bm->ASTUndefined, *bm);
+        ASTNode current;
+        while ((current = ni.next()) != ni.end())
+          {
+            if (current.GetKind() != SYMBOL)
+              continue;
+            hash_map<ASTNode, std::vector<size_t>, ASTNode::ASTNodeHasher, ASTNode::ASTNodeEqual>::iterator it =
+                bySymbol.find(current);
+            if (it == bySymbol.end())
+              continue;
+            for (size_t j = 0; j < it->second.size(); j++)
+              {
+                ASTNode& c = conjuncts[it->second[j]];
+                if (c != bm->ASTUndefined)
+                  {
+                    woken.push_back(c);
+                    c = bm->ASTUndefined;
+                  }
+              }
+            bySymbol.erase(it);
+          }
+      }
+
+      void
+      getAll(ASTVec& out) const
+      {
+        for (size_t i = 0; i < conjuncts.size(); i++)
+          if (conjuncts[i] != bm->ASTUndefined)
+            out.push_back(conjuncts[i]);
+      }
+    };
+  }
+
+  ASTNode
+  STP::simplifyToFixedPoint(const ASTNode& input, BVSolver* bvSolver, PropagateEqualities *pe)
+  {
+    const bool incremental = bm->UserFlags.optimize_flag && bm->UserFlags.isSet("incremental-fixpoint", "1")
+        && input.GetKind() == AND && input.Degree() >= 32;
+
+    if (!incremental)
+      {
+        ASTNode result = input;
+        ASTNode last;
+        do
+          {
+            last = result;
+            if (bm->soft_timeout_expired)
+              return result;
+            result = simplifyRound(result, bvSolver, pe);
+          }
+        while (last != result);
+        return result;
+      }
+
+    // The first round is over the whole formula. After that, each
+    // round works on just the "active" conjuncts: those that the
+    // previous round changed, and those that contain something that has
+    // since been substituted for. It's a fixed point once there aren't
+    // any. This can miss simplifications that only need several
+    // conjuncts together, none of which changed, but the whole-formula
+    // round that would have found them is the one that's saved.
+    SettledConjuncts settled(bm);
+    ASTVec active;
+    topLevelConjuncts(input, active);
+    size_t keysSeen = simp->getSubstitutedKeys().size();
+
+    while (!active.empty())
+      {
+        if (bm->soft_timeout_expired)
+          break;
+
+        const ASTNode result = simplifyRound(conjoin(bm, active), bvSolver, pe);
+        if (result == bm->ASTFalse)
+          return result;
+
+        const ASTNodeSet before(active.begin(), active.end());
+        ASTVec conjuncts;
+        topLevelConjuncts(result, conjuncts);
+        active.clear();
+        for (size_t i = 0; i < conjuncts.size(); i++)
+          if (before.find(conjuncts[i]) != before.end())
+            settled.add(conjuncts[i]);
+          else
+            active.push_back(conjuncts[i]);
+
+        ASTVec woken;
+        const ASTVec& keys = simp->getSubstitutedKeys();
+        assert(keysSeen <= keys.size());
+        for (; keysSeen < keys.size(); keysSeen++)
+          settled.wake(keys[keysSeen], woken);
+
+        // The map has already been applied to the active conjuncts.
+        if (!woken.empty())
+          topLevelConjuncts(simp->applySubstitutionMap(conjoin(bm, woken)), active);
+      }
+
+    settled.getAll(active);
+    return conjoin(bm, active);
+  }
+
+  static size_t
+  findRoot(std::vector<size_t>& parent, size_t i)
+  {
+    while (parent[i] != i)
+      i = parent[i] = parent[parent[i]];
+    return i;
+  }
+
+  // The conjuncts of n, looking through nested ANDs.
+  static void
+  flattenConjuncts(const ASTNode& n, ASTVec& out, ASTNodeSet& seen)
+  {
+    if (n.GetKind() != AND)
+      topLevelConjuncts(n, out);
+    else if (seen.insert(n).second)
+      for (size_t i = 0; i < n.Degree(); i++)
+        flattenConjuncts(n[i], out, seen);
+  }
+
+  // Splits the top level AND into groups of conjuncts that share no
+  // symbols.
+  static void
+  independentComponents(STPMgr* bm, const ASTNode& formula, std::vector<ASTVec>& components)
+  {
+    // The simplifications can leave a conjunction nested inside the
+    // top AND, which would otherwise always be one group.
+    ASTVec conjuncts;
+    ASTNodeSet seen;
+    flattenConjuncts(formula, conjuncts, seen);
+
+    // Union-find over the conjuncts, joining those with a symbol in common.
+    std::vector<size_t> parent(conjuncts.size());
+    for (size_t i = 0; i < parent.size(); i++)
+      parent[i] = i;
+
+    VariablesInExpression vars;
+    hash_map<ASTNode, size_t, ASTNode::ASTNodeHasher, ASTNode::ASTNodeEqual> firstUse;
+    for (size_t i = 0; i < conjuncts.size(); i++)
+      {
+        bool destruct;
+        ASTNodeSet* symbols = vars.SetofVarsSeenInTerm(conjuncts[i], destruct);
+        for (ASTNodeSet::const_iterator it = symbols->begin(); it != symbols->end(); it++)
+          {
+            const size_t j = firstUse.insert(std::make_pair(*it, i)).first->second;
+            parent[findRoot(parent, i)] = findRoot(parent, j);
+          }
+        if (destruct)
+          delete symbols;
+      }
+
+    hash_map<size_t, size_t> componentOf;
+    for (size_t i = 0; i < conjuncts.size(); i++)
+      {
+        const size_t root = findRoot(parent, i);
+        if (componentOf.find(root) == componentOf.end())
+          {
+            componentOf[root] = components.size();
+            components.push_back(ASTVec());
+          }
+        components[componentOf[root]].push_back(conjuncts[i]);
+      }
+  }
+
+  SOLVER_RETURN_TYPE
+  STP::solveComponents(const std::vector<ASTNode>& components, const ASTNode& original_input)
+  {
+    const size_t n = components.size();
+
+    // Smallest first, so that an unsatisfiable one is likely to be
+    // found before much time is spent on the others.
+    std::vector<std::pair<unsigned, size_t> > bySize;
+    for (size_t i = 0; i < n; i++)
+      bySize.push_back(std::make_pair(bm->NodeSize(components[i]), i));
+    std::sort(bySize.begin(), bySize.end());
+
+    const int threads = std::min<int>(atoi(bm->UserFlags.get("component-threads", "1").c_str()), (int)n);
+
+    // When the components are solved on several threads, the solvers
+    // watch this rather than the soft timeout, so that they can be
+    // stopped as soon as one of them is unsatisfiable.
+    volatile bool stop = false;
+    volatile bool& interrupt = (threads > 1) ? stop : bm->soft_timeout_expired;
+
+    std::vector<SATSolver*> solvers;
+    std::vector<ToSATBase*> tosats;
+    std::vector<simplifier::constantBitP::ConstantBitPropagation*> cbs;
+    SOLVER_RETURN_TYPE result = SOLVER_UNDECIDED;
+
+    for (size_t k = 0; k < n && result == SOLVER_UNDECIDED; k++)
+      {
+        const ASTNode& component = components[bySize[k].second];
+
+        if (bm->soft_timeout_expired)
+          {
+            result = SOLVER_TIMEOUT;
+            break;
+          }
+
+        simplifier::constantBitP::ConstantBitPropagation* cb = NULL;
+        if (bm->UserFlags.bitConstantProp_flag)
+          {
+            bm->GetRunTimes()->start(RunTimes::ConstantBitPropagation);
+            cb = new simplifier::constantBitP::ConstantBitPropagation(simp, bm->defaultNodeFactory, component,
+                assertedFixedBits.get());
+            bm->GetRunTimes()->stop(RunTimes::ConstantBitPropagation);
+          }
+
+        ToSATAIG* tosat = new ToSATAIG(bm, cb, arrayTransformer);
+        solvers.push_back(newSATSolver(interrupt));
+        tosats.push_back(tosat);
+        cbs.push_back(cb);
+
+        if ((cb != NULL && cb->isUnsatisfiable()) || component == bm->ASTFalse)
+          result = SOLVER_VALID;
+        else if (component != bm->ASTTrue)
+          {
+            tosat->Encode(*solvers.back(), component, false);
+            if (!solvers.back()->okay())
+              result = SOLVER_VALID;
+          }
+      }
+
+    if (result == SOLVER_UNDECIDED)
+      {
+        // Each thread takes the next unsolved component, until there are
+        // none left, or one is unsatisfiable.
+        std::atomic<size_t> next(0);
+        std::atomic<bool> unsatisfiable(false);
+        auto work = [&]()
+          {
+            size_t i;
+            while (!unsatisfiable && (i = next++) < solvers.size())
+              {
+                solvers[i]->solve();
+                if (!solvers[i]->okay())
+                  {
+                    unsatisfiable = true;
+                    stop = true;
+                  }
+              }
+          };
+
+        bm->GetRunTimes()->start(RunTimes::Solving);
+        if (threads <= 1)
+          work();
+        else
+          {
+            std::mutex lock;
+            std::condition_variable finished;
+            int running = threads;
+            std::vector<std::thread> pool;
+            for (int t = 0; t < threads; t++)
+              pool.push_back(std::thread([&]()
+                {
+                  work();
+                  std::lock_guard<std::mutex> guard(lock);
+                  running--;
+                  finished.notify_one();
+                }));
+
+            // Passes the soft timeout on to the solvers.
+            {
+              std::unique_lock<std::mutex> guard(lock);
+              while (running > 0)
+                if (!finished.wait_for(guard, std::chrono::milliseconds(10), [&]() { return running == 0; })
+                    && bm->soft_timeout_expired)
+                  stop = true;
+            }
+
+            for (int t = 0; t < threads; t++)
+              pool[t].join();
+          }
+        bm->GetRunTimes()->stop(RunTimes::Solving);
+
+        // An unsatisfiable component settles it, even if time ran out
+        // while the others were being stopped.
+        if (unsatisfiable)
+          result = SOLVER_VALID;
+        else if (bm->soft_timeout_expired)
+          result = SOLVER_TIMEOUT;
+        else
+          result = Ctr_Example->CallSAT_ResultCheck(solvers, tosats, original_input);
+      }
+
+    for (size_t i = 0; i < solvers.size(); i++)
+      {
+        // Encoding deletes the constant bit propagator.
+        if (!static_cast<ToSATAIG*>(tosats[i])->cbIsDestructed())
+          delete cbs[i];
+        delete tosats[i];
+        delete solvers[i];
+      }
+
+    return result;
+  }
+
+  // Appends a line to the calibration log: the predicted difficulty
+  // of the formula that was bit-blasted, what it really cost, and the
+  // totals of the features of each kind, which fit_difficulty fits
+  // the model's coefficients to.
+  static void
+  logDifficulty(const string& fileName, const ASTNode& formula, const ToSATAIG& tosat)
+  {
+    if (tosat.aigNodes == -1)
+      return;
+
+    std::ofstream log(fileName.c_str(), std::ios::app);
+    if (!log)
+      FatalError("Can't open the difficulty log");
+
+    DifficultyScore difficulty;
+    log << "score:" << difficulty.score(formula) << "\taig:" << tosat.aigNodes << "\tcnf_vars:" << tosat.cnfVars
+        << "\tcnf_clauses:" << tosat.cnfClauses << "\tsolve_ms:" << 1000 * tosat.solveSeconds;
+
+    std::map<Kind, std::pair<double, double> > totals;
+    DifficultyScore::totals(formula, totals);
+    for (std::map<Kind, std::pair<double, double> >::const_iterator it = totals.begin(); it != totals.end(); it++)
+      if (it->second.first != 0 || it->second.second != 0)
+        log << "\t" << it->first << ":" << it->second.first << "," << it->second.second;
+    log << endl;
   }
 
   //Acceps a query, calls the SAT solver and generates Valid/InValid.
@@ -293,8 +743,11 @@ namespace BEEV {
     if (removed)
       assert(!arrayops);
 
+    PassManager sizeReducing(bm);
+    addSizeReducingPasses(sizeReducing, bvSolver.get(), pe.get());
+
     // Run size reducing just once.
-    simplified_solved_InputToSAT = sizeReducing(simplified_solved_InputToSAT, bvSolver.get(),pe.get());
+    simplified_solved_InputToSAT = sizeReducing.runOnce(simplified_solved_InputToSAT);
 
     unsigned initial_difficulty_score = difficulty.score(simplified_solved_InputToSAT);
 
@@ -304,7 +757,10 @@ namespace BEEV {
     // Currently we discards all the state each time sizeReducing is called,
     // so it's expensive to call.
     if ((!arrayops && initial_difficulty_score < 1000000) || bm->UserFlags.isSet("preserving-fixedpoint", "0"))
-           simplified_solved_InputToSAT = callSizeReducing(simplified_solved_InputToSAT, bvSolver.get(),pe.get(), initial_difficulty_score, bitblasted_difficulty);
+           simplified_solved_InputToSAT = callSizeReducing(simplified_solved_InputToSAT, sizeReducing, initial_difficulty_score, bitblasted_difficulty);
+
+    if (bm->UserFlags.stats_flag)
+      sizeReducing.printStats(cerr);
 
     if ((!arrayops || bm->UserFlags.isSet("array-difficulty-reversion", "1")))
       {
@@ -337,55 +793,24 @@ namespace BEEV {
     //bm->Begin_RemoveWrites = false;
     //bm->start_abstracting = false;
     bm->TermsAlreadySeenMap_Clear();
-    do
-      {
-        inputToSAT = simplified_solved_InputToSAT;
-
-        if (bm->soft_timeout_expired)
-            return SOLVER_TIMEOUT;
-
-        if (bm->UserFlags.optimize_flag)
-          {
-            simplified_solved_InputToSAT = pe->topLevel(simplified_solved_InputToSAT, arrayTransformer);
-
-            // Imagine:
-            // The simplifier simplifies (0 + T) to T
-            // Then bvsolve introduces (0 + T)
-            // Then CreateSubstitutionMap decides T maps to a constant, but leaving another (0+T).
-            // When we go to simplify (0 + T) will still be in the simplify cache, so will be mapped to T.
-            // But it shouldn't be T, it should be a constant.
-            // Applying the substitution map fixes this case.
-            //
-            if (simp->hasUnappliedSubstitutions())
-              {
-                simplified_solved_InputToSAT = simp->applySubstitutionMap(simplified_solved_InputToSAT);
-                simp->haveAppliedSubstitutionMap();
-              }
-
-            bm->ASTNodeStats(pe_message.c_str(), simplified_solved_InputToSAT);
-
-            simplified_solved_InputToSAT = simp->SimplifyFormula_TopLevel(simplified_solved_InputToSAT, false);
+    simplified_solved_InputToSAT = simplifyToFixedPoint(simplified_solved_InputToSAT, bvSolver.get(), pe.get());
 
-            bm->ASTNodeStats(size_inc_message.c_str(), simplified_solved_InputToSAT);
-          }
+    if (bm->soft_timeout_expired)
+        return SOLVER_TIMEOUT;
 
-        if (bm->UserFlags.wordlevel_solve_flag && bm->UserFlags.optimize_flag)
-          {
-            simplified_solved_InputToSAT = bvSolver->TopLevelBVSolve(simplified_solved_InputToSAT);
-            bm->ASTNodeStats(bitvec_message.c_str(), simplified_solved_InputToSAT);
-          }
-      }
-    while (inputToSAT != simplified_solved_InputToSAT);
+    // Kept until the widths are narrowed, which uses the bits it fixed.
+    std::auto_ptr<simplifier::constantBitP::ConstantBitPropagation> topCB;
 
     if (bm->UserFlags.bitConstantProp_flag)
       {
         bm->GetRunTimes()->start(RunTimes::ConstantBitPropagation);
-        simplifier::constantBitP::ConstantBitPropagation cb(simp, bm->defaultNodeFactory, simplified_solved_InputToSAT);
-        simplified_solved_InputToSAT = cb.topLevelBothWays(simplified_solved_InputToSAT);
+        topCB.reset(new simplifier::constantBitP::ConstantBitPropagation(simp, bm->defaultNodeFactory,
+            simplified_solved_InputToSAT, assertedFixedBits.get()));
+        simplified_solved_InputToSAT = topCB->topLevelBothWays(simplified_solved_InputToSAT);
 
         bm->GetRunTimes()->stop(RunTimes::ConstantBitPropagation);
 
-        if (cb.isUnsatisfiable())
+        if (topCB->isUnsatisfiable())
           simplified_solved_InputToSAT = bm->ASTFalse;
 
         bm->ASTNodeStats(cb_message.c_str(), simplified_solved_InputToSAT);
@@ -411,6 +836,18 @@ namespace BEEV {
           }
       }
 
+    // Do arithmetic and comparisons at the width the operands need.
+    if (bm->UserFlags.isSet("narrow-widths", "1"))
+      {
+        NarrowWidths narrow(*bm);
+        simplified_solved_InputToSAT = narrow.topLevel(simplified_solved_InputToSAT,
+            topCB.get() == NULL ? NULL : topCB->fixedMap);
+        if (bm->UserFlags.stats_flag)
+          cerr << "Narrowed:" << narrow.numberNarrowed() << endl;
+        bm->ASTNodeStats(nw_message.c_str(), simplified_solved_InputToSAT);
+      }
+    topCB.reset();
+
     if (bm->soft_timeout_expired)
         return SOLVER_TIMEOUT;
 
@@ -584,6 +1021,36 @@ namespace BEEV {
 
     const bool maybeRefinement = arrayops && !bm->UserFlags.ackermannisation;
 
+    // Each query is logged whole, so isn't split when calibrating.
+    const string difficultyLog = bm->UserFlags.get("difficulty-log");
+
+    // Solve the parts that share no symbols separately.
+    if (!maybeRefinement && bm->UserFlags.isSet("split-components", "1") && difficultyLog.empty()
+        && !bm->UserFlags.isSet("traditional-cnf", "0")
+        && !bm->UserFlags.output_CNF_flag && !bm->UserFlags.exit_after_CNF
+        && simplified_solved_InputToSAT.GetKind() == AND && !containsArrayOps(simplified_solved_InputToSAT))
+      {
+        std::vector<ASTVec> groups;
+        independentComponents(bm, simplified_solved_InputToSAT, groups);
+
+        if (groups.size() > 1)
+          {
+            if (bm->UserFlags.stats_flag)
+              cerr << "Independent components:" << groups.size() << endl;
+
+            std::vector<ASTNode> components;
+            for (size_t i = 0; i < groups.size(); i++)
+              components.push_back(conjoin(bm, groups[i]));
+
+            res = solveComponents(components, original_input);
+            if (SOLVER_UNDECIDED != res)
+              {
+                CountersAndStats("print_func_stats", bm);
+                return res;
+              }
+          }
+      }
+
     simplifier::constantBitP::ConstantBitPropagation* cb = NULL;
     std::auto_ptr<simplifier::constantBitP::ConstantBitPropagation> cleaner;
 
@@ -591,7 +1058,7 @@ namespace BEEV {
       {
         bm->GetRunTimes()->start(RunTimes::ConstantBitPropagation);
         cb = new simplifier::constantBitP::ConstantBitPropagation(simp, bm->defaultNodeFactory,
-            simplified_solved_InputToSAT);
+            simplified_solved_InputToSAT, assertedFixedBits.get());
         cleaner.reset(cb);
         bm->GetRunTimes()->stop(RunTimes::ConstantBitPropagation);
 
@@ -626,6 +1093,9 @@ namespace BEEV {
         if (toSATAIG.cbIsDestructed())
           cleaner.release();
 
+        if (!difficultyLog.empty())
+          logDifficulty(difficultyLog, simplified_solved_InputToSAT, toSATAIG);
+
         CountersAndStats("print_func_stats", bm);
         return res;
       }
@@ -640,6 +1110,9 @@ namespace BEEV {
         if (toSATAIG.cbIsDestructed())
           cleaner.release();
 
+        if (!difficultyLog.empty())
+          logDifficulty(difficultyLog, simplified_solved_InputToSAT, toSATAIG);
+
         CountersAndStats("print_func_stats", bm);
         return res;
       }
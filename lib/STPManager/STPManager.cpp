@@ -34,33 +34,41 @@ namespace BEEV
   using std::cout;
   using std::endl;
 
-  ASTInterior *STPMgr::LookupOrCreateInterior(ASTInterior *n_ptr)
+  ASTInterior *STPMgr::LookupOrCreateInterior(ASTInterior& n)
   {
-    ASTInteriorSet::iterator it = _interior_unique_table.find(n_ptr);
-    if (it == _interior_unique_table.end())
+    ASTInterior *n_ptr = &n; // it's a temporary key.
+    n.SetHashValue(ASTInterior::ASTInteriorHasher()(n_ptr));
+    ASTInterior *found = _interior_unique_table.find(n_ptr);
+    if (found == NULL)
       {
-        // Make a new ASTInterior node We want (NOT alpha) always to
-        // have alpha.nodenum + 1.
-        if (n_ptr->GetKind() == NOT)
+        // Make a new ASTInterior node in the slab, taking the
+        // children from the temporary key.
+        ASTInterior *n_copy = new (interior_slab.allocate()) ASTInterior(n.GetKind());
+        n_copy->_children.swap(n._children);
+        n_copy->_index_width = n._index_width;
+        n_copy->_value_width = n._value_width;
+        n_copy->_hash = n._hash;
+#ifdef STP_NODE_HANDLES
+        n_copy->AssignHandle();
+#endif
+
+        // We want (NOT alpha) always to have alpha.nodenum + 1.
+        if (n_copy->GetKind() == NOT)
           {
         	// The internal node can't be a NOT, because then we'd add
         	// 1 to the NOT's node number, meaning we'd hit an even number,
         	// which could duplicate the next newNodeNum().
-        	assert(n_ptr->GetChildren()[0].GetKind() != NOT);
-       		n_ptr->SetNodeNum(n_ptr->GetChildren()[0].GetNodeNum() + 1);
+        	assert(n_copy->GetChildren()[0].GetKind() != NOT);
+       		n_copy->SetNodeNum(n_copy->GetChildren()[0].GetNodeNum() + 1);
           }
         else
           {
-            n_ptr->SetNodeNum(NewNodeNum());
+            n_copy->SetNodeNum(NewNodeNum());
           }
-        std::pair<ASTInteriorSet::const_iterator, bool> p = 
-          _interior_unique_table.insert(n_ptr);
-        return *(p.first);
+        _interior_unique_table.insert(n_copy);
+        return n_copy;
       }
-    else
-      // Delete the temporary node, and return the found node.
-      delete n_ptr;
-    return *it;
+    return found;
   }
 
   
@@ -69,12 +77,12 @@ namespace BEEV
   ASTInterior *STPMgr::CreateInteriorNode(Kind kind,
                                           // children array of this
                                           // node will be modified.
-                                          ASTInterior *n_ptr,
+                                          ASTInterior& n,
                                           const ASTVec & back_children)
   {
 
     // insert back_children at end of front_children
-    ASTVec &front_children = n_ptr->_children;
+    ASTVec &front_children = n._children;
 	front_children.reserve(front_children.size()+ back_children.size());
 
     front_children.insert(front_children.end(), 
@@ -94,7 +102,7 @@ namespace BEEV
           }
       }
 
-    return LookupOrCreateInterior(n_ptr);
+    return LookupOrCreateInterior(n);
   }
 
   ostream &operator<<(ostream &os, const ASTNodeMap &nmap)
@@ -136,33 +144,36 @@ namespace BEEV
     //return s_ptr;
     // Do an explicit lookup to see if we need to create a copy of the
     // string.
-    ASTSymbolSet::const_iterator it = _symbol_unique_table.find(s_ptr);
-    if (it == _symbol_unique_table.end())
+    s.SetHashValue(ASTSymbol::ASTSymbolHasher()(s_ptr));
+    ASTSymbol *found = _symbol_unique_table.find(s_ptr);
+    if (found == NULL)
       {
         // Make a new ASTSymbol with duplicated string (can't assign
-        // _name because it's const).  Can cast the iterator to
-        // non-const -- carefully.
+        // _name because it's const).
         //std::string strname(s_ptr->GetName());
-        ASTSymbol * s_ptr1 = new ASTSymbol(strdup(s_ptr->GetName()));
+        ASTSymbol * s_ptr1 = new (symbol_slab.allocate()) ASTSymbol(strdup(s_ptr->GetName()));
         s_ptr1->SetNodeNum(NewNodeNum());
         s_ptr1->_value_width = s_ptr->_value_width;
-        std::pair<ASTSymbolSet::const_iterator, bool> p = 
-          _symbol_unique_table.insert(s_ptr1);
-        return *p.first;
+        s_ptr1->_hash = s_ptr->_hash;
+#ifdef STP_NODE_HANDLES
+        s_ptr1->AssignHandle();
+#endif
+        _symbol_unique_table.insert(s_ptr1);
+        return s_ptr1;
       }
     else
       {
         // return symbol found in table.
-        return *it;
+        return found;
       }
   } // End of LookupOrCreateSymbol
 
   bool STPMgr::LookupSymbol(ASTSymbol& s)
   {
     ASTSymbol* s_ptr = &s; // it's a temporary key.
+    s.SetHashValue(ASTSymbol::ASTSymbolHasher()(s_ptr));
 
-    if (_symbol_unique_table.find(s_ptr) == 
-        _symbol_unique_table.end())
+    if (_symbol_unique_table.find(s_ptr) == NULL)
       return false;
     else
       return true;
@@ -171,22 +182,17 @@ namespace BEEV
   bool STPMgr::LookupSymbol(const char * const name)
   {
     ASTSymbol s(name);
-    ASTSymbol* s_ptr = &s; // it's a temporary key.
-
-    if (_symbol_unique_table.find(s_ptr) ==
-        _symbol_unique_table.end())
-      return false;
-    else
-      return true;
+    return LookupSymbol(s);
   }
 
   bool STPMgr::LookupSymbol(const char * const name, ASTNode& output)
   {
     ASTSymbol temp_sym(name);
-    ASTSymbolSet::const_iterator it = _symbol_unique_table.find(&temp_sym);
-    if (it != _symbol_unique_table.end())
+    temp_sym.SetHashValue(ASTSymbol::ASTSymbolHasher()(&temp_sym));
+    ASTSymbol *found = _symbol_unique_table.find(&temp_sym);
+    if (found != NULL)
       {
-        output = ASTNode(*it);
+        output = ASTNode(found);
         return true;
       }
   return false;
@@ -206,39 +212,8 @@ namespace BEEV
                  ASTUndefined, width);
 
 
-    // We create a single bvconst that gets reused.
-    if (NULL == CreateBVConstVal)
-      CreateBVConstVal = CONSTANTBV::BitVector_Create(65, true);
-    CreateBVConstVal  = CONSTANTBV::BitVector_Resize(CreateBVConstVal,width);
-    CONSTANTBV::BitVector_Empty(CreateBVConstVal);
-
-    unsigned long c_val = (~((unsigned long) 0)) & bvconst;
-    unsigned int copied = 0;
-
-    // sizeof(unsigned long) returns the number of bytes in unsigned
-    // long. In order to convert it to bits, we need to shift left by
-    // 3. Hence, sizeof(unsigned long)*8
-
-    //The algo below works as follows: It starts by copying the
-    //lower-order bits of the input "bvconst" in chunks of size =
-    //number of bits in unsigned long. The variable "copied" keeps
-    //track of the number of chunks copied so far
-
-    const int shift_amount = sizeof(unsigned long)*8;
-    while (copied + shift_amount < width)
-      {
-        CONSTANTBV::BitVector_Chunk_Store(CreateBVConstVal, shift_amount, copied, c_val);
-        if (shift_amount < (sizeof(bvconst)*8)) {
-            bvconst >>= shift_amount;
-        } else {
-            bvconst = 0;
-        }
-        c_val = (~((unsigned long) 0)) & bvconst;
-        copied += shift_amount;
-      }
-    CONSTANTBV::BitVector_Chunk_Store(CreateBVConstVal, width - copied, copied, c_val);
-
-    ASTBVConst temp_bvconst(CreateBVConstVal, width,ASTBVConst::CBV_MANAGED_OUTSIDE);
+    // Fits in the node, so there's no CBV to build.
+    ASTBVConst temp_bvconst((uint64_t) bvconst, width);
     return  ASTNode(LookupOrCreateBVConst(temp_bvconst));
 
   }
@@ -406,22 +381,26 @@ namespace BEEV
     ASTBVConst *s_ptr = &s; // it's a temporary key.
 
     // Do an explicit lookup to see if we need to create a copy of the string.
-    ASTBVConstSet::const_iterator it;
-    if ((it = _bvconst_unique_table.find(s_ptr)) == _bvconst_unique_table.end())
+    s.SetHashValue(ASTBVConst::ASTBVConstHasher()(s_ptr));
+    ASTBVConst *found = _bvconst_unique_table.find(s_ptr);
+    if (found == NULL)
       {
         // Make a new ASTBVConst with duplicated constant.
 
-        ASTBVConst * s_copy = new ASTBVConst(s);
+        ASTBVConst * s_copy = new (bvconst_slab.allocate()) ASTBVConst(s);
         s_copy->SetNodeNum(NewNodeNum());
+        s_copy->_hash = s._hash;
+#ifdef STP_NODE_HANDLES
+        s_copy->AssignHandle();
+#endif
 
-        std::pair<ASTBVConstSet::const_iterator, bool> p = 
-	  _bvconst_unique_table.insert(s_copy);
-        return *p.first;
+        _bvconst_unique_table.insert(s_copy);
+        return s_copy;
       }
     else
       {
         // return constant found in table.
-        return *it;
+        return found;
       }
   }
 
@@ -459,17 +438,49 @@ namespace BEEV
       }
 
     if(_asserts.empty())
+      {
 	_asserts.push_back(new ASTVec());
+	_level_first_introduced.push_back(_level_introduced_symbols.size());
+      }
 
     ASTVec& v = *_asserts.back();
     v.push_back(assert);
   }
 
+  VisitedMarks* STPMgr::acquireVisitedMarks()
+  {
+    VisitedMarks* marks = NULL;
+    {
+      std::lock_guard<std::mutex> guard(visited_marks_lock);
+      if (!visited_marks_pool.empty())
+        {
+          marks = visited_marks_pool.back();
+          visited_marks_pool.pop_back();
+        }
+    }
+
+    if (marks == NULL)
+      marks = new VisitedMarks();
+    else
+      marks->clear();
+    return marks;
+  }
+
+  void STPMgr::releaseVisitedMarks(VisitedMarks* marks)
+  {
+    std::lock_guard<std::mutex> guard(visited_marks_lock);
+    visited_marks_pool.push_back(marks);
+  }
+
   void STPMgr::Push(void)
   {
     _asserts.push_back(new ASTVec());
+    _level_first_introduced.push_back(_level_introduced_symbols.size());
   }
 
+  // Along with the assertions, the introduced symbols that were created
+  // in the popped context, and that nothing else refers to any more,
+  // are dropped, so that they can be freed.
   void
   STPMgr::Pop(void)
   {
@@ -479,7 +490,25 @@ namespace BEEV
     ASTVec * c = _asserts.back();
     c->clear();
     delete c;
+
+    // Those that are still used are kept, and become the enclosing
+    // context's to check when it's popped.
+    const size_t first = _level_first_introduced.back();
+    size_t kept = first;
+    for (size_t i = first; i < _level_introduced_symbols.size(); i++)
+      {
+        // Referred to by the set and by the list only.
+        if (_level_introduced_symbols[i].GetRefCount() == 2)
+          Introduced_SymbolsSet.erase(_level_introduced_symbols[i]);
+        else
+          _level_introduced_symbols[kept++] = _level_introduced_symbols[i];
+      }
+    _level_introduced_symbols.resize(kept);
+
     _asserts.pop_back();
+    _level_first_introduced.pop_back();
+    if (_level_first_introduced.empty())
+      _level_introduced_symbols.clear();
   }
 
   void STPMgr::AddQuery(const ASTNode& q)
@@ -555,6 +584,25 @@ namespace BEEV
     cout << "Node size is: " << NodeSize(a) << endl;
   }
 
+  void STPMgr::printNodeAllocationStats()
+  {
+    cout << "Interior nodes allocated: " << interior_slab.getAllocations()
+         << " (reused: " << interior_slab.getReuses()
+         << ", live: " << interior_slab.getLive() << ")" << endl;
+    cout << "Symbol nodes allocated: " << symbol_slab.getAllocations()
+         << " (reused: " << symbol_slab.getReuses()
+         << ", live: " << symbol_slab.getLive() << ")" << endl;
+    cout << "BVConst nodes allocated: " << bvconst_slab.getAllocations()
+         << " (reused: " << bvconst_slab.getReuses()
+         << ", live: " << bvconst_slab.getLive() << ")" << endl;
+    cout << "Node slab memory: "
+         << (interior_slab.getReservedBytes() + symbol_slab.getReservedBytes()
+             + bvconst_slab.getReservedBytes()) / 1024 << "KB" << endl;
+#ifdef STP_NODE_HANDLES
+    cout << "Node handles: " << ASTInternal::GetHandleCount() << endl;
+#endif
+  }
+
   unsigned int STPMgr::NodeSize(const ASTNode& a)
   {
       unsigned int result = 0;
@@ -634,6 +682,7 @@ namespace BEEV
 
   
   //If ASTNode remain with references (somewhere), this will segfault.
+  //Any nodes still in the unique tables are released along with the slabs.
   STPMgr::~STPMgr() {
  		ClearAllTables();
 
@@ -656,7 +705,12 @@ namespace BEEV
  		if (NULL != CreateBVConstVal)
  			CONSTANTBV::BitVector_Destroy(CreateBVConstVal);
 
- 		Introduced_SymbolsSet.clear();
+ 		for (size_t i = 0; i < visited_marks_pool.size(); i++)
+			delete visited_marks_pool[i];
+		visited_marks_pool.clear();
+
+		Introduced_SymbolsSet.clear();
+		_level_introduced_symbols.clear();
  		_symbol_unique_table.clear();
  		_bvconst_unique_table.clear();
 
@@ -673,6 +727,10 @@ namespace BEEV
  		delete hashingNodeFactory;
 
  		_interior_unique_table.clear();
+
+ 		interior_slab.releaseAll();
+ 		symbol_slab.releaseAll();
+ 		bvconst_slab.releaseAll();
  	}
 } // end namespace beev
 
@@ -0,0 +1,615 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#include <cassert>
+#include "stp/Simplifier/BatchEvaluator.h"
+#include "stp/STPManager/STPManager.h"
+
+namespace BEEV
+{
+  typedef BatchEvaluator::Word Word;
+
+  static const Word AllLanes = ~(Word) 0;
+
+  /****************************************************************
+   * Word-sliced arithmetic. Each array holds one word per bit,   *
+   * least significant bit first. The outputs may be the same     *
+   * arrays as the inputs unless it says otherwise.               *
+   ****************************************************************/
+
+  // out = a + b + carry.
+  static void add(const Word* a, const Word* b, Word* out, unsigned w, Word carry = 0)
+  {
+    for (unsigned i = 0; i < w; i++)
+      {
+        const Word x = a[i], y = b[i];
+        out[i] = x ^ y ^ carry;
+        carry = (x & y) | (carry & (x ^ y));
+      }
+  }
+
+  // out = a - b, returns the lanes that borrowed, i.e. where a < b.
+  static Word subtract(const Word* a, const Word* b, Word* out, unsigned w)
+  {
+    Word borrow = 0;
+    for (unsigned i = 0; i < w; i++)
+      {
+        const Word x = a[i], y = b[i];
+        out[i] = x ^ y ^ borrow;
+        borrow = (~x & y) | (~(x ^ y) & borrow);
+      }
+    return borrow;
+  }
+
+  static void negate(const Word* a, Word* out, unsigned w)
+  {
+    Word carry = AllLanes;
+    for (unsigned i = 0; i < w; i++)
+      {
+        const Word x = ~a[i];
+        out[i] = x ^ carry;
+        carry = x & carry;
+      }
+  }
+
+  // out = (lanes) ? a : b.
+  static void select(Word lanes, const Word* a, const Word* b, Word* out, unsigned w)
+  {
+    for (unsigned i = 0; i < w; i++)
+      out[i] = (a[i] & lanes) | (b[i] & ~lanes);
+  }
+
+  // The lanes where a < b, unsigned, or signed if "sign".
+  static Word lessThan(const Word* a, const Word* b, unsigned w, bool sign)
+  {
+    Word lt = 0;
+    for (unsigned i = 0; i < w; i++)
+      {
+        if (sign && i == w - 1)
+          lt = (a[i] & ~b[i]) | (~(a[i] ^ b[i]) & lt);
+        else
+          lt = (~a[i] & b[i]) | (~(a[i] ^ b[i]) & lt);
+      }
+    return lt;
+  }
+
+  static Word equal(const Word* a, const Word* b, unsigned w)
+  {
+    Word eq = AllLanes;
+    for (unsigned i = 0; i < w; i++)
+      eq &= ~(a[i] ^ b[i]);
+    return eq;
+  }
+
+  static Word isZero(const Word* a, unsigned w)
+  {
+    Word any = 0;
+    for (unsigned i = 0; i < w; i++)
+      any |= a[i];
+    return ~any;
+  }
+
+  // out = a * b (shift and add). "out" must be distinct from a.
+  static void multiply(const Word* a, const Word* b, Word* out, unsigned w)
+  {
+    std::vector<Word> acc(w, 0);
+    for (unsigned j = 0; j < w; j++)
+      {
+        const Word m = b[j];
+        if (m == 0)
+          continue;
+        Word carry = 0;
+        for (unsigned i = j; i < w; i++)
+          {
+            const Word x = acc[i], y = a[i - j] & m;
+            acc[i] = x ^ y ^ carry;
+            carry = (x & y) | (carry & (x ^ y));
+          }
+      }
+    for (unsigned i = 0; i < w; i++)
+      out[i] = acc[i];
+  }
+
+  // Restoring division. The lanes where b is zero get a quotient of
+  // all ones and a remainder of a.
+  static void divide(const Word* a, const Word* b, Word* quotient, Word* remainder, unsigned w)
+  {
+    // The partial remainder needs one more bit than the operands.
+    std::vector<Word> r(w + 1, 0), bb(w + 1, 0), diff(w + 1);
+    for (unsigned i = 0; i < w; i++)
+      bb[i] = b[i];
+
+    for (unsigned i = w; i-- > 0;)
+      {
+        for (unsigned j = w; j > 0; j--)
+          r[j] = r[j - 1];
+        r[0] = a[i];
+
+        const Word ge = ~subtract(&r[0], &bb[0], &diff[0], w + 1);
+        select(ge, &diff[0], &r[0], &r[0], w + 1);
+        quotient[i] = ge;
+      }
+    for (unsigned i = 0; i < w; i++)
+      remainder[i] = r[i];
+  }
+
+  // Shifts a by the amount in s, both w bits. Shifting by w or more
+  // gives zero, or the sign bit for an arithmetic shift.
+  static void shift(Kind k, const Word* a, const Word* s, Word* out, unsigned w)
+  {
+    std::vector<Word> cur(a, a + w);
+    Word big = 0;
+
+    for (unsigned j = 0; j < w; j++)
+      {
+        const Word m = s[j];
+        if (j >= 32 || (1u << j) >= w)
+          {
+            big |= m;
+            continue;
+          }
+        if (m == 0)
+          continue;
+
+        const unsigned d = 1u << j;
+        if (k == BVLEFTSHIFT)
+          {
+            for (unsigned i = w; i-- > 0;)
+              {
+                const Word shifted = (i >= d) ? cur[i - d] : 0;
+                cur[i] = (shifted & m) | (cur[i] & ~m);
+              }
+          }
+        else
+          {
+            const Word fill = (k == BVSRSHIFT) ? cur[w - 1] : 0;
+            for (unsigned i = 0; i < w; i++)
+              {
+                const Word shifted = (i + d < w) ? cur[i + d] : fill;
+                cur[i] = (shifted & m) | (cur[i] & ~m);
+              }
+          }
+      }
+
+    const Word fill = (k == BVSRSHIFT) ? a[w - 1] : 0;
+    for (unsigned i = 0; i < w; i++)
+      out[i] = (cur[i] & ~big) | (fill & big);
+  }
+
+  // Signed division, remainder, and modulus, by dividing the absolute
+  // values then fixing up the signs, as the constant evaluator does.
+  static void signedDivide(Kind k, const Word* a, const Word* b, Word* out, unsigned w)
+  {
+    const Word negA = a[w - 1];
+    const Word negB = b[w - 1];
+    std::vector<Word> absA(w), absB(w), q(w), u(w), t(w);
+
+    negate(a, &t[0], w);
+    select(negA, &t[0], a, &absA[0], w);
+    negate(b, &t[0], w);
+    select(negB, &t[0], b, &absB[0], w);
+
+    divide(&absA[0], &absB[0], &q[0], &u[0], w);
+
+    if (k == SBVDIV)
+      {
+        negate(&q[0], &t[0], w);
+        select(negA ^ negB, &t[0], &q[0], out, w);
+      }
+    else if (k == SBVREM)
+      {
+        negate(&u[0], &t[0], w);
+        select(negA, &t[0], &u[0], out, w);
+      }
+    else
+      {
+        assert(k == SBVMOD);
+        // u when u is zero or both are positive, -u + b when only a
+        // is negative, u + b when only b is negative, and -u when both
+        // are negative.
+        std::vector<Word> negU(w), sum(w);
+        negate(&u[0], &negU[0], w);
+        select(negA, &negU[0], &u[0], &t[0], w);
+        add(&t[0], b, &sum[0], w);
+        select((negA ^ negB) & ~isZero(&u[0], w), &sum[0], &t[0], out, w);
+      }
+
+    // Division by zero.
+    const Word zero = isZero(b, w);
+    if (zero != 0)
+      {
+        for (unsigned i = 0; i < w; i++)
+          {
+            Word v = a[i];
+            if (k == SBVDIV)
+              v = (i == 0) ? AllLanes : negA;
+            out[i] = (v & zero) | (out[i] & ~zero);
+          }
+      }
+  }
+
+  /****************************************************************
+   * BatchEvaluator                                               *
+   ****************************************************************/
+
+  BatchEvaluator::BatchEvaluator(STPMgr* bm_) :
+    bm(bm_), stale(false)
+  {
+  }
+
+  unsigned BatchEvaluator::numberOfWords(const ASTNode& n)
+  {
+    return (n.GetType() == BOOLEAN_TYPE) ? 1 : n.GetValueWidth();
+  }
+
+  BatchEvaluator::Word* BatchEvaluator::symbolSlices(const ASTNode& symbol)
+  {
+    assert(symbol.GetKind() == SYMBOL);
+    assert(symbol.GetType() != ARRAY_TYPE);
+
+    size_t* off = symbolOffset.find(symbol);
+    if (off == NULL)
+      {
+        const size_t o = symbolWords.size();
+        symbolWords.resize(o + numberOfWords(symbol), 0);
+        symbolOffset[symbol] = o;
+        return &symbolWords[o];
+      }
+    return &symbolWords[*off];
+  }
+
+  void BatchEvaluator::setValue(const ASTNode& symbol, unsigned lane, const ASTNode& value)
+  {
+    assert(lane < Lanes);
+    if (symbol.GetType() == BOOLEAN_TYPE)
+      {
+        assert(value == bm->ASTTrue || value == bm->ASTFalse);
+        setValue(symbol, lane, (uint64_t) (value == bm->ASTTrue));
+        return;
+      }
+
+    assert(value.GetKind() == BVCONST);
+    assert(value.GetValueWidth() == symbol.GetValueWidth());
+    Word* s = symbolSlices(symbol);
+    const Word bit = ((Word) 1) << lane;
+    const CBV c = value.GetBVConst();
+    for (unsigned i = 0; i < symbol.GetValueWidth(); i++)
+      {
+        if (CONSTANTBV::BitVector_bit_test(c, i))
+          s[i] |= bit;
+        else
+          s[i] &= ~bit;
+      }
+    stale = true;
+  }
+
+  void BatchEvaluator::setValue(const ASTNode& symbol, unsigned lane, uint64_t value)
+  {
+    assert(lane < Lanes);
+    Word* s = symbolSlices(symbol);
+    const Word bit = ((Word) 1) << lane;
+    if (symbol.GetType() == BOOLEAN_TYPE)
+      {
+        s[0] = (value != 0) ? (s[0] | bit) : (s[0] & ~bit);
+      }
+    else
+      {
+        assert(symbol.GetValueWidth() <= 64);
+        for (unsigned i = 0; i < symbol.GetValueWidth(); i++)
+          s[i] = ((value >> i) & 1) ? (s[i] | bit) : (s[i] & ~bit);
+      }
+    stale = true;
+  }
+
+  const BatchEvaluator::Word* BatchEvaluator::find(const ASTNode& n) const
+  {
+    const size_t* off = symbolOffset.find(n);
+    if (off != NULL)
+      return &symbolWords[*off];
+    off = resultOffset.find(n);
+    if (off != NULL)
+      return &resultWords[*off];
+    return NULL;
+  }
+
+  bool BatchEvaluator::evaluate(const ASTNode& n)
+  {
+    if (stale)
+      {
+        resultOffset.clear();
+        resultWords.clear();
+        stale = false;
+      }
+    return visit(n);
+  }
+
+  bool BatchEvaluator::visit(const ASTNode& n)
+  {
+    if (find(n) != NULL)
+      return true;
+
+    if (n.GetType() == ARRAY_TYPE)
+      return false;
+
+    const ASTVec& c = n.GetChildren();
+    for (size_t i = 0; i < c.size(); i++)
+      if (!visit(c[i]))
+        return false;
+
+    const Kind k = n.GetKind();
+    const unsigned w = numberOfWords(n);
+    const size_t off = resultWords.size();
+    resultWords.resize(off + w, 0);
+
+    // The children are all evaluated, so these pointers stay put.
+    Word* out = &resultWords[off];
+    const Word* a = (c.size() > 0) ? find(c[0]) : NULL;
+    const Word* b = (c.size() > 1) ? find(c[1]) : NULL;
+    bool ok = true;
+
+    switch (k)
+      {
+      case SYMBOL:
+        // No value, so zero.
+        break;
+      case BVCONST:
+        {
+          const CBV cbv = n.GetBVConst();
+          for (unsigned i = 0; i < w; i++)
+            out[i] = CONSTANTBV::BitVector_bit_test(cbv, i) ? AllLanes : 0;
+          break;
+        }
+      case TRUE:
+        out[0] = AllLanes;
+        break;
+      case FALSE:
+        out[0] = 0;
+        break;
+
+      case BVNEG:
+        for (unsigned i = 0; i < w; i++)
+          out[i] = ~a[i];
+        break;
+      case BVAND:
+      case BVNAND:
+      case AND:
+      case NAND:
+        for (unsigned i = 0; i < w; i++)
+          {
+            Word v = AllLanes;
+            for (size_t j = 0; j < c.size(); j++)
+              v &= find(c[j])[i];
+            out[i] = (k == BVNAND || k == NAND) ? ~v : v;
+          }
+        break;
+      case BVOR:
+      case BVNOR:
+      case OR:
+      case NOR:
+        for (unsigned i = 0; i < w; i++)
+          {
+            Word v = 0;
+            for (size_t j = 0; j < c.size(); j++)
+              v |= find(c[j])[i];
+            out[i] = (k == BVNOR || k == NOR) ? ~v : v;
+          }
+        break;
+      case BVXOR:
+      case BVXNOR:
+      case XOR:
+        for (unsigned i = 0; i < w; i++)
+          {
+            Word v = 0;
+            for (size_t j = 0; j < c.size(); j++)
+              v ^= find(c[j])[i];
+            out[i] = (k == BVXNOR) ? ~v : v;
+          }
+        break;
+      case NOT:
+        out[0] = ~a[0];
+        break;
+      case IFF:
+        if (c.size() != 2)
+          ok = false;
+        else
+          out[0] = ~(a[0] ^ b[0]);
+        break;
+      case IMPLIES:
+        out[0] = ~a[0] | b[0];
+        break;
+      case ITE:
+        select(a[0], b, find(c[2]), out, w);
+        break;
+
+      case BVPLUS:
+        for (unsigned i = 0; i < w; i++)
+          out[i] = a[i];
+        for (size_t j = 1; j < c.size(); j++)
+          add(out, find(c[j]), out, w);
+        break;
+      case BVSUB:
+        subtract(a, b, out, w);
+        break;
+      case BVUMINUS:
+        negate(a, out, w);
+        break;
+      case BVMULT:
+        for (unsigned i = 0; i < w; i++)
+          out[i] = a[i];
+        for (size_t j = 1; j < c.size(); j++)
+          {
+            std::vector<Word> t(out, out + w);
+            multiply(&t[0], find(c[j]), out, w);
+          }
+        break;
+      case BVDIV:
+      case BVMOD:
+        {
+          std::vector<Word> q(w), r(w);
+          divide(a, b, &q[0], &r[0], w);
+          if (k == BVDIV)
+            {
+              // Division by zero gives one.
+              const Word zero = isZero(b, w);
+              for (unsigned i = 0; i < w; i++)
+                out[i] = (q[i] & ~zero) | ((i == 0) ? zero : 0);
+            }
+          else
+            {
+              for (unsigned i = 0; i < w; i++)
+                out[i] = r[i];
+            }
+          break;
+        }
+      case SBVDIV:
+      case SBVREM:
+      case SBVMOD:
+        signedDivide(k, a, b, out, w);
+        break;
+
+      case BVLEFTSHIFT:
+      case BVRIGHTSHIFT:
+      case BVSRSHIFT:
+        shift(k, a, b, out, w);
+        break;
+
+      case BVCONCAT:
+        {
+          // The first child is the most significant.
+          unsigned pos = 0;
+          for (size_t j = c.size(); j-- > 0;)
+            {
+              const Word* v = find(c[j]);
+              for (unsigned i = 0; i < c[j].GetValueWidth(); i++)
+                out[pos++] = v[i];
+            }
+          assert(pos == w);
+          break;
+        }
+      case BVEXTRACT:
+        {
+          const unsigned low = c[2].GetUnsignedConst();
+          for (unsigned i = 0; i < w; i++)
+            out[i] = a[low + i];
+          break;
+        }
+      case BVZX:
+      case BVSX:
+        {
+          const unsigned aw = c[0].GetValueWidth();
+          for (unsigned i = 0; i < w; i++)
+            out[i] = (i < aw) ? a[i] : ((k == BVSX) ? a[aw - 1] : 0);
+          break;
+        }
+
+      case BOOLEXTRACT:
+        {
+          const unsigned bit = c[1].GetUnsignedConst();
+          out[0] = (bit < c[0].GetValueWidth()) ? a[bit] : 0;
+          break;
+        }
+      case EQ:
+        out[0] = equal(a, b, numberOfWords(c[0]));
+        break;
+      case BVLT:
+      case BVSLT:
+        out[0] = lessThan(a, b, c[0].GetValueWidth(), k == BVSLT);
+        break;
+      case BVGT:
+      case BVSGT:
+        out[0] = lessThan(b, a, c[0].GetValueWidth(), k == BVSGT);
+        break;
+      case BVLE:
+      case BVSLE:
+        out[0] = ~lessThan(b, a, c[0].GetValueWidth(), k == BVSLE);
+        break;
+      case BVGE:
+      case BVSGE:
+        out[0] = ~lessThan(a, b, c[0].GetValueWidth(), k == BVSGE);
+        break;
+
+      default:
+        ok = false;
+        break;
+      }
+
+    if (!ok)
+      {
+        resultWords.resize(off);
+        return false;
+      }
+    resultOffset[n] = off;
+    return true;
+  }
+
+  ASTNode BatchEvaluator::getValue(const ASTNode& n, unsigned lane) const
+  {
+    const Word* v = find(n);
+    assert(v != NULL);
+    assert(lane < Lanes);
+
+    if (n.GetType() == BOOLEAN_TYPE)
+      return ((v[0] >> lane) & 1) ? bm->ASTTrue : bm->ASTFalse;
+
+    const unsigned w = n.GetValueWidth();
+    if (w <= 64)
+      return bm->CreateBVConst(w, (unsigned long long) getUint64(n, lane));
+
+    CBV cbv = CONSTANTBV::BitVector_Create(w, true);
+    for (unsigned i = 0; i < w; i++)
+      if ((v[i] >> lane) & 1)
+        CONSTANTBV::BitVector_Bit_On(cbv, i);
+    return bm->CreateBVConst(cbv, w);
+  }
+
+  uint64_t BatchEvaluator::getUint64(const ASTNode& n, unsigned lane) const
+  {
+    const Word* v = find(n);
+    assert(v != NULL);
+    assert(lane < Lanes);
+    assert(numberOfWords(n) <= 64);
+
+    uint64_t r = 0;
+    for (unsigned i = 0; i < numberOfWords(n); i++)
+      r |= ((v[i] >> lane) & 1) << i;
+    return r;
+  }
+
+  BatchEvaluator::Word BatchEvaluator::getLanes(const ASTNode& n) const
+  {
+    assert(n.GetType() == BOOLEAN_TYPE);
+    const Word* v = find(n);
+    assert(v != NULL);
+    return v[0];
+  }
+
+  void BatchEvaluator::clear()
+  {
+    symbolOffset.clear();
+    symbolWords.clear();
+    resultOffset.clear();
+    resultWords.clear();
+    stale = false;
+  }
+} // end namespace BEEV
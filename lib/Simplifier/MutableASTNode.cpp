@@ -26,6 +26,6 @@ THE SOFTWARE.
 namespace BEEV
 {
 
-  vector<MutableASTNode*> MutableASTNode::all;
+  thread_local vector<MutableASTNode*> MutableASTNode::all;
 
 }
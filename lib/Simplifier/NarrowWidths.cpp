@@ -0,0 +1,428 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#include <algorithm>
+#include <cassert>
+#include "stp/Simplifier/NarrowWidths.h"
+#include "stp/STPManager/STPManager.h"
+#include "stp/Simplifier/constantBitP/NodeToFixedBitsMap.h"
+
+namespace BEEV
+{
+  using simplifier::constantBitP::FixedBits;
+  using simplifier::constantBitP::NodeToFixedBitsMap;
+
+  // The number of extra bits that a sum of n values can need.
+  static unsigned carryBits(unsigned n)
+  {
+    unsigned bits = 0;
+    while ((1u << bits) < n)
+      bits++;
+    return bits;
+  }
+
+  NarrowWidths::NarrowWidths(STPMgr& _bm) :
+    bm(_bm), narrowed(0)
+  {
+    nf = _bm.defaultNodeFactory;
+  }
+
+  ASTNode
+  NarrowWidths::topLevel(const ASTNode& top, const NodeToFixedBitsMap* fixed)
+  {
+    assert(BOOLEAN_TYPE == top.GetType());
+    widths.clear();
+    cache.clear();
+    assumed.clear();
+    narrowed = 0;
+
+    visit(top, fixed);
+
+    ASTNode result = rewrite(top);
+    if (narrowed == 0 || assumed.empty())
+      return result;
+
+    // The narrowing relied on what the formula says about the
+    // variables, so the formula must still say it.
+    ASTNodeSet conjuncts;
+    if (AND == top.GetKind())
+      conjuncts.insert(top.begin(), top.end());
+    else
+      conjuncts.insert(top);
+
+    ASTVec c;
+    c.push_back(result);
+    for (size_t i = 0; i < assumed.size(); i++)
+      if (conjuncts.find(assumed[i]) == conjuncts.end())
+        c.push_back(assumed[i]);
+    return (c.size() == 1) ? result : nf->CreateNode(AND, c);
+  }
+
+  NarrowWidths::Widths
+  NarrowWidths::visit(const ASTNode& n, const NodeToFixedBitsMap* fixed)
+  {
+    const Widths* memo = widths.find(n);
+    if (memo != NULL)
+      return *memo;
+
+    vector<Widths> children;
+    children.reserve(n.Degree());
+    for (size_t i = 0; i < n.Degree(); i++)
+      children.push_back(visit(n[i], fixed));
+
+    const unsigned width = n.GetValueWidth();
+    Widths result;
+    result.zeroFrom = width;
+    result.signFrom = width;
+
+    if (BITVECTOR_TYPE != n.GetType())
+      {
+        widths[n] = result;
+        return result;
+      }
+
+    switch (n.GetKind())
+      {
+    case BVCONST:
+      {
+        CBV c = n.GetBVConst();
+        if (CONSTANTBV::BitVector_is_empty(c))
+          result.zeroFrom = 0;
+        else
+          result.zeroFrom = CONSTANTBV::Set_Max(c) + 1;
+
+        if (CONSTANTBV::BitVector_bit_test(c, width - 1))
+          {
+            CBV flipped = CONSTANTBV::BitVector_Clone(c);
+            CONSTANTBV::BitVector_Flip(flipped);
+            if (CONSTANTBV::BitVector_is_empty(flipped))
+              result.signFrom = 1;
+            else
+              result.signFrom = CONSTANTBV::Set_Max(flipped) + 2;
+            CONSTANTBV::BitVector_Destroy(flipped);
+          }
+      }
+      break;
+
+    case SYMBOL:
+      if (fixed != NULL)
+        {
+          // How many of the top bits the formula fixes to the same value.
+          NodeToFixedBitsMap::NodeToFixedBitsMapType::const_iterator it = fixed->map->find(n);
+          if (it == fixed->map->end())
+            break;
+          const FixedBits& bits = *it->second;
+          if (!bits.isFixed(width - 1))
+            break;
+
+          const bool value = bits.getValue(width - 1);
+          unsigned same = 0;
+          while (same < width && bits.isFixed(width - 1 - same) && bits.getValue(width - 1 - same) == value)
+            same++;
+
+          if (value)
+            result.signFrom = width - same + 1;
+          else
+            result.zeroFrom = width - same;
+
+          if (result.zeroFrom < width || result.signFrom < width)
+            {
+              ASTNode high = n;
+              if (same < width)
+                high = nf->CreateTerm(BVEXTRACT, same, n, bm.CreateBVConst(32, width - 1),
+                    bm.CreateBVConst(32, width - same));
+              assumed.push_back(nf->CreateNode(EQ, high, value ? bm.CreateMaxConst(same) : bm.CreateZeroConst(same)));
+            }
+        }
+      break;
+
+    case BVCONCAT:
+      {
+        const unsigned low = n[1].GetValueWidth();
+        if (children[0].zeroFrom == 0)
+          result.zeroFrom = children[1].zeroFrom;
+        else
+          result.zeroFrom = children[0].zeroFrom + low;
+        if (children[0].signFrom < n[0].GetValueWidth())
+          result.signFrom = children[0].signFrom + low;
+      }
+      break;
+
+    case BVEXTRACT:
+      {
+        const unsigned high = n[1].GetUnsignedConst();
+        const unsigned low = n[2].GetUnsignedConst();
+        if (children[0].zeroFrom <= low)
+          result.zeroFrom = 0;
+        else
+          result.zeroFrom = std::min(children[0].zeroFrom - low, width);
+        if (children[0].signFrom <= high + 1)
+          result.signFrom = (children[0].signFrom > low) ? children[0].signFrom - low : 1;
+      }
+      break;
+
+    case BVSX:
+      if (children[0].zeroFrom < n[0].GetValueWidth())
+        result.zeroFrom = children[0].zeroFrom;
+      result.signFrom = children[0].signFrom;
+      break;
+
+    case BVAND:
+      result.zeroFrom = children[0].zeroFrom;
+      result.signFrom = children[0].signFrom;
+      for (size_t i = 1; i < children.size(); i++)
+        {
+          result.zeroFrom = std::min(result.zeroFrom, children[i].zeroFrom);
+          result.signFrom = std::max(result.signFrom, children[i].signFrom);
+        }
+      break;
+
+    case BVOR:
+    case BVXOR:
+    case ITE:
+      {
+        // The condition of an ITE isn't a term.
+        const size_t first = (ITE == n.GetKind()) ? 1 : 0;
+        result.zeroFrom = children[first].zeroFrom;
+        result.signFrom = children[first].signFrom;
+        for (size_t i = first + 1; i < children.size(); i++)
+          {
+            result.zeroFrom = std::max(result.zeroFrom, children[i].zeroFrom);
+            result.signFrom = std::max(result.signFrom, children[i].signFrom);
+          }
+      }
+      break;
+
+    case BVNEG:
+      result.signFrom = children[0].signFrom;
+      break;
+
+    case BVUMINUS:
+      if (children[0].zeroFrom == 0)
+        result.zeroFrom = 0;
+      result.signFrom = std::min(width, children[0].signFrom + 1);
+      break;
+
+    case BVPLUS:
+      {
+        const unsigned extra = carryBits(children.size());
+        unsigned zeroFrom = 0, signFrom = 0;
+        for (size_t i = 0; i < children.size(); i++)
+          {
+            zeroFrom = std::max(zeroFrom, children[i].zeroFrom);
+            signFrom = std::max(signFrom, children[i].signFrom);
+          }
+        result.zeroFrom = std::min(width, zeroFrom + extra);
+        result.signFrom = std::min(width, signFrom + extra);
+      }
+      break;
+
+    case BVMULT:
+      {
+        unsigned zeroFrom = 0, signFrom = 0;
+        bool zero = false;
+        for (size_t i = 0; i < children.size(); i++)
+          {
+            zero |= (children[i].zeroFrom == 0);
+            zeroFrom = std::min(width, zeroFrom + children[i].zeroFrom);
+            signFrom = std::min(width, signFrom + children[i].signFrom);
+          }
+        result.zeroFrom = zero ? 0 : zeroFrom;
+        result.signFrom = signFrom;
+      }
+      break;
+
+    case BVDIV:
+    case BVMOD:
+      // Dividing by zero gives one, or the dividend.
+      if (bm.UserFlags.division_by_zero_returns_one_flag)
+        result.zeroFrom = std::max(children[0].zeroFrom, (BVDIV == n.GetKind()) ? 1u : 0u);
+      break;
+
+    case BVRIGHTSHIFT:
+      result.zeroFrom = children[0].zeroFrom;
+      break;
+
+    case BVSRSHIFT:
+      result.signFrom = children[0].signFrom;
+      break;
+
+    default:
+      break;
+      }
+
+    // Zeroes above the value mean the sign bit is zero too.
+    result.signFrom = std::min(result.signFrom, std::min(width, result.zeroFrom + 1));
+    assert(result.zeroFrom <= width);
+    assert(result.signFrom >= 1 && result.signFrom <= width);
+
+    widths[n] = result;
+    return result;
+  }
+
+  ASTNode
+  NarrowWidths::rewrite(const ASTNode& n)
+  {
+    if (n.isAtom())
+      return n;
+
+    const ASTNode* memo = cache.find(n);
+    if (memo != NULL)
+      return *memo;
+
+    ASTVec children;
+    children.reserve(n.Degree());
+    for (size_t i = 0; i < n.Degree(); i++)
+      children.push_back(rewrite(n[i]));
+
+    ASTNode result;
+    const Kind k = n.GetKind();
+    const unsigned width = n.GetValueWidth();
+
+    // The widths of the operands, which are what decide the width
+    // the operation can be done at.
+    unsigned zeroFrom = 0, signFrom = 1, zeroSum = 0, signSum = 0;
+    bool zero = false;
+    if (n.Degree() > 0 && BITVECTOR_TYPE == n[0].GetType())
+      for (size_t i = 0; i < n.Degree(); i++)
+        {
+          const Widths& w = *widths.find(n[i]);
+          zeroFrom = std::max(zeroFrom, w.zeroFrom);
+          signFrom = std::max(signFrom, w.signFrom);
+          zeroSum += w.zeroFrom;
+          signSum += w.signFrom;
+          zero |= (w.zeroFrom == 0);
+        }
+
+    switch (k)
+      {
+    case BVMULT:
+      if (zero)
+        result = bm.CreateZeroConst(width);
+      else if (zeroSum < width)
+        {
+          ASTVec low;
+          for (size_t i = 0; i < children.size(); i++)
+            low.push_back(extract(children[i], zeroSum));
+          result = zeroExtend(nf->CreateTerm(BVMULT, zeroSum, low), width);
+        }
+      else if (signSum < width)
+        {
+          ASTVec low;
+          for (size_t i = 0; i < children.size(); i++)
+            low.push_back(extract(children[i], signSum));
+          result = signExtend(nf->CreateTerm(BVMULT, signSum, low), width);
+        }
+      break;
+
+    case BVPLUS:
+      {
+        const unsigned extra = carryBits(children.size());
+        const unsigned unsignedWidth = std::max(1u, zeroFrom + extra);
+        if (unsignedWidth < width)
+          {
+            ASTVec low;
+            for (size_t i = 0; i < children.size(); i++)
+              low.push_back(extract(children[i], unsignedWidth));
+            result = zeroExtend(nf->CreateTerm(BVPLUS, unsignedWidth, low), width);
+          }
+        else if (signFrom + extra < width)
+          {
+            ASTVec low;
+            for (size_t i = 0; i < children.size(); i++)
+              low.push_back(extract(children[i], signFrom + extra));
+            result = signExtend(nf->CreateTerm(BVPLUS, signFrom + extra, low), width);
+          }
+      }
+      break;
+
+    case BVDIV:
+    case BVMOD:
+      if (bm.UserFlags.division_by_zero_returns_one_flag && std::max(1u, zeroFrom) < width)
+        {
+          const unsigned w = std::max(1u, zeroFrom);
+          result = zeroExtend(nf->CreateTerm(k, w, extract(children[0], w), extract(children[1], w)), width);
+        }
+      break;
+
+    case BVGT:
+    case BVGE:
+    case BVLT:
+    case BVLE:
+      if (std::max(1u, zeroFrom) < n[0].GetValueWidth())
+        {
+          const unsigned w = std::max(1u, zeroFrom);
+          result = nf->CreateNode(k, extract(children[0], w), extract(children[1], w));
+        }
+      break;
+
+    case BVSGT:
+    case BVSGE:
+    case BVSLT:
+    case BVSLE:
+      if (signFrom < n[0].GetValueWidth())
+        result = nf->CreateNode(k, extract(children[0], signFrom), extract(children[1], signFrom));
+      break;
+
+    default:
+      break;
+      }
+
+    if (!result.IsNull())
+      narrowed++;
+    else if (children == n.GetChildren())
+      result = n;
+    else if (BOOLEAN_TYPE == n.GetType())
+      result = nf->CreateNode(k, children);
+    else
+      result = nf->CreateArrayTerm(k, n.GetIndexWidth(), width, children);
+
+    cache[n] = result;
+    return result;
+  }
+
+  // The low bits of n.
+  ASTNode
+  NarrowWidths::extract(const ASTNode& n, unsigned width)
+  {
+    assert(width > 0 && width <= n.GetValueWidth());
+    if (width == n.GetValueWidth())
+      return n;
+    return nf->CreateTerm(BVEXTRACT, width, n, bm.CreateBVConst(32, width - 1), bm.CreateZeroConst(32));
+  }
+
+  ASTNode
+  NarrowWidths::zeroExtend(const ASTNode& n, unsigned width)
+  {
+    assert(n.GetValueWidth() < width);
+    return nf->CreateTerm(BVCONCAT, width, bm.CreateZeroConst(width - n.GetValueWidth()), n);
+  }
+
+  ASTNode
+  NarrowWidths::signExtend(const ASTNode& n, unsigned width)
+  {
+    assert(n.GetValueWidth() < width);
+    return nf->CreateTerm(BVSX, width, n, bm.CreateBVConst(32, width));
+  }
+} // end namespace BEEV
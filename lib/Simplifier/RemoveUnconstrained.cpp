@@ -39,7 +39,7 @@ namespace BEEV
   using simplifier::constantBitP::Dependencies;
 
   RemoveUnconstrained::RemoveUnconstrained(STPMgr& _bm) :
-    bm(_bm)
+    bm(_bm), simp(NULL)
   {
     nf = _bm.defaultNodeFactory;
  }
@@ -87,8 +87,6 @@ namespace BEEV
       return true;
   }
 
-  Simplifier *simplifier_convenient;
-
   ASTNode RemoveUnconstrained::replaceParentWithFresh(MutableASTNode& mute, vector<MutableASTNode*>& variables)
   {
       const ASTNode& parent = mute.n;
@@ -104,7 +102,7 @@ namespace BEEV
   {
     assert(from.GetKind() == SYMBOL);
     assert(from.GetValueWidth() == to.GetValueWidth());
-    simplifier_convenient->UpdateSubstitutionMapFewChecks(from, to);
+    simp->UpdateSubstitutionMapFewChecks(from, to);
     return;
   }
 
@@ -192,7 +190,7 @@ namespace BEEV
     if (n.GetKind() == SYMBOL)
       return n; // top level is an unconstrained symbol/.
 
-    simplifier_convenient = simplifier;
+    simp = simplifier;
 
     ASTNodeSet noCheck; // We don't want to check some expensive nodes over and over again.
 
@@ -77,13 +77,15 @@ namespace BEEV
   SubstitutionMap::applySubstitutionMap(const ASTNode& n)
   {
     bm->GetRunTimes()->start(RunTimes::ApplyingSubstitutions);
-    ASTNodeMap cache;
-    ASTNode result = replace(n, *SolverMap, cache, nf, false, false);
+    compressClasses();
+    startRound();
+    uint64_t used;
+    ASTNode result = applyMemoised(n, used);
 
     // NB. This is an expensive check. Remove it after it's been idempotent
     // for a while.
 #ifndef NDEBUG
-    cache.clear();
+    ASTNodeMap cache;
     assert( result == replace(result,*SolverMap,cache,nf, false,false));
 #endif
 
@@ -91,11 +93,132 @@ namespace BEEV
     return result;
   }
 
+// A bit for each symbol below n. The lowest bit is also set for nodes
+// without symbols that aren't leaves, as the keys can be like that
+// (e.g. extracts from constants).
+  uint64_t
+  SubstitutionMap::signature(const ASTNode& n)
+  {
+    const Kind k = n.GetKind();
+    if (k == SYMBOL)
+      return ((uint64_t) 1) << ((n.GetNodeNum() * 0x9E3779B1u) >> 26);
+    if (n.Degree() == 0)
+      return 0;
+
+    const uint64_t* s = signatures.find(n);
+    if (s != NULL)
+      return *s;
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < n.Degree(); i++)
+      result |= signature(n[i]);
+    if (result == 0)
+      result = 1;
+    signatures[n] = result;
+    return result;
+  }
+
+  void
+  SubstitutionMap::startRound()
+  {
+    const size_t keys = keysAdded.size();
+    if (!roundKeys.empty())
+      {
+      if (roundKeys.back() == keys)
+        return;
+
+      uint64_t added = 0;
+      for (size_t i = roundKeys.back(); i < keys; i++)
+        added |= signature(keysAdded[i]);
+      for (size_t i = 0; i < roundAdded.size(); i++)
+        roundAdded[i] |= added;
+      }
+    roundKeys.push_back(keys);
+    roundAdded.push_back(0);
+  }
+
+// Like replace(), but the results are kept in "applied". "used" is set
+// to the signature of the nodes that were looked up in the map.
+  ASTNode
+  SubstitutionMap::applyMemoised(const ASTNode& n, uint64_t& used)
+  {
+    const Kind k = n.GetKind();
+    used = 0;
+    if (k == BVCONST || k == TRUE || k == FALSE)
+      return n;
+
+    const size_t round = roundKeys.size() - 1;
+    Applied* a = applied.find(n);
+    if (a != NULL)
+      {
+      if (a->round == round)
+        {
+        used = a->used;
+        return a->result;
+        }
+      if ((a->used & roundAdded[a->round]) == 0)
+        {
+        a->round = round;
+        used = a->used;
+        return a->result;
+        }
+      }
+
+    used = signature(n);
+    uint64_t more;
+    ASTNode result;
+    ASTNodeMap::iterator it = SolverMap->find(n);
+    if (it != SolverMap->end())
+      {
+      const ASTNode r = it->second;
+      result = applyMemoised(r, more);
+      used |= more;
+      if (result != r)
+        (*SolverMap)[n] = result;
+      }
+    else if (k == SYMBOL)
+      result = n;
+    else
+      {
+      const ASTVec& children = n.GetChildren();
+      ASTVec new_children;
+      new_children.reserve(children.size());
+      for (ASTVec::const_iterator it = children.begin(); it != children.end(); it++)
+        {
+        new_children.push_back(applyMemoised(*it, more));
+        used |= more;
+        }
+
+      if (new_children == children)
+        result = n;
+      else if (n.GetValueWidth() == 0)
+        result = nf->CreateNode(k, new_children);
+      else
+        result = nf->CreateArrayTerm(k, n.GetIndexWidth(), n.GetValueWidth(), new_children);
+
+      if (result != n && SolverMap->find(result) != SolverMap->end())
+        {
+        result = applyMemoised(result, more);
+        used |= more;
+        }
+      }
+
+    assert(result.GetValueWidth() == n.GetValueWidth());
+    assert(result.GetIndexWidth() == n.GetIndexWidth());
+
+    Applied& entry = applied[n];
+    entry.result = result;
+    entry.round = round;
+    entry.used = used;
+    return result;
+  }
+
 // not always idempotent.
   ASTNode
   SubstitutionMap::applySubstitutionMapUntilArrays(const ASTNode& n)
   {
     bm->GetRunTimes()->start(RunTimes::ApplyingSubstitutions);
+    compressClasses();
     ASTNodeMap cache;
     ASTNode result = replace(n, *SolverMap, cache, nf, true, false);
     bm->GetRunTimes()->stop(RunTimes::ApplyingSubstitutions);
@@ -356,6 +479,89 @@ namespace BEEV
     return (loops);
   }
 
+  // The representative of the symbol's class, halving the path to it.
+  ASTNode
+  SubstitutionMap::findRepresentative(const ASTNode& symbol)
+  {
+    ASTNode n = symbol;
+    while (true)
+      {
+      SymbolClass* c = classes.find(n);
+      if (c == NULL || c->parent.IsNull())
+        return n;
+
+      const SymbolClass* p = classes.find(c->parent);
+      if (p != NULL && !p->parent.IsNull())
+        c->parent = p->parent;
+      n = c->parent;
+      }
+  }
+
+// Records that the symbols e0 and e1 are equal. The representatives of
+// their classes are linked, by adding one to the map as the other. A
+// representative that's already in the map (i.e. equal to something
+// other than a symbol) has to stay the representative, and if both
+// are, they can't be linked. If neither is, nothing can depend on the
+// one that's added, so there's no need to check for loops.
+  bool
+  SubstitutionMap::unionSymbols(const ASTNode& e0, const ASTNode& e1)
+  {
+    ASTNode r0 = findRepresentative(e0);
+    ASTNode r1 = findRepresentative(e1);
+    if (r0 == r1)
+      return true; // Already follows from the map.
+
+    const bool mapped0 = CheckSubstitutionMap(r0);
+    const bool mapped1 = CheckSubstitutionMap(r1);
+    if (mapped0 && mapped1)
+      return false;
+
+    // r0 is added to the map as r1. Prefer that, like the other
+    // symbol to symbol equalities are.
+    if (mapped0 || (!mapped1 && classes[r0].rank > classes[r1].rank))
+      std::swap(r0, r1);
+
+    if (CheckSubstitutionMap(r1) && loops(r0, r1))
+      return false;
+
+    SymbolClass& child = classes[r0];
+    SymbolClass& parent = classes[r1];
+    child.parent = r1;
+    if (parent.rank <= child.rank)
+      parent.rank = child.rank + 1;
+    classesCompressed = false;
+
+    buildDepends(r0, r1);
+    add(r0, r1);
+    return true;
+  }
+
+// Maps each symbol in a class to its representative, so that applying
+// the map takes at most two lookups for them. The ones that replace()
+// has already mapped to something other than a symbol are left alone.
+  void
+  SubstitutionMap::compressClasses()
+  {
+    if (classesCompressed)
+      return;
+
+    for (size_t i = 0; i < classes.size(); i++)
+      {
+      const ASTNode& symbol = classes.key(i);
+      if (classes.value(i).parent.IsNull())
+        continue;
+
+      ASTNodeMap::iterator it = SolverMap->find(symbol);
+      if (it == SolverMap->end() || it->second.GetKind() != SYMBOL)
+        continue;
+
+      const ASTNode representative = findRepresentative(symbol);
+      if (it->second != representative)
+        it->second = representative;
+      }
+    classesCompressed = true;
+  }
+
   bool
   SubstitutionMap::UpdateSubstitutionMap(const ASTNode& e0, const ASTNode& e1)
   {
@@ -367,6 +573,9 @@ namespace BEEV
     assert(e0.GetValueWidth() == e1.GetValueWidth());
     assert(e0.GetIndexWidth() == e1.GetIndexWidth());
 
+    if (e0.GetKind() == SYMBOL && e1.GetKind() == SYMBOL)
+      return unionSymbols(e0, e1);
+
     if (e0.GetKind() == SYMBOL)
       {
       if (CheckSubstitutionMap(e0))
@@ -397,7 +606,7 @@ namespace BEEV
     if (1 == i && !CheckSubstitutionMap(e0))
       {
       buildDepends(e0, e1);
-      (*SolverMap)[e0] = e1;
+      add(e0, e1);
       return true;
       }
 
@@ -406,7 +615,7 @@ namespace BEEV
     if (-1 == i && !CheckSubstitutionMap(e1))
       {
       buildDepends(e1, e0);
-      (*SolverMap)[e1] = e0;
+      add(e1, e0);
       return true;
       }
 
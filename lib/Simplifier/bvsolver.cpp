@@ -26,6 +26,9 @@ THE SOFTWARE.
 #include "stp/AST/AST.h"
 #include "stp/STPManager/STPManager.h"
 #include "stp/Simplifier/bvsolver.h"
+#include "stp/STPManager/NodeIterator.h"
+#include <ctime>
+#include <deque>
 
 //This file contains the implementation of member functions of
 //bvsolver class, which represents the bitvector arithmetic linear
@@ -557,10 +560,32 @@ namespace BEEV
     else
       c = input.GetChildren();
 
-    ASTVec eveneqns;
+    // The conjuncts are worked through in order. One that can't be
+    // solved is put aside, and tried again if a variable in it is
+    // solved for later, as the substitution might make it solvable.
+    enum State
+    {
+      Queued, Kept, Even, Solved
+    };
+    ASTVec current(c.begin(), c.end());
+    std::vector<State> state(c.size(), Queued);
+    std::deque<size_t> worklist;
+    for (size_t i = 0; i < c.size(); i++)
+      worklist.push_back(i);
+
+    // For each symbol, the kept equations that contain it.
+    hash_map<ASTNode, std::vector<size_t>, ASTNode::ASTNodeHasher, ASTNode::ASTNodeEqual> waiting;
+    const ASTVec& keys = _simp->getSubstitutedKeys();
+
+    const std::clock_t start = std::clock();
+    size_t solved = 0;
+    size_t retried = 0;
     bool any_solved = false;
-    for (ASTVec::iterator it = c.begin(), itend = c.end(); it != itend; it++)
+    while (!worklist.empty())
       {
+        const size_t i = worklist.front();
+        worklist.pop_front();
+
 		 /*
     	 Calling applySubstitutionMapUntilArrays makes the required substitutions. For instance, if
     	 first was : v = x,
@@ -579,33 +604,84 @@ namespace BEEV
     	 which shouldn't be simplified.
   	   */
 
-    	ASTNode aaa =  (any_solved && EQ == it->GetKind()) ? simplifyNode
-    			(_simp->applySubstitutionMapUntilArrays(*it)) : *it;
+    	ASTNode aaa =  (any_solved && EQ == current[i].GetKind()) ? simplifyNode
+    			(_simp->applySubstitutionMapUntilArrays(current[i])) : current[i];
 
         if (ASTFalse == aaa)
         {
         	_bm->GetRunTimes()->stop(RunTimes::BVSolver);
         	return ASTFalse; // shortcut. It's unsatisfiable.
         }
+
+        const size_t keysBefore = keys.size();
         aaa = BVSolve_Odd(aaa);
 
         bool even = false;
         aaa = CheckEvenEqn(aaa, even);
+        current[i] = aaa;
         if (even)
+          state[i] = Even;
+        else if (ASTTrue == aaa)
           {
-            eveneqns.push_back(aaa);
+            state[i] = Solved;
+            solved++;
+            any_solved = true;
           }
         else
           {
-            if (ASTTrue != aaa)
+            state[i] = Kept;
+            if (EQ == aaa.GetKind())
+              {
+                NodeIterator ni(aaa, ASTUndefined, *_bm);
+                ASTNode n;
+                while ((n = ni.next()) != ni.end())
+                  if (SYMBOL == n.GetKind())
+                    waiting[n].push_back(i);
+              }
+          }
+
+        // Wake the kept equations that contain what was just solved for.
+        for (size_t k = keysBefore; k < keys.size(); k++)
+          {
+            NodeIterator ni(keys[k], ASTUndefined, *_bm);
+            ASTNode n;
+            while ((n = ni.next()) != ni.end())
               {
-                o.push_back(aaa);
+                if (SYMBOL != n.GetKind())
+                  continue;
+                hash_map<ASTNode, std::vector<size_t>, ASTNode::ASTNodeHasher, ASTNode::ASTNodeEqual>::iterator it =
+                    waiting.find(n);
+                if (it == waiting.end())
+                  continue;
+                for (size_t j = 0; j < it->second.size(); j++)
+                  if (Kept == state[it->second[j]])
+                    {
+                      state[it->second[j]] = Queued;
+                      worklist.push_back(it->second[j]);
+                      retried++;
+                    }
+                waiting.erase(it);
               }
           }
-        if (ASTTrue == aaa)
-        	{
-               any_solved=true;
-        	}
+      }
+
+    ASTVec eveneqns;
+    for (size_t i = 0; i < c.size(); i++)
+      {
+        if (Even == state[i])
+          eveneqns.push_back(current[i]);
+        else if (Kept == state[i])
+          o.push_back(current[i]);
+      }
+
+    if (_bm->UserFlags.stats_flag)
+      {
+        const double ms = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC;
+        std::cerr << "BVSolver: solved " << solved << " of " << c.size() << " conjuncts, "
+                  << retried << " retried, in " << ms << "ms";
+        if (ms > 0)
+          std::cerr << " (" << solved / ms << " per ms)";
+        std::cerr << std::endl;
       }
 
     ASTNode evens;
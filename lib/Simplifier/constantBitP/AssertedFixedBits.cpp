@@ -0,0 +1,202 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+#include "stp/Simplifier/constantBitP/AssertedFixedBits.h"
+#include "stp/Simplifier/constantBitP/ConstantBitPropagation.h"
+#include "stp/STPManager/STPManager.h"
+
+namespace simplifier
+{
+  namespace constantBitP
+  {
+    using namespace BEEV;
+
+    AssertedFixedBits::AssertedFixedBits() :
+        fixings(1000), unsatisfiable(false)
+    {
+    }
+
+    AssertedFixedBits::~AssertedFixedBits()
+    {
+      for (size_t i = 0; i < trail.size(); i++)
+        delete trail[i].second;
+    }
+
+    void
+    AssertedFixedBits::update(const ASTVec& asserts, Simplifier* simp, NodeFactory* nf)
+    {
+      bool prefix = propagated.size() <= asserts.size();
+      for (size_t i = 0; prefix && i < propagated.size(); i++)
+        if (propagated[i] != asserts[i])
+          prefix = false;
+
+      if (!prefix)
+        reset();
+
+      if (propagated.size() == asserts.size())
+        return;
+
+      // The contexts that were pushed since the last update haven't been
+      // propagated, so their checkpoints are brought up to date as well.
+      for (size_t i = 0; i < checkpoints.size(); i++)
+        {
+          Checkpoint& c = checkpoints[i];
+          if (c.asserted <= propagated.size() || c.asserted > asserts.size())
+            continue;
+
+          // Nothing before the first checkpoint is ever undone.
+          propagate(asserts, c.asserted, i > 0, simp, nf);
+          c.trail = trail.size();
+          c.propagated = propagated.size();
+          c.unsatisfiable = unsatisfiable;
+        }
+      propagate(asserts, asserts.size(), !checkpoints.empty(), simp, nf);
+
+      if (asserts[0].GetSTPMgr()->UserFlags.stats_flag)
+        cerr << "Asserted fixed bits:" << fixings.map->size() << endl;
+    }
+
+    void
+    AssertedFixedBits::propagate(const ASTVec& asserts, size_t to, bool undoable, Simplifier* simp, NodeFactory* nf)
+    {
+      if (propagated.size() >= to)
+        return;
+
+      const ASTVec fresh(asserts.begin() + propagated.size(), asserts.begin() + to);
+      propagated.insert(propagated.end(), fresh.begin(), fresh.end());
+
+      if (unsatisfiable)
+        return;
+
+      // Only the new assertions are indexed. The nodes they share with the
+      // earlier ones start from the bits kept for them, but what's learnt
+      // about those isn't taken back up into the earlier assertions.
+      // Not simplified, so that the new assertions are the top's children.
+      STPMgr* bm = asserts[0].GetSTPMgr();
+      const ASTNode top = (fresh.size() == 1) ? fresh[0] : bm->hashingNodeFactory->CreateNode(AND, fresh);
+
+      ConstantBitPropagation cb(simp, nf, top, &fixings, fresh);
+      if (cb.isUnsatisfiable())
+        {
+          unsatisfiable = true;
+          return;
+        }
+
+      NodeToFixedBitsMap::NodeToFixedBitsMapType::iterator it;
+      for (it = cb.fixedMap->map->begin(); it != cb.fixedMap->map->end(); it++)
+        {
+          const ASTNode& n = it->first;
+          const FixedBits& bits = *it->second;
+          if (n.isConstant())
+            continue;
+
+          NodeToFixedBitsMap::NodeToFixedBitsMapType::iterator old = fixings.map->find(n);
+          FixedBits* previous = NULL;
+          if (old == fixings.map->end())
+            {
+              if (bits.countFixed() == 0)
+                continue;
+              fixings.map->insert(std::make_pair(n, new FixedBits(bits)));
+            }
+          else
+            {
+              if (FixedBits::equals(*old->second, bits))
+                continue;
+              previous = old->second;
+              old->second = new FixedBits(bits);
+            }
+
+          if (undoable)
+            trail.push_back(std::make_pair(n, previous));
+          else
+            delete previous;
+        }
+    }
+
+    void
+    AssertedFixedBits::push(size_t asserted)
+    {
+      Checkpoint c;
+      c.trail = trail.size();
+      c.propagated = propagated.size();
+      c.unsatisfiable = unsatisfiable;
+      c.asserted = asserted;
+      checkpoints.push_back(c);
+    }
+
+    void
+    AssertedFixedBits::pop()
+    {
+      if (checkpoints.empty())
+        {
+          reset();
+          return;
+        }
+
+      restore(checkpoints.back());
+      checkpoints.pop_back();
+    }
+
+    void
+    AssertedFixedBits::restore(const Checkpoint& c)
+    {
+      while (trail.size() > c.trail)
+        {
+          const ASTNode n = trail.back().first;
+          FixedBits* previous = trail.back().second;
+          trail.pop_back();
+
+          NodeToFixedBitsMap::NodeToFixedBitsMapType::iterator it = fixings.map->find(n);
+          assert(it != fixings.map->end());
+          delete it->second;
+          if (previous == NULL)
+            fixings.map->erase(it);
+          else
+            it->second = previous;
+        }
+
+      propagated.resize(c.propagated);
+      unsatisfiable = c.unsatisfiable;
+    }
+
+    // Forgets everything. The checkpoints now all go back to nothing.
+    void
+    AssertedFixedBits::reset()
+    {
+      for (size_t i = 0; i < trail.size(); i++)
+        delete trail[i].second;
+      trail.clear();
+      fixings.clear();
+      propagated.clear();
+      unsatisfiable = false;
+
+      for (size_t i = 0; i < checkpoints.size(); i++)
+        {
+          checkpoints[i].trail = 0;
+          checkpoints[i].propagated = 0;
+          checkpoints[i].unsatisfiable = false;
+        }
+    }
+  }
+}
@@ -242,10 +242,86 @@ void setValue(FixedBits& a, const int i, bool v)
   a.setValue(i,v);
 }
 
+typedef FixedBits::Word Word;
+
+// The sum of a, b and the carry in. The carry out is written to carry.
+static Word addWords(Word a, Word b, Word& carry)
+{
+  const Word sum = a + b;
+  const Word result = sum + carry;
+  carry = (sum < a || result < sum) ? 1 : 0;
+  return result;
+}
+
+// Fixes output to a + b + carry, a and b being totally fixed.
+static Result fixToSum(const FixedBits& a, const FixedBits& b, Word carry, bool negateB, FixedBits& output)
+{
+  for (unsigned w = 0; w < output.numberOfWords(); w++)
+    {
+      const Word bValue = negateB ? ~b.getValueWord(w) : b.getValueWord(w);
+      const Word sum = addWords(a.getValueWord(w), bValue, carry);
+      if ((output.getFixedWord(w) & (output.getValueWord(w) ^ sum) & output.widthMask(w)) != 0)
+        return CONFLICT;
+      output.fixWord(w, ~output.getFixedWord(w), sum);
+    }
+  return NOT_IMPLEMENTED;
+}
+
+// The cases of two operand addition that can be done a word at a time. They give
+// the same as the column by column propagation below. Returns false if it's not
+// one of those cases.
+static bool
+bvAddWordsBothWays(FixedBits& x, FixedBits& y, FixedBits& output, Result& result)
+{
+  if (x.isTotallyFixed() && y.isTotallyFixed())
+    {
+      result = fixToSum(x, y, 0, false, output);
+      return true;
+    }
+
+  if (output.isTotallyFixed() && (x.isTotallyFixed() || y.isTotallyFixed()))
+    {
+      // The other operand is the output minus the fixed one.
+      FixedBits& fixedOperand = x.isTotallyFixed() ? x : y;
+      FixedBits& other = x.isTotallyFixed() ? y : x;
+      result = fixToSum(output, fixedOperand, 1, true, other);
+      return true;
+    }
+
+  if (output.countFixed() != 0)
+    return false;
+
+  // Nothing is known about the output, so nothing is pushed back to the operands.
+  // A carry is known to be one if the carry of the known ones is. It's known to be
+  // zero if the carry of the possible ones is.
+  Word carryOne = 0;
+  Word carryPossible = 0;
+  for (unsigned w = 0; w < output.numberOfWords(); w++)
+    {
+      const Word mask = output.widthMask(w);
+      const Word xOne = x.getFixedWord(w) & x.getValueWord(w);
+      const Word yOne = y.getFixedWord(w) & y.getValueWord(w);
+      const Word xPossible = (~x.getFixedWord(w) | x.getValueWord(w)) & mask;
+      const Word yPossible = (~y.getFixedWord(w) | y.getValueWord(w)) & mask;
+
+      const Word carriedOne = addWords(xOne, yOne, carryOne) ^ xOne ^ yOne;
+      const Word carriedPossible = addWords(xPossible, yPossible, carryPossible) ^ xPossible ^ yPossible;
+
+      const Word known = x.getFixedWord(w) & y.getFixedWord(w) & (carriedOne | ~carriedPossible);
+      output.fixWord(w, known, xOne ^ yOne ^ carriedOne);
+    }
+  result = NOT_IMPLEMENTED;
+  return true;
+}
+
 // Specialisation for two operands.
     Result
     bvAddBothWays(FixedBits& x, FixedBits& y, FixedBits& output)
     {
+      Result wordResult;
+      if (bvAddWordsBothWays(x, y, output, wordResult))
+        return wordResult;
+
       const int bitWidth = output.getWidth();
       FixedBits carry(bitWidth + 1, false);
       carry.setFixed(0, true);
@@ -35,38 +35,71 @@ namespace simplifier
 namespace constantBitP
 {
 
+// The columns are independent, so each of these works on a word of columns at
+// a time. The rules applied to each column are the same as applying them a bit
+// at a time.
+typedef FixedBits::Word Word;
+
+// Summarises a word of columns.
+struct WordStats
+{
+	Word one; // Some operand is fixed to one.
+	Word zero; // Some operand is fixed to zero.
+	Word unfixedOnce; // Some operand is unfixed.
+	Word unfixedTwice; // At least two operands are unfixed.
+	Word parity; // The xor of the operands fixed to one.
+};
+
+static WordStats getWordStats(const vector<FixedBits*>& operands, unsigned w)
+{
+	WordStats s = {0, 0, 0, 0, 0};
+	for (size_t j = 0; j < operands.size(); j++)
+	{
+		const Word fixed = operands[j]->getFixedWord(w);
+		const Word value = operands[j]->getValueWord(w);
+		s.one |= fixed & value;
+		s.zero |= fixed & ~value;
+		s.parity ^= fixed & value;
+		s.unfixedTwice |= s.unfixedOnce & ~fixed;
+		s.unfixedOnce |= ~fixed;
+	}
+	return s;
+}
+
+// Fixes the operands' unfixed bits of word w that are in mask.
+static void fixUnfixedWordTo(vector<FixedBits*>& operands, unsigned w, Word mask, Word value)
+{
+	for (size_t j = 0; j < operands.size(); j++)
+		operands[j]->fixWord(w, mask & ~operands[j]->getFixedWord(w), value);
+}
+
 Result bvXorBothWays(vector<FixedBits*>& operands, FixedBits& output)
 {
 	Result result = NO_CHANGE;
-	const int bitWidth = output.getWidth();
 
-	for (int i = 0; i < bitWidth; i++)
+	for (unsigned w = 0; w < output.numberOfWords(); w++)
 	{
-		const stats status = getStats(operands, i);
+		const WordStats status = getWordStats(operands, w);
+		const Word mask = output.widthMask(w);
+		const Word outFixed = output.getFixedWord(w);
+		const Word outValue = output.getValueWord(w);
+
+		// if they are all fixed. We know the answer.
+		const Word allFixed = ~status.unfixedOnce & mask;
+		if ((allFixed & outFixed & (outValue ^ status.parity)) != 0)
+			return CONFLICT;
 
-		if (status.unfixed == 0) // if they are all fixed. We know the answer.
+		if ((allFixed & ~outFixed) != 0)
 		{
-			bool answer = (status.fixedToOne % 2) != 0;
-
-			if (!output.isFixed(i))
-			{
-				output.setFixed(i, true);
-				output.setValue(i, answer);
-				result = CHANGED;
-			}
-			else if (output.getValue(i) != answer)
-				return CONFLICT;
+			output.fixWord(w, allFixed & ~outFixed, status.parity);
+			result = CHANGED;
 		}
-		else if (status.unfixed == 1 && output.isFixed(i))
+
+		// If there is just one unfixed, and we have the answer --> We know the value.
+		const Word oneUnfixed = status.unfixedOnce & ~status.unfixedTwice & outFixed & mask;
+		if (oneUnfixed != 0)
 		{
-			// If there is just one unfixed, and we have the answer --> We know the value.
-			bool soFar = ((status.fixedToOne % 2) != 0);
-			if (soFar != output.getValue(i))
-			{ // result needs to be flipped.
-				fixUnfixedTo(operands, i, true);
-			}
-			else
-				fixUnfixedTo(operands, i, false);
+			fixUnfixedWordTo(operands, w, oneUnfixed, status.parity ^ outValue);
 			result = CHANGED;
 		}
 	}
@@ -79,50 +112,44 @@ Result bvXorBothWays(vector<FixedBits*>& operands, FixedBits& output)
 Result bvAndBothWays(vector<FixedBits*>& operands, FixedBits& output)
 {
 	Result result = NO_CHANGE;
-	const int bitWidth = output.getWidth();
 
-	for (int i = 0; i < bitWidth; i++)
+	for (unsigned w = 0; w < output.numberOfWords(); w++)
 	{
-		const stats status = getStats(operands, i);
+		const WordStats status = getWordStats(operands, w);
+		const Word mask = output.widthMask(w);
+		const Word outFixed = output.getFixedWord(w);
+		const Word outOne = outFixed & output.getValueWord(w);
+		const Word outZero = outFixed & ~output.getValueWord(w);
+		const Word allOne = ~status.zero & ~status.unfixedOnce & mask;
 
 		// output is fixed to one. But an input value is false!
-		if (output.isFixed(i) && output.getValue(i) && status.fixedToZero > 0)
+		if ((outOne & status.zero) != 0)
 			return CONFLICT;
 
-		// output is fixed to one. But an input value is false!
-		if (output.isFixed(i) && !output.getValue(i) && status.fixedToZero == 0
-				&& status.unfixed == 0)
+		// output is fixed to zero. But all the inputs are true!
+		if ((outZero & allOne) != 0)
 			return CONFLICT;
 
 		// output is fixed to one. So all should be one.
-		if (output.isFixed(i) && output.getValue(i) && status.unfixed > 0)
-		{
-			fixUnfixedTo(operands, i, true);
-			result = CHANGED;
-		}
-
-		// The output is unfixed. At least one input is false.
-		if (!output.isFixed(i) && status.fixedToZero > 0)
+		if ((outOne & status.unfixedOnce) != 0)
 		{
-			output.setFixed(i, true);
-			output.setValue(i, false);
+			fixUnfixedWordTo(operands, w, outOne & status.unfixedOnce, ~(Word) 0);
 			result = CHANGED;
 		}
 
-		// Everything is fixed to one!
-		if (!output.isFixed(i) && status.fixedToZero == 0 && status.unfixed
-				== 0)
+		// The output is unfixed. At least one input is false, or everything is fixed to one!
+		const Word known = ~outFixed & (status.zero | allOne) & mask;
+		if (known != 0)
 		{
-			output.setFixed(i, true);
-			output.setValue(i, true);
+			output.fixWord(w, known, allOne);
 			result = CHANGED;
 		}
 
 		// If the output is false, and there is a single unfixed value with everything else true..
-		if (output.isFixed(i) && !output.getValue(i) && status.fixedToZero == 0
-				&& status.unfixed == 1)
+		const Word single = outZero & ~status.zero & status.unfixedOnce & ~status.unfixedTwice;
+		if (single != 0)
 		{
-			fixUnfixedTo(operands, i, false);
+			fixUnfixedWordTo(operands, w, single, 0);
 			result = CHANGED;
 		}
 	}
@@ -132,97 +159,45 @@ Result bvAndBothWays(vector<FixedBits*>& operands, FixedBits& output)
 Result bvOrBothWays(vector<FixedBits*>& children, FixedBits& output)
 {
 	Result r = NO_CHANGE;
-	const int numberOfChildren = children.size();
-	const int bitWidth = output.getWidth();
 
-	for (int i = 0; i < bitWidth; i++)
+	for (unsigned w = 0; w < output.numberOfWords(); w++)
 	{
-		bool answerKnown = output.isFixed(i);
-		bool answer = false;
-		if (answerKnown)
-			answer = output.getValue(i);
-
-		int unks = 0;
-		int ones = 0;
-		int zeroes = 0;
-
-		for (int j = 0; j < numberOfChildren; j++)
-		{
-			assert(output.getWidth() == children[j]->getWidth());
-
-			if (!children[j]->isFixed(i))
-				unks++;
-			else if (children[j]->getValue(i))
-				ones++;
-			else
-				zeroes++;
-		}
-
-		if (ones > 0) // Atleast a single one found!
-
-		{
-			if (answerKnown && !answer)
-				return CONFLICT;
-
-			if (!answerKnown)
-			{
-				output.setFixed(i, true);
-				output.setValue(i, true);
-				r = CHANGED;
-			}
-		}
+		const WordStats status = getWordStats(children, w);
+		const Word mask = output.widthMask(w);
+		const Word outFixed = output.getFixedWord(w);
+		const Word outOne = outFixed & output.getValueWord(w);
+		const Word outZero = outFixed & ~output.getValueWord(w);
+		const Word allZero = ~status.one & ~status.unfixedOnce & mask;
+
+		// Atleast a single one found! But the answer is false.
+		if ((outZero & status.one) != 0)
+			return CONFLICT;
 
-		if (zeroes == numberOfChildren) // all zeroes.
+		// All zeroes. But the answer is true.
+		if ((outOne & allZero) != 0)
+			return CONFLICT;
 
+		const Word known = ~outFixed & (status.one | allZero) & mask;
+		if (known != 0)
 		{
-			if (answerKnown && answer)
-				return CONFLICT;
-
-			if (!answerKnown)
-			{
-				r = CHANGED;
-				output.setFixed(i, true);
-				output.setValue(i, false);
-
-			}
+			output.fixWord(w, known, status.one);
+			r = CHANGED;
 		}
 
-		if (answerKnown && !answer) // known false
-
+		// known false. set all the column to false.
+		if ((outZero & status.unfixedOnce) != 0)
 		{
-			if (ones > 0)
-				return CONFLICT;
-
-			// set all the column to false.
-
-			for (int j = 0; j < numberOfChildren; j++)
-			{
-				if (!children[j]->isFixed(i))
-				{
-					r = CHANGED;
-					children[j]->setFixed(i, true);
-					children[j]->setValue(i, false);
-				}
-			}
-
+			fixUnfixedWordTo(children, w, outZero & status.unfixedOnce, 0);
+			r = CHANGED;
 		}
 
-		if (unks == 1 && answerKnown && answer && (zeroes == (numberOfChildren
-				- 1)))
+		// A single unknown, everything else is false. The answer is true. So the unknown is true.
+		const Word single = outOne & ~status.one & status.unfixedOnce & ~status.unfixedTwice;
+		if (single != 0)
 		{
-			// A single unknown, everything else is false. The answer is true. So the unknown is true.
-
-			for (int j = 0; j < numberOfChildren; j++)
-			{
-				if (!children[j]->isFixed(i))
-				{
-					r = CHANGED;
-					children[j]->setFixed(i, true);
-					children[j]->setValue(i, true);
-				}
-			}
+			fixUnfixedWordTo(children, w, single, ~(Word) 0);
+			r = CHANGED;
 		}
-
 	}
 	return r;
 }
@@ -323,30 +298,27 @@ Result bvImpliesBothWays(vector<FixedBits*>& children, FixedBits& result)
 Result bvNotBothWays(FixedBits& a, FixedBits& output)
 {
 	assert(a.getWidth() == output.getWidth());
-	const int bitWidth = a.getWidth();
 
 	Result result = NO_CHANGE;
 
-	for (int i = 0; i < bitWidth; i++)
+	for (unsigned w = 0; w < a.numberOfWords(); w++)
 	{
+		const Word aFixed = a.getFixedWord(w);
+		const Word outFixed = output.getFixedWord(w);
+
 		// error if they are the same.
-		if (a.isFixed(i) && output.isFixed(i) && (a.getValue(i)
-				== output.getValue(i)))
-		{
+		if ((aFixed & outFixed & ~(a.getValueWord(w) ^ output.getValueWord(w))) != 0)
 			return CONFLICT;
-		}
 
-		if (a.isFixed(i) && !output.isFixed(i))
+		if ((aFixed & ~outFixed) != 0)
 		{
-			output.setFixed(i, true);
-			output.setValue(i, !a.getValue(i));
+			output.fixWord(w, aFixed & ~outFixed, ~a.getValueWord(w));
 			result = CHANGED;
 		}
 
-		if (output.isFixed(i) && !a.isFixed(i))
+		if ((outFixed & ~aFixed) != 0)
 		{
-			a.setFixed(i, true);
-			a.setValue(i, !output.getValue(i));
+			a.fixWord(w, outFixed & ~aFixed, ~output.getValueWord(w));
 			result = CHANGED;
 		}
 	}
@@ -133,21 +133,20 @@ bool
 fast_exit(FixedBits& c0, FixedBits& c1)
 {
   assert(c0.getWidth() == c1.getWidth());
-  for (int i = (int)c0.getWidth() - 1; i >= 0; i--) {
-      const char c_0 = c0[i];
-      const char c_1 = c1[i];
-
-      if (c_0 == '0') {
-          if (c_1 == '0')
-            continue;
-      } else if (c_0 == '1') {
-          if (c_1 == '1')
-            continue;
-      } else if (c_0 == '*' && c_1 == '*') {
-          return true;
-      }
-      return false;
+  typedef FixedBits::Word Word;
+
+  // Find the topmost bit that isn't fixed to the same value in both. True if
+  // it's unfixed in both.
+  for (int w = (int)c0.numberOfWords() - 1; w >= 0; w--) {
+      const Word f0 = c0.getFixedWord(w);
+      const Word f1 = c1.getFixedWord(w);
+      const Word same = f0 & f1 & ~(c0.getValueWord(w) ^ c1.getValueWord(w));
+      const Word different = ~same & c0.widthMask(w);
+
+      if (different != 0)
+        return ((~f0 & ~f1) >> FixedBits::highestOne(different)) & 1;
    }
+  return false;
 }
 
 
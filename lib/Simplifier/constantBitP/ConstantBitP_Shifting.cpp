@@ -42,6 +42,30 @@ namespace constantBitP
 
 const bool debug_shift = false;
 
+// When the shift is totally fixed, the operand is moved along a word at a time,
+// and zeroes are shifted into the output. It's what the general case below
+// computes when there's just one possible shift.
+static Result shiftByConstant(FixedBits& op, const FixedBits& shift, FixedBits& output, bool left)
+{
+	assert(shift.isTotallyFixed());
+	const unsigned bitWidth = output.getWidth();
+
+	unsigned minShift, maxShift;
+	shift.getUnsignedMinMax(minShift, maxShift);
+	const unsigned amount = std::min(minShift, bitWidth);
+
+	const unsigned opFrom = left ? 0 : amount;
+	const unsigned outputFrom = left ? amount : 0;
+	if (CONFLICT == makeEqual(op, opFrom, output, outputFrom, bitWidth - amount))
+		return CONFLICT;
+
+	const unsigned zeroesFrom = left ? 0 : bitWidth - amount;
+	if (CONFLICT == fixRangeTo(output, zeroesFrom, zeroesFrom + amount, false))
+		return CONFLICT;
+
+	return NOT_IMPLEMENTED;
+}
+
 Result bvRightShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 {
 	Result result = NO_CHANGE;
@@ -52,6 +76,9 @@ Result bvRightShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 	FixedBits& op = *children[0];
 	FixedBits& shift = *children[1];
 
+	if (shift.isTotallyFixed())
+		return shiftByConstant(op, shift, output, false);
+
 	FixedBits outputReverse(bitWidth,false);
 	FixedBits opReverse(bitWidth,false);
 
@@ -594,6 +621,9 @@ Result bvLeftShiftBothWays(vector<FixedBits*>& children, FixedBits& output)
 		cerr << "output:" << output << endl;
 	}
 
+	if (shift.isTotallyFixed())
+		return shiftByConstant(op, shift, output, true);
+
 	// The topmost number of possible shifts corresponds to all
 	// the values of shift that shift out everything.
 	// i.e. possibleShift[bitWidth+1] is the SET of all operations that shift past the end.
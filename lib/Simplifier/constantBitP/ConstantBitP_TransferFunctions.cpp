@@ -48,33 +48,32 @@ Result bvEqualsBothWays(FixedBits& a, FixedBits& b, FixedBits& output)
 	assert(a.getWidth() == b.getWidth());
 	assert(1 == output.getWidth());
 
+	typedef FixedBits::Word Word;
 	const int childWidth = a.getWidth();
 
 	Result r = NO_CHANGE;
 
-	bool allSame = true;
 	bool definatelyFalse = false;
+	unsigned unknown = 0; // The number of unfixed bits in a and b.
 
-	for (int i = 0; i < childWidth; i++)
+	for (unsigned w = 0; w < a.numberOfWords(); w++)
 	{
-		// if both fixed
-		if (a.isFixed(i) && b.isFixed(i))
+		const Word mask = a.widthMask(w);
+		const Word aFixed = a.getFixedWord(w);
+		const Word bFixed = b.getFixedWord(w);
+
+		// if both fixed. And have different values.
+		if ((aFixed & bFixed & (a.getValueWord(w) ^ b.getValueWord(w))) != 0)
 		{
-			// And have different values.
-			if (a.getValue(i) != b.getValue(i))
-			{
-				definatelyFalse = true;
-				break;
-			}
-			else
-			{
-				allSame &= true;
-				continue;
-			}
+			definatelyFalse = true;
+			break;
 		}
-		allSame &= false;
+
+		unknown += FixedBits::popcount(~aFixed & mask) + FixedBits::popcount(~bFixed & mask);
 	}
 
+	const bool allSame = !definatelyFalse && unknown == 0;
+
 	if (definatelyFalse)
 	{
 		if (output.isFixed(0) && output.getValue(0))
@@ -104,67 +103,27 @@ Result bvEqualsBothWays(FixedBits& a, FixedBits& b, FixedBits& output)
 
 	if (output.isFixed(0) && output.getValue(0)) // all should be the same.
 	{
-		for (int i = 0; i < childWidth; i++)
-		{
-			if (a.isFixed(i) && b.isFixed(i))
-			{
-				if (a.getValue(i) != b.getValue(i))
-				{
-					return CONFLICT;
-				}
-			}
-			else if (a.isFixed(i) != b.isFixed(i)) // both same but only one is fixed.
-			{
-				if (a.isFixed(i))
-				{
-					b.setFixed(i, true);
-					b.setValue(i, a.getValue(i));
-					r = CHANGED;
-				}
-				else
-				{
-					a.setFixed(i, true);
-					a.setValue(i, b.getValue(i));
-					r = CHANGED;
-				}
-			}
-		}
+		Result r2 = makeEqual(a, b, 0, childWidth);
+		if (CONFLICT == r2)
+			return CONFLICT;
+		if (CHANGED == r2)
+			r = CHANGED;
 	}
 
 	// if the result is fixed to false, there is a single unspecied value, and all the rest are the same. Fix it to the opposite.
-	if (output.isFixed(0) && !output.getValue(0))
+	if (output.isFixed(0) && !output.getValue(0) && !definatelyFalse && 1 == unknown)
 	{
-		int unknown = 0;
-
-		for (int i = 0; i < childWidth && unknown < 2; i++)
+		for (unsigned w = 0; w < a.numberOfWords(); w++)
 		{
-			if (!a.isFixed(i))
-				unknown++;
-			if (!b.isFixed(i))
-				unknown++;
-			else if (a.isFixed(i) && b.isFixed(i) && a.getValue(i) != b.getValue(i))
-			{
-				unknown = 10; // hack, don't do the next loop.
-				break;
-			}
-		}
+			const Word mask = a.widthMask(w);
+			const Word aFixed = a.getFixedWord(w);
+			const Word bFixed = b.getFixedWord(w);
 
-		if (1 == unknown)
-		{
-			for (int i = 0; i < childWidth; i++)
+			if (((aFixed & bFixed) & mask) != mask)
 			{
-				if (!a.isFixed(i))
-				{
-					a.setFixed(i, true);
-					a.setValue(i, !b.getValue(i));
-					r = CHANGED;
-				}
-				if (!b.isFixed(i))
-				{
-					b.setFixed(i, true);
-					b.setValue(i, !a.getValue(i));
-					r = CHANGED;
-				}
+				a.fixWord(w, ~aFixed, ~b.getValueWord(w));
+				b.fixWord(w, ~bFixed, ~a.getValueWord(w));
+				r = CHANGED;
 			}
 		}
 	}
@@ -191,17 +150,12 @@ Result bvZeroExtendBothWays(vector<FixedBits*>& children, FixedBits& output)
 		return CONFLICT;
 
 	// Fix all the topmost bits of the output to zero.
-	for (int i = inputBitWidth; i < outputBitWidth; i++)
-	{
-		if (output.isFixed(i) && output.getValue(i))
-			return CONFLICT; // set to one. Never right.
-		else if (!output.isFixed(i))
-		{
-			output.setFixed(i, true);
-			output.setValue(i, false);
-			result = CHANGED;
-		}
-	}
+	Result result2 = fixRangeTo(output, inputBitWidth, outputBitWidth, false);
+	if (CONFLICT == result2)
+		return CONFLICT; // set to one. Never right.
+	if (CHANGED == result2)
+		result = CHANGED;
+
 	return result;
 }
 
@@ -223,11 +177,12 @@ Result bvSignExtendBothWays(vector<FixedBits*>& children, FixedBits& output)
 	// They should all be fixed to the same value.
 	bool found = false;
 	bool setTo;
-	for (int i = inputBitWidth - /**/1 /**/; i < outputBitWidth; i++)
+	for (int i = inputBitWidth - 1; i < outputBitWidth; i += FixedBits::bitsPerWord)
 	{
-		if (output.isFixed(i))
+		const FixedBits::Word fixed = output.getFixedAt(i) & FixedBits::lowBits(std::min((unsigned) (outputBitWidth - i), FixedBits::bitsPerWord));
+		if (fixed != 0)
 		{
-			setTo = output.getValue(i);
+			setTo = output.getValue(i + FixedBits::lowestOne(fixed));
 			found = true;
 			break;
 		}
@@ -235,19 +190,14 @@ Result bvSignExtendBothWays(vector<FixedBits*>& children, FixedBits& output)
 
 	if (found)
 	{
-		for (int i = inputBitWidth - 1; i < outputBitWidth; i++)
-		{
-			if (output.isFixed(i) && (output.getValue(i) != setTo))
-				return CONFLICT; // if any are set to the wrong value! bad.
-			else if (!output.isFixed(i))
-			{
-				output.setFixed(i, true);
-				output.setValue(i, setTo);
-				result = CHANGED;
-			}
-		}
+		// if any are set to the wrong value! bad.
+		Result result2 = fixRangeTo(output, inputBitWidth - 1, outputBitWidth, setTo);
+		if (CONFLICT == result2)
+			return CONFLICT;
+		if (CHANGED == result2)
+			result = CHANGED;
 
-		Result result2 = makeEqual(input, output, 0, inputBitWidth);
+		result2 = makeEqual(input, output, 0, inputBitWidth);
 		if (CONFLICT == result2)
 			return CONFLICT;
 
@@ -273,30 +223,7 @@ Result bvExtractBothWays(vector<FixedBits*>& children, FixedBits& output)
 	assert(top - bottom + 1 == outputBitWidth);
 	assert(top < input.getWidth());
 
-	for (unsigned outputPosition = 0; outputPosition < outputBitWidth; outputPosition++)
-	{
-		unsigned inputPosition = outputPosition + bottom;
-
-		if (input.isFixed(inputPosition) && output.isFixed(outputPosition))
-			if (input.getValue(inputPosition) ^ output.getValue(outputPosition))
-				return CONFLICT;
-
-		if (input.isFixed(inputPosition) ^ output.isFixed(outputPosition))
-		{
-			if (input.isFixed(inputPosition))
-			{
-				output.setFixed(outputPosition, true);
-				output.setValue(outputPosition, input.getValue(inputPosition));
-				result = CHANGED;
-			}
-			else
-			{
-				input.setFixed(inputPosition, true);
-				input.setValue(inputPosition, output.getValue(outputPosition));
-				result = CHANGED;
-			}
-		}
-	}
+	result = makeEqual(input, bottom, output, 0, outputBitWidth);
 
 	//cerr << "extract[" << top << ":" << bottom << "]" << input << "=" << output<< endl;
 
@@ -351,28 +278,12 @@ Result bvConcatBothWays(vector<FixedBits*>& children, FixedBits& output)
 	for (int i = (int)numberOfChildren - 1; i >= 0; i--) // least significant is last.
 	{
 		FixedBits& child = *children[i];
-		for (unsigned j = 0; j < child.getWidth(); j++)
-		{
-			// values are different. Bad.
-			if (output.isFixed(current) && child.isFixed(j) && (output.getValue(current) != child.getValue(j)))
-				return CONFLICT;
-
-			if (output.isFixed(current) && !child.isFixed(j))
-			{
-				// only output is fixed.
-				child.setFixed(j, true);
-				child.setValue(j, output.getValue(current));
-				r = CHANGED;
-			}
-			else if (!output.isFixed(current) && child.isFixed(j))
-			{
-				// only input is fixed.
-				output.setFixed(current, true);
-				output.setValue(current, child.getValue(j));
-				r = CHANGED;
-			}
-			current++;
-		}
+		const Result childResult = makeEqual(child, 0, output, current, child.getWidth());
+		if (CONFLICT == childResult)
+			return CONFLICT;
+		if (CHANGED == childResult)
+			r = CHANGED;
+		current += child.getWidth();
 	}
 	return r;
 }
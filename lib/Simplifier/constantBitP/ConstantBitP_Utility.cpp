@@ -83,93 +83,96 @@ Result makeEqual(FixedBits& a, FixedBits& b, unsigned from, unsigned to)
 	assert(from <= a.getWidth());
 	assert(from <= b.getWidth());
 
+	return makeEqual(a, from, b, from, to - from);
+}
+
+// Makes bits [aFrom, aFrom+length) of a equal to bits [bFrom, bFrom+length) of b,
+// a word at a time.
+Result makeEqual(FixedBits& a, unsigned aFrom, FixedBits& b, unsigned bFrom, unsigned length)
+{
+	assert(aFrom + length <= a.getWidth());
+	assert(bFrom + length <= b.getWidth());
+
+	typedef FixedBits::Word Word;
 	Result result = NO_CHANGE;
-	for (unsigned i = from; i < to; i++)
+	for (unsigned i = 0; i < length; i += FixedBits::bitsPerWord)
 	{
-		if (a.isFixed(i) && !b.isFixed(i))
+		const Word mask = FixedBits::lowBits(std::min(length - i, FixedBits::bitsPerWord));
+		const Word fa = a.getFixedAt(aFrom + i) & mask;
+		const Word fb = b.getFixedAt(bFrom + i) & mask;
+		const Word va = a.getValueAt(aFrom + i);
+		const Word vb = b.getValueAt(bFrom + i);
+
+		if ((fa & fb & (va ^ vb)) != 0)
+			return CONFLICT;
+
+		if ((fa ^ fb) != 0)
 		{
-			b.setFixed(i, true);
-			b.setValue(i, a.getValue(i));
+			b.fixAt(bFrom + i, fa & ~fb, va);
+			a.fixAt(aFrom + i, fb & ~fa, vb);
 			result = CHANGED;
 		}
-		else if (b.isFixed(i) && !a.isFixed(i))
+	}
+	return result;
+}
+
+Result fixRangeTo(FixedBits& a, unsigned from, unsigned to, bool value)
+{
+	assert(from <= to && to <= a.getWidth());
+
+	typedef FixedBits::Word Word;
+	Result result = NO_CHANGE;
+	for (unsigned i = from; i < to; i += FixedBits::bitsPerWord)
+	{
+		const Word mask = FixedBits::lowBits(std::min(to - i, FixedBits::bitsPerWord));
+		const Word f = a.getFixedAt(i) & mask;
+		const Word v = value ? ~(Word) 0 : 0;
+
+		if ((f & (a.getValueAt(i) ^ v)) != 0)
+			return CONFLICT;
+
+		if (f != mask)
 		{
-			a.setFixed(i, true);
-			a.setValue(i, b.getValue(i));
+			a.fixAt(i, mask & ~f, v);
 			result = CHANGED;
 		}
-		else if (b.isFixed(i) && a.isFixed(i))
-		{
-			if (a.getValue(i) != b.getValue(i))
-				return CONFLICT;
-		}
 	}
 	return result;
 }
 
+// The bit vectors' words are 32 bits.
 void setSignedMinMax(FixedBits& v, CBV min, CBV max)
 {
 	const unsigned int msb = v.getWidth() - 1;
 
-	for (unsigned i = 0; i < (unsigned) v.getWidth(); i++)
+	for (unsigned i = 0; i < CONSTANTBV::BitVector_Size(v.getWidth()); i++)
 	{
-		if (v.isFixed(i))
-		{
-			if (v.getValue(i)) // if it's on. It's on.
-
-			{
-				CONSTANTBV::BitVector_Bit_On(max, i);
-				CONSTANTBV::BitVector_Bit_On(min, i);
-			}
-			else
-			{
-				CONSTANTBV::BitVector_Bit_Off(max, i);
-				CONSTANTBV::BitVector_Bit_Off(min, i);
-			}
-		}
-		else
-		{
-			if (i != msb)
-			{ // not fixed. Make the maximum Maximum.
-				CONSTANTBV::BitVector_Bit_On(max, i);
-				CONSTANTBV::BitVector_Bit_Off(min, i);
-			}
-			else
-			{ //except for the msb. Where we reduce the min.
-				CONSTANTBV::BitVector_Bit_On(min, i);
-				CONSTANTBV::BitVector_Bit_Off(max, i);
-			}
-		}
+		const FixedBits::Word fixed = v.getFixedAt(32 * i);
+		const FixedBits::Word one = fixed & v.getValueAt(32 * i);
+		FixedBits::Word unfixed = ~fixed;
+
+		// Unfixed. Make the maximum Maximum, except for the msb. Where we reduce the min.
+		FixedBits::Word unfixedMsb = 0;
+		if (msb / 32 == i)
+			unfixedMsb = unfixed & ((FixedBits::Word) 1 << (msb % 32));
+		unfixed &= ~unfixedMsb;
+
+		CONSTANTBV::BitVector_Word_Store(max, i, (unsigned) (one | unfixed));
+		CONSTANTBV::BitVector_Word_Store(min, i, (unsigned) (one | unfixedMsb));
 	}
 	assert(CONSTANTBV::BitVector_Compare(min,max) <=0);
 }
 
 void setUnsignedMinMax(const FixedBits& v, CBV min, CBV max)
 {
-	CONSTANTBV::BitVector_Fill(max);
-	CONSTANTBV::BitVector_Empty(min);
-
-	for (unsigned i = 0; i < v.getWidth(); i++)
+	for (unsigned i = 0; i < CONSTANTBV::BitVector_Size(v.getWidth()); i++)
 	{
-		if (v.isFixed(i))
-		{
-			if (v.getValue(i)) // if it's on. It's on.
+		const FixedBits::Word fixed = v.getFixedAt(32 * i);
+		const FixedBits::Word value = v.getValueAt(32 * i);
 
-			{
-				//CONSTANTBV::BitVector_Bit_On(max, i);
-				CONSTANTBV::BitVector_Bit_On(min, i);
-			}
-			else
-			{
-				CONSTANTBV::BitVector_Bit_Off(max, i);
-				//CONSTANTBV::BitVector_Bit_Off(min, i);
-			}
-		}
-		//else // not fixed. Just set the max.
-		//{
-		//	CONSTANTBV::BitVector_Bit_On(max, i);
-		//	CONSTANTBV::BitVector_Bit_Off(min, i);
-		//}
+		// The unfixed bits are off in the minimum, and on in the maximum.
+		CONSTANTBV::BitVector_Word_Store(min, i, (unsigned) (fixed & value));
+		CONSTANTBV::BitVector_Word_Store(max, i, (unsigned) ~(fixed & ~value));
 	}
 	assert(CONSTANTBV::BitVector_Lexicompare(min,max) <=0);
 }
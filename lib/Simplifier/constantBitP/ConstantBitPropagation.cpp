@@ -53,7 +53,7 @@ namespace simplifier
 {
   namespace constantBitP
   {
-    NodeToFixedBitsMap* PrintingHackfixedMap; // Used when debugging.
+    thread_local NodeToFixedBitsMap* PrintingHackfixedMap; // Used when debugging.
 
     Result
     dispatchToTransferFunctions(const Kind k, vector<FixedBits*>& children,
@@ -170,10 +170,81 @@ namespace simplifier
       topFB.setFixed(0, true);
       topFB.setValue(0, true);
       workList->push(top);
+
+      if (asserted != NULL)
+        addAsserted();
+    }
+
+    // Copies the asserted fixings into the nodes of the formula. They're at a
+    // fixed point already, so a node is only scheduled if it knew more than
+    // them, and a node that knew less only schedules the parents that weren't
+    // asserted. Whichever of the fixings and the formula is smaller is walked.
+    void
+    ConstantBitPropagation::addAsserted()
+    {
+      if (asserted->map->size() < dependents->size())
+        {
+          NodeToFixedBitsMap::NodeToFixedBitsMapType::const_iterator it;
+          for (it = asserted->map->begin(); it != asserted->map->end(); it++)
+            if (dependents->contains(it->first) && !addAsserted(it->first, *it->second))
+              return;
+          return;
+        }
+
+      for (unsigned r = 0; r < dependents->size(); r++)
+        {
+          const ASTNode& n = dependents->node(r);
+          NodeToFixedBitsMap::NodeToFixedBitsMapType::const_iterator it = asserted->map->find(n);
+          if (it != asserted->map->end() && !addAsserted(n, *it->second))
+            return;
+        }
+    }
+
+    bool
+    ConstantBitPropagation::addAsserted(const ASTNode& n, const FixedBits& from)
+    {
+      FixedBits& current = *getCurrentFixedBits(n);
+      assert(from.getWidth() == current.getWidth());
+
+      bool gained = false;
+      bool knewMore = false;
+      for (unsigned w = 0; w < current.numberOfWords(); w++)
+        {
+          const FixedBits::Word both = from.getFixedWord(w) & current.getFixedWord(w);
+          if (((from.getValueWord(w) ^ current.getValueWord(w)) & both) != 0)
+            {
+              status = CONFLICT;
+              return false;
+            }
+
+          const FixedBits::Word newBits = from.getFixedWord(w) & ~current.getFixedWord(w);
+          if (current.getFixedWord(w) & ~from.getFixedWord(w))
+            knewMore = true;
+          if (newBits != 0)
+            {
+              current.fixWord(w, newBits, from.getValueWord(w));
+              gained = true;
+            }
+        }
+
+      if (knewMore)
+        {
+          scheduleNode(n);
+          scheduleUp(n);
+        }
+      else if (gained)
+        {
+          const Dependencies::Range parents = dependents->getDependents(n);
+          for (unsigned i = 0; i < parents.size(); i++)
+            if (asserted->map->find(parents[i]) == asserted->map->end())
+              workList->push(parents[i]);
+        }
+      return true;
     }
 
     // Propagates. No writing in of values. Doesn't assume the top is true.
-    ConstantBitPropagation::ConstantBitPropagation(BEEV::Simplifier* _sm, NodeFactory* _nf,const ASTNode & top)
+    ConstantBitPropagation::ConstantBitPropagation(BEEV::Simplifier* _sm, NodeFactory* _nf,const ASTNode & top,
+        const NodeToFixedBitsMap* _asserted)
     {
       assert (BOOLEAN_TYPE == top.GetType());
       assert (top.GetSTPMgr()->UserFlags.bitConstantProp_flag);
@@ -181,6 +252,8 @@ namespace simplifier
       status = NO_CHANGE;
       simplifier = _sm;
       nf = _nf;
+      asserted = _asserted;
+      printStats = top.GetSTPMgr()->UserFlags.stats_flag;
       fixedMap = new NodeToFixedBitsMap(1000); // better to use the function that returns the number of nodes.. whatever that is.
       workList = new WorkList(top);
       dependents = new Dependencies(top); // List of the parents of a node.
@@ -223,6 +296,29 @@ namespace simplifier
       topFixed = false;
     }
 
+    ConstantBitPropagation::ConstantBitPropagation(BEEV::Simplifier* _sm, NodeFactory* _nf,const ASTNode & top,
+        const NodeToFixedBitsMap* _asserted, const ASTVec& start)
+    {
+      assert (BOOLEAN_TYPE == top.GetType());
+      assert (NULL != _asserted);
+
+      status = NO_CHANGE;
+      simplifier = _sm;
+      nf = _nf;
+      asserted = _asserted;
+      printStats = top.GetSTPMgr()->UserFlags.stats_flag;
+      fixedMap = new NodeToFixedBitsMap(1000);
+      workList = new WorkList();
+      dependents = new Dependencies(top);
+      msm = new MultiplicationStatsMap();
+
+      topFixed = false;
+      for (size_t i = 0; i < start.size(); i++)
+        workList->initWorkList(start[i]);
+      setNodeToTrue(top);
+      propagate();
+    }
+
     // Both way propagation. Initialising the top to "true".
     // The hardest thing to understand is the two cases:
     // 1) If we get the fixed bits of a node, without assuming the top node is true,
@@ -446,13 +542,9 @@ namespace simplifier
     void
     ConstantBitPropagation::scheduleUp(const ASTNode& n)
     {
-      const set<ASTNode>* toAdd = dependents->getDependents(n);
-      set<ASTNode>::iterator it = toAdd->begin();
-      while (it != toAdd->end())
-        {
-          workList->push(*it);
-          it++;
-        }
+      const Dependencies::Range toAdd = dependents->getDependents(n);
+      for (unsigned i = 0; i < toAdd.size(); i++)
+        workList->push(toAdd[i]);
     }
 
     void
@@ -31,7 +31,8 @@ THE SOFTWARE.
 
 // To reduce the memory I tried using the constantbv stuff. But because it is not
 // inlined it took about twice as long per propagation as does using a boolean array.
-// Other options to reduce memory usage are: vector<bool>, dynamic_bitset, or bitMagic.
+// The bits are now packed into 64-bit words, with the operations on them inlined,
+// so the transfer functions can work on a word of bits at a time.
 
 
 namespace simplifier
@@ -39,6 +40,8 @@ namespace simplifier
   namespace constantBitP
   {
 
+    const unsigned FixedBits::bitsPerWord;
+
     std::ostream&
     operator<<(std::ostream& output, const FixedBits& h)
     {
@@ -59,13 +62,25 @@ namespace simplifier
     void
     FixedBits::fixToZero()
     {
-      for (unsigned i = 0; i < getWidth(); i++)
+      for (unsigned w = 0; w < numberOfWords(); w++)
         {
-          setFixed(i, true);
-          setValue(i, false);
+          fixed[w] = widthMask(w);
+          values[w] = 0;
         }
     }
 
+    void
+    FixedBits::fixAt(unsigned from, Word mask, Word v)
+    {
+      const unsigned w = from / bitsPerWord;
+      const unsigned offset = from % bitsPerWord;
+      if (w >= numberOfWords())
+        return;
+      fixWord(w, mask << offset, v << offset);
+      if (offset != 0 && w + 1 < numberOfWords())
+        fixWord(w + 1, mask >> (bitsPerWord - offset), v >> (bitsPerWord - offset));
+    }
+
     BEEV::CBV
     FixedBits::GetBVConst() const
     {
@@ -73,11 +88,9 @@ namespace simplifier
 
       BEEV::CBV result = CONSTANTBV::BitVector_Create(width, true);
 
-      for (unsigned i = 0; i < width; i++)
-        {
-          if (values[i])
-            CONSTANTBV::BitVector_Bit_On(result, i);
-        }
+      // The bit vector's words are 32 bits.
+      for (unsigned i = 0; i < CONSTANTBV::BitVector_Size(width); i++)
+        CONSTANTBV::BitVector_Word_Store(result, i, (unsigned) (values[i / 2] >> (32 * (i % 2))));
 
       return result;
     }
@@ -91,33 +104,44 @@ namespace simplifier
 
       BEEV::CBV result = CONSTANTBV::BitVector_Create(resultWidth, true);
 
-      for (unsigned i = from; i <= to; i++)
+      for (unsigned i = 0; i < CONSTANTBV::BitVector_Size(resultWidth); i++)
         {
-          if (getValue(i))
-            CONSTANTBV::BitVector_Bit_On(result, i - from);
+          const Word mask = lowBits(std::min(resultWidth - 32 * i, 32u));
+          assert((getFixedAt(from + 32 * i) & mask) == mask);
+          CONSTANTBV::BitVector_Word_Store(result, i, (unsigned) (getValueAt(from + 32 * i) & mask));
         }
 
       return result;
     }
 
+    void
+    FixedBits::allocate()
+    {
+      const unsigned words = numberOfWords();
+      if (words == 1)
+        fixed = local;
+      else
+        fixed = new Word[2 * words];
+      values = fixed + words;
+    }
+
     void
     FixedBits::init(const FixedBits& copy)
     {
       width = copy.width;
-      fixed = new bool[width];
-      values = new bool[width];
+      allocate();
       representsBoolean = copy.representsBoolean;
 
-      memcpy(fixed, copy.fixed, width * sizeof(bool));
-      memcpy(values, copy.values, width * sizeof(bool));
+      memcpy(fixed, copy.fixed, numberOfWords() * sizeof(Word));
+      memcpy(values, copy.values, numberOfWords() * sizeof(Word));
     }
 
     bool
     FixedBits::isTotallyFixed() const
     {
-      for (unsigned i = 0; i < width; i++)
+      for (unsigned w = 0; w < numberOfWords(); w++)
         {
-          if (!fixed[i])
+          if (fixed[w] != widthMask(w))
             return false;
         }
 
@@ -128,15 +152,11 @@ namespace simplifier
     {
       assert(n > 0);
 
-      fixed = new bool[n];
-      values = new bool[n];
       width = n;
+      allocate();
 
-      for (unsigned i = 0; i < width; i++)
-        {
-          fixed[i] = false; // I don't know if there's a default value??
-          values[i] = false; // stops it printing out junk.
-        }
+      // Nothing fixed. The values are cleared so it doesn't print out junk.
+      memset(fixed, 0, 2 * numberOfWords() * sizeof(Word));
 
       representsBoolean = isbool;
       if (isbool)
@@ -155,23 +175,10 @@ namespace simplifier
 
       FixedBits result(a.getWidth(), a.isBoolean());
 
-      for (unsigned i = 0; i < a.getWidth(); i++)
-        {
-          if (a.isFixed(i) != b.isFixed(i))
-            {
-              result.setFixed(i, false);
-            }
-          else if (a.isFixed(i) && b.isFixed(i) && (a.getValue(i)
-              != b.getValue(i)))
-            {
-              result.setFixed(i, false);
-            }
-          else if (a.isFixed(i) && b.isFixed(i))
-            { // fixed to the same value.
-              result.setFixed(i, true);
-              result.setValue(i, a.getValue(i));
-            }
-        }
+      // Fixed in both to the same value.
+      for (unsigned w = 0; w < a.numberOfWords(); w++)
+        result.fixWord(w, a.fixed[w] & b.fixed[w] & ~(a.values[w] ^ b.values[w]), a.values[w]);
+
       return result;
     }
 
@@ -183,95 +190,35 @@ namespace simplifier
       assert(a.getWidth() == getWidth());
       assert(a.isBoolean() == isBoolean());
 
-      for (unsigned i = 0; i < a.getWidth(); i++)
-        {
-          if (a.isFixed(i) && isFixed(i) && (a.getValue(i) == getValue(i)))
-            {
-              // nothind.
-            }
-          else
-            {
-              setFixed(i,false);
-            }
-        }
+      // Stays fixed if fixed in both to the same value.
+      for (unsigned w = 0; w < numberOfWords(); w++)
+        fixed[w] &= a.fixed[w] & ~(values[w] ^ a.values[w]);
     }
 
     void
     FixedBits::join(unsigned int a)
     {
-      for (unsigned i = 0; i < getWidth(); i++)
-        {
-          if (isFixed(i))
-            {
-                if (
-                    (((a >> i) & 1) ==1)
-                  &&
-                    !getValue(i)
-                   )
-                  setFixed(i,false);
-                else if ((((a >> i) & 1) ==0) && getValue(i))
-                  setFixed(i,false);
-            }
-        }
+      // Bits past the unsigned are zero.
+      fixed[0] &= ~(values[0] ^ (Word) a);
+      for (unsigned w = 1; w < numberOfWords(); w++)
+        fixed[w] &= ~values[w];
     }
 
+    // Whether the set of values contains this one.
     bool
     FixedBits::unsignedHolds(unsigned val)
     {
-      bool r = unsignedHolds_new(val);
-      //assert (unsignedHolds_old(val) == r);
-      return r;
-    }
-
-    // Whether the set of values contains this one. Much faster than the _old version.
-    bool
-    FixedBits::unsignedHolds_new(unsigned val)
-    {
-      const unsigned initial_width = std::min(width, (unsigned)sizeof(unsigned) * 8);
-
-      for (unsigned i = 0; i < initial_width; i++)
-        {
-          char v = (*this)[i];
-          if ('*'== v)
-            {} // ok
-          else if ((v == '1') != ((val & 1) != 0))
-            return false;
-          val = val >> 1;
-        }
-
       // If the unsigned representation is bigger, false if not zero.
-      if (sizeof(unsigned) * 8 > width && (val !=0))
-         return false;
+      if ((Word) val & ~widthMask(0))
+        return false;
 
-      for (unsigned i = sizeof(unsigned) * 8; i < width; i++)
-        if (isFixed(i) && getValue(i))
-          return false;
+      if ((fixed[0] & (values[0] ^ (Word) val)) != 0)
+        return false;
 
-      return true;
-    }
+      for (unsigned w = 1; w < numberOfWords(); w++)
+        if ((fixed[w] & values[w]) != 0)
+          return false;
 
-    bool
-    FixedBits::unsignedHolds_old(unsigned val)
-    {
-      const unsigned maxWidth = std::max((unsigned)sizeof(unsigned) * 8, width);
-      for (unsigned i = 0; i < maxWidth; i++)
-        {
-        if (i < (unsigned) width && i < sizeof(unsigned) * 8)
-          {
-          if (isFixed(i) && (getValue(i) != (((val & (1 << i))) != 0)))
-            return false;
-          }
-        else if (i < (unsigned) width)
-          {
-          if (isFixed(i) && getValue(i))
-            return false;
-          }
-        else // The unsigned value is bigger than the bitwidth of this.
-          {
-          if (val & (1 << i))
-            return false;
-          }
-        }
       return true;
     }
 
@@ -341,14 +288,12 @@ namespace simplifier
 
       if (BEEV::BITVECTOR_TYPE == n.GetType())
         {
-          // loop through testing each of the bits.
+          // The bit vector's words are 32 bits.
           BEEV::CBV cbv = n.GetBVConst();
 
-          for (unsigned j = 0; j < bitWidth; j++)
-            {
-              output.setFixed(j, true);
-              output.setValue(j, CONSTANTBV::BitVector_bit_test(cbv, j));
-            }
+          output.fixToZero();
+          for (unsigned i = 0; i < CONSTANTBV::BitVector_Size(bitWidth); i++)
+            output.values[i / 2] |= (Word) CONSTANTBV::BitVector_Word_Read(cbv, i) << (32 * (i % 2));
         }
       else
         {
@@ -373,28 +318,12 @@ namespace simplifier
     {
       FixedBits output(width, false);
 
-      const unsigned maxWidth = std::max((unsigned)sizeof(unsigned) * 8, width);
-      for (unsigned i = 0; i < maxWidth; i++)
-        {
-          if (i < width && i < sizeof(unsigned) * 8)
-            {
-              output.setFixed(i, true);
-              output.setValue(i, (val & (1 << i)));
-            }
-          else if (i < width)
-            {
-              output.setFixed(i, true);
-              output.setValue(i, false);
+      // The unsigned value is bigger than the bitwidth of this.
+      // so it can't be represented.
+      if ((Word) val & ~output.widthMask(0))
+        BEEV::FatalError(LOCATION "Cant be represented.");
 
-            }
-          else // The unsigned value is bigger than the bitwidth of this.
-            { // so it can't be represented.
-              if (val & (1 << i))
-                {
-                  BEEV::FatalError(LOCATION "Cant be represented.");
-                }
-            }
-        }
+      output.fromUnsigned(val);
       return output;
     }
 
@@ -402,26 +331,9 @@ namespace simplifier
     void
     FixedBits::fromUnsigned(unsigned val)
     {
-      for (unsigned i = 0; i < width; i++)
-        {
-          if (i < width && i < sizeof(unsigned) * 8)
-            {
-              setFixed(i, true);
-              setValue(i, (val & (1 << i)));
-            }
-          else if (i < width)
-            {
-              setFixed(i, true);
-              setValue(i, false);
-            }
-          else // The unsigned value is bigger than the bitwidth of this.
-            { // so it can't be represented.
-              if (val & (1 << i))
-                {
-                  BEEV::FatalError(LOCATION "Cant be represented.");
-                }
-            }
-        }
+      // Bits of the unsigned past the width are ignored.
+      fixToZero();
+      values[0] = (Word) val & widthMask(0);
     }
 
     bool
@@ -430,19 +342,12 @@ namespace simplifier
       assert ((int)n.getWidth() >= upTo);
       assert ((int)o.getWidth() >= upTo);
 
-      for (int i = 0; i < upTo; i++)
+      // Bits that were fixed must stay fixed to the same value.
+      for (unsigned w = 0; w * bitsPerWord < (unsigned) upTo; w++)
         {
-          if (n.isFixed(i) && o.isFixed(i))
-            {
-              if (n.getValue(i) != o.getValue(i))
-                {
-                  return false;
-                }
-            }
-          else if (o.isFixed(i) && !n.isFixed(i))
-            {
-              return false;
-            }
+          const Word mask = lowBits(std::min(upTo - w * bitsPerWord, bitsPerWord));
+          if ((o.fixed[w] & ~(n.fixed[w] & ~(n.values[w] ^ o.values[w])) & mask) != 0)
+            return false;
         }
 
       return true;
@@ -456,21 +361,7 @@ namespace simplifier
       if (n.getWidth() != o.getWidth())
         return false;
 
-      for (unsigned i = 0; i < n.getWidth(); i++)
-        {
-          if (n.isFixed(i) && o.isFixed(i))
-            {
-              if (n.getValue(i) != o.getValue(i))
-                {
-                  return false;
-                }
-            }
-          else if (o.isFixed(i) && !n.isFixed(i))
-            {
-              return false;
-            }
-        }
-      return true;
+      return updateOK(o, n, n.getWidth());
     }
 
     // a is "IN" b.
@@ -479,16 +370,7 @@ namespace simplifier
     {
       assert(a.getWidth() == b.getWidth());
 
-      for (unsigned i = 0; i < a.getWidth(); i++)
-        {
-          if (a.isFixed(i) && b.isFixed(i) && (a.getValue(i) != b.getValue(i)))
-            {
-              return false;
-            }
-          if (!a.isFixed(i) && b.isFixed(i))
-            return false;
-        }
-      return true;
+      return updateOK(b, a);
     }
 
     // Gets the minimum and maximum unsigned values that are held in the current
@@ -496,36 +378,23 @@ namespace simplifier
     void
     FixedBits::getUnsignedMinMax(unsigned &minShift, unsigned &maxShift) const
     {
-      const unsigned bitWidth = this->getWidth();
-      unsigned unsignedBW = sizeof(unsigned)*8;
-
-      minShift = 0;
-      maxShift = 0;
+      const Word unsignedBits = lowBits(sizeof(unsigned) * 8);
 
       bool bigMax = false;
       bool bigMin = false;
 
-      for (unsigned i = unsignedBW; i < bitWidth; i++)
+      for (unsigned w = 0; w < numberOfWords(); w++)
         {
-        if  ((*this)[i] == '1' || (*this)[i] == '*')
-          bigMax = true;
+          const Word one = fixed[w] & values[w];
+          const Word possibleOne = (~fixed[w] | values[w]) & widthMask(w);
+          const Word big = w == 0 ? ~unsignedBits : ~(Word) 0;
 
-         if ((*this)[i] == '1')
-          bigMin = true;
+          bigMax |= (possibleOne & big) != 0;
+          bigMin |= (one & big) != 0;
         }
 
-      for (unsigned i = 0; i < std::min(unsignedBW,bitWidth); i++)
-        {
-          if ((*this)[i] == '1')
-            {
-              minShift |= (1 <<i);
-              maxShift |= (1 <<i);
-            }
-          else if ((*this)[i] == '*')
-            {
-              maxShift |= (1 <<i);
-            }
-        }
+      minShift = (unsigned) (fixed[0] & values[0]);
+      maxShift = (unsigned) ((~fixed[0] | values[0]) & widthMask(0));
 
       if (bigMax)
         maxShift = UINT_MAX;
@@ -540,15 +409,12 @@ namespace simplifier
       if (a.getWidth() != b.getWidth())
         return false;
 
-      for (unsigned i = 0; i < a.getWidth(); i++)
+      for (unsigned w = 0; w < a.numberOfWords(); w++)
         {
-          if (a.isFixed(i) != b.isFixed(i))
-            {
-              return false;
-            }
-          if (a.isFixed(i))
-            if (a.getValue(i) != b.getValue(i))
-              return false;
+          if (a.fixed[w] != b.fixed[w])
+            return false;
+          if ((a.fixed[w] & (a.values[w] ^ b.values[w])) != 0)
+            return false;
         }
       return true;
     }
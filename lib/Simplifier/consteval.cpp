@@ -23,6 +23,7 @@ THE SOFTWARE.
 ********************************************************************/
 
 #include <cassert>
+#include <stdint.h>
 #include "stp/Simplifier/simplifier.h"
 
 namespace BEEV
@@ -38,8 +39,209 @@ namespace BEEV
 
 
 
+  /****************************************************************
+   * Constant folding on uint64_t                                 *
+   *                                                              *
+   * Almost all of the constants that get folded are 64 bits or   *
+   * less, so they are folded here with machine arithmetic rather *
+   * than through heap allocated CBVs. Wider values, and the      *
+   * divisions by zero (which depend on the flags), are left to   *
+   * the general code below.                                      *
+   ****************************************************************/
+
+  // The value of a BVCONST that's at most 64 bits wide.
+  static inline uint64_t GetUint64(const ASTNode& n)
+  {
+    assert(n.GetKind() == BVCONST && n.GetValueWidth() <= 64);
+    const CBV c = n.GetBVConst();
+    uint64_t v = c[0];
+    if (n.GetValueWidth() > 32)
+      v |= ((uint64_t) c[1]) << 32;
+    return v;
+  }
+
+  static inline uint64_t Mask64(unsigned int width)
+  {
+    return (width >= 64) ? ~(uint64_t) 0 : (((uint64_t) 1) << width) - 1;
+  }
+
+  // Sign extends a "width" bit value.
+  static inline int64_t Signed64(uint64_t v, unsigned int width)
+  {
+    assert(width >= 1 && width <= 64);
+    return ((int64_t) (v << (64 - width))) >> (64 - width);
+  }
+
+  // Returns false, without setting "result", if it can't evaluate it.
+  static bool BVConstEvaluator64(STPMgr* bm, const Kind k, const ASTVec& children, unsigned int width,
+      ASTNode& result)
+  {
+    const size_t n = children.size();
+    if (width > 64)
+      return false;
+    for (size_t i = 0; i < n; i++)
+      if (children[i].GetKind() != BVCONST || children[i].GetValueWidth() > 64)
+        return false;
+
+    const unsigned int aw = children[0].GetValueWidth();
+    const uint64_t a = GetUint64(children[0]);
+    const uint64_t b = (n > 1) ? GetUint64(children[1]) : 0;
+    uint64_t r = 0;
+    int cmp = -1; // For predicates, 1 if true, 0 if false.
+
+    switch (k)
+      {
+      case BOOLEXTRACT:
+        cmp = (b < aw) && ((a >> b) & 1);
+        break;
+      case BVNEG:
+        r = ~a;
+        break;
+      case BVUMINUS:
+        r = -a;
+        break;
+      case BVZX:
+        r = a;
+        break;
+      case BVSX:
+        r = (uint64_t) Signed64(a, aw);
+        break;
+      case BVLEFTSHIFT:
+        r = (b >= width) ? 0 : a << b;
+        break;
+      case BVRIGHTSHIFT:
+        r = (b >= width) ? 0 : a >> b;
+        break;
+      case BVSRSHIFT:
+        {
+          const int64_t s = Signed64(a, width);
+          if (b >= width)
+            r = (s < 0) ? ~(uint64_t) 0 : 0;
+          else
+            r = (uint64_t) (s >> b);
+          break;
+        }
+      case BVAND:
+        r = ~(uint64_t) 0;
+        for (size_t i = 0; i < n; i++)
+          r &= GetUint64(children[i]);
+        break;
+      case BVOR:
+        for (size_t i = 0; i < n; i++)
+          r |= GetUint64(children[i]);
+        break;
+      case BVXOR:
+        if (n != 2)
+          return false;
+        r = a ^ b;
+        break;
+      case BVSUB:
+        assert(2 == n);
+        r = a - b;
+        break;
+      case BVPLUS:
+        for (size_t i = 0; i < n; i++)
+          r += GetUint64(children[i]);
+        break;
+      case BVMULT:
+        r = 1;
+        for (size_t i = 0; i < n; i++)
+          r *= GetUint64(children[i]);
+        break;
+      case BVEXTRACT:
+        {
+          const unsigned int hi = (unsigned int) b;
+          const unsigned int low = (unsigned int) GetUint64(children[2]);
+          assert(low <= hi && hi < aw);
+          width = hi - low + 1;
+          r = a >> low;
+          break;
+        }
+      case BVCONCAT:
+        {
+          assert(2 == n);
+          const unsigned int bw = children[1].GetValueWidth();
+          if (aw + bw > 64)
+            return false;
+          width = aw + bw;
+          r = (a << bw) | b;
+          break;
+        }
+      case BVDIV:
+      case BVMOD:
+        if (b == 0)
+          return false;
+        r = (k == BVDIV) ? a / b : a % b;
+        break;
+      case SBVDIV:
+      case SBVREM:
+      case SBVMOD:
+        {
+          if (b == 0)
+            return false;
+          const uint64_t mask = Mask64(width);
+          const bool negA = Signed64(a, width) < 0;
+          const bool negB = Signed64(b, width) < 0;
+          const uint64_t absA = negA ? (-a & mask) : a;
+          const uint64_t absB = negB ? (-b & mask) : b;
+          const uint64_t q = absA / absB;
+          const uint64_t u = absA % absB;
+          if (k == SBVDIV)
+            r = (negA != negB) ? -q : q;
+          else if (k == SBVREM)
+            r = negA ? -u : u;
+          else if (u == 0 || (!negA && !negB))
+            r = u;
+          else if (negA && !negB)
+            r = -u + b;
+          else if (!negA && negB)
+            r = u + b;
+          else
+            r = -u;
+          break;
+        }
+      case EQ:
+        cmp = (a == b);
+        break;
+      case BVLT:
+        cmp = (a < b);
+        break;
+      case BVLE:
+        cmp = (a <= b);
+        break;
+      case BVGT:
+        cmp = (a > b);
+        break;
+      case BVGE:
+        cmp = (a >= b);
+        break;
+      case BVSLT:
+        cmp = (Signed64(a, aw) < Signed64(b, aw));
+        break;
+      case BVSLE:
+        cmp = (Signed64(a, aw) <= Signed64(b, aw));
+        break;
+      case BVSGT:
+        cmp = (Signed64(a, aw) > Signed64(b, aw));
+        break;
+      case BVSGE:
+        cmp = (Signed64(a, aw) >= Signed64(b, aw));
+        break;
+      default:
+        return false;
+      }
+
+    if (cmp >= 0)
+      result = cmp ? bm->ASTTrue : bm->ASTFalse;
+    else
+      result = bm->CreateBVConst(width, (unsigned long long) (r & Mask64(width)));
+    return true;
+  }
+
+
 // Const evaluator logical and arithmetic operations.
-  ASTNode NonMemberBVConstEvaluator(STPMgr* _bm , const Kind k, const ASTVec& input_children, unsigned int inputwidth)
+  ASTNode NonMemberBVConstEvaluator(STPMgr* _bm , const Kind k, const ASTVec& input_children, unsigned int inputwidth,
+                                    bool fast64)
   {
 	ASTNode OutputNode;
 
@@ -66,6 +268,9 @@ namespace BEEV
     		children.push_back(NonMemberBVConstEvaluator(input_children[i]));
     }
 
+    if (fast64 && BVConstEvaluator64(_bm, k, children, inputwidth, OutputNode))
+      return OutputNode;
+
     if ((number_of_children ==2 || number_of_children == 1) && input_children[0].GetType() == BITVECTOR_TYPE)
     {
     //saving some typing. BVPLUS does not use these variables. if the
@@ -31,11 +31,10 @@ namespace BEEV
 // Can it only add in the new variables somehow??
 void addVariables(BBNodeManagerAIG& mgr, Cnf_Dat_t*& cnfData , ToSATBase::ASTNodeToSATVar& nodeToVar)
 {
-	BBNodeManagerAIG::SymbolToBBNode::const_iterator it;
 	// Each symbol maps to a vector of CNF variables.
-	for (it = mgr.symbolToBBNode.begin(); it != mgr.symbolToBBNode.end(); it++) {
-		const ASTNode& n = it->first;
-		const vector<BBNodeAIG> &b = it->second;
+	for (size_t j = 0; j < mgr.symbolToBBNode.size(); j++) {
+		const ASTNode& n = mgr.symbolToBBNode.key(j);
+		const vector<BBNodeAIG> &b = mgr.symbolToBBNode.value(j);
 
 		const int width = (n.GetType() == BOOLEAN_TYPE) ? 1 : n.GetValueWidth();
 
@@ -119,15 +118,13 @@ void ToCNFAIG::toCNF(const BBNodeAIG& top, Cnf_Dat_t*& cnfData,
 
 	}
 
-	BBNodeManagerAIG::SymbolToBBNode::const_iterator it;
-
 	assert(nodeToVar.size() == 0);
 
 	//todo. cf. with addvariables above...
 	// Each symbol maps to a vector of CNF variables.
-	for (it = mgr.symbolToBBNode.begin(); it != mgr.symbolToBBNode.end(); it++) {
-		const ASTNode& n = it->first;
-		const vector<BBNodeAIG> &b = it->second;
+	for (size_t j = 0; j < mgr.symbolToBBNode.size(); j++) {
+		const ASTNode& n = mgr.symbolToBBNode.key(j);
+		const vector<BBNodeAIG> &b = mgr.symbolToBBNode.value(j);
 		assert(nodeToVar.find(n) == nodeToVar.end());
 
 		const int width = (n.GetType() == BOOLEAN_TYPE) ? 1 : n.GetValueWidth();
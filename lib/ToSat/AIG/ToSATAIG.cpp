@@ -25,11 +25,22 @@ THE SOFTWARE.
 #include "stp/ToSat/AIG/ToSATAIG.h"
 #include "stp/Simplifier/constantBitP/ConstantBitPropagation.h"
 #include "stp/Simplifier/simplifier.h"
+#include <chrono>
 
 namespace BEEV
 {
 
-    int ToSATAIG::cnf_calls=0;
+    thread_local int ToSATAIG::cnf_calls=0;
+
+    void
+    ToSATAIG::solve(SATSolver& satSolver)
+    {
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      bm->GetRunTimes()->start(RunTimes::Solving);
+      satSolver.solve();
+      bm->GetRunTimes()->stop(RunTimes::Solving);
+      solveSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
 
     bool
     ToSATAIG::CallSAT(SATSolver& satSolver, const ASTNode& input, bool needAbsRef)
@@ -40,9 +51,7 @@ namespace BEEV
        if (!first)
        {
     	   assert(input == ASTTrue);
-    	   bm->GetRunTimes()->start(RunTimes::Solving);
-           satSolver.solve();
-           bm->GetRunTimes()->stop(RunTimes::Solving);
+           solve(satSolver);
 
            if(bm->UserFlags.stats_flag)
              satSolver.printStats();
@@ -59,6 +68,19 @@ namespace BEEV
       if (input == ASTTrue  )
    		return true;
 
+      Encode(satSolver, input, needAbsRef);
+
+      solve(satSolver);
+
+      if(bm->UserFlags.stats_flag)
+        satSolver.printStats();
+
+      return satSolver.okay();
+    }
+
+    void
+    ToSATAIG::Encode(SATSolver& satSolver, const ASTNode& input, bool needAbsRef)
+    {
   	  Simplifier simp(bm);
 
   	  BBNodeManagerAIG mgr;
@@ -67,6 +89,7 @@ namespace BEEV
       bm->GetRunTimes()->start(RunTimes::BitBlasting);
       BBNodeAIG BBFormula = bb.BBForm(input);
       bm->GetRunTimes()->stop(RunTimes::BitBlasting);
+      aigNodes = mgr.totalNumberOfNodes();
 
       delete cb;
       cb = NULL;
@@ -78,6 +101,8 @@ namespace BEEV
       Cnf_Dat_t* cnfData = NULL;
 	  toCNF.toCNF(BBFormula, cnfData, nodeToSATVar,needAbsRef,mgr);
       bm->GetRunTimes()->stop(RunTimes::CNFConversion);
+      cnfVars = cnfData->nVars;
+      cnfClauses = cnfData->nClauses;
 
 	  // Free the memory in the AIGs.
 	  BBFormula = BBNodeAIG(); // null node
@@ -294,16 +319,6 @@ namespace BEEV
 
       //void setHardTimeout(int sec);
       //setHardTimeout(500);
-
-
-      bm->GetRunTimes()->start(RunTimes::Solving);
-      satSolver.solve();
-      bm->GetRunTimes()->stop(RunTimes::Solving);
-
-      if(bm->UserFlags.stats_flag)
-        satSolver.printStats();
-
-      return satSolver.okay();
     }
 
     ToSATAIG::~ToSATAIG()
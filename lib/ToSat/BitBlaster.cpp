@@ -58,7 +58,6 @@ namespace BEEV
   using std::make_pair;
 
 #define BBNodeVec std::vector<BBNode>
-#define BBNodeVecMap std::map<ASTNode, vector<BBNode> >
 #define BBNodeSet std::set<BBNode>
 
   vector<BBNodeAIG> _empty_BBNodeAIGVec;
@@ -123,11 +122,10 @@ namespace BEEV
       assert(support.size() ==0);
 
         {
-        typename std::map<ASTNode, BBNode>::iterator it;
-        for (it = BBFormMemo.begin(); it != BBFormMemo.end(); it++)
+        for (size_t i = 0; i < BBFormMemo.size(); i++)
           {
-          const ASTNode& n = it->first;
-          const BBNode& x = it->second;
+          const ASTNode& n = BBFormMemo.key(i);
+          const BBNode& x = BBFormMemo.value(i);
           if (n.isConstant())
             continue;
 
@@ -149,16 +147,15 @@ namespace BEEV
           }
         }
 
-      typename BBNodeVecMap::iterator it;
-      for (it = BBTermMemo.begin(); it != BBTermMemo.end(); it++)
+      for (size_t j = 0; j < BBTermMemo.size(); j++)
         {
-        const ASTNode& n = it->first;
+        const ASTNode& n = BBTermMemo.key(j);
         assert(n.GetType() == BITVECTOR_TYPE);
 
         if (n.isConstant())
           continue;
 
-        vector<BBNode>& x = it->second;
+        vector<BBNode>& x = BBTermMemo.value(j);
         assert(x.size() == n.GetValueWidth());
 
         bool constNode = true;
@@ -190,14 +187,13 @@ namespace BEEV
       if (form.GetSTPMgr()->UserFlags.isSet("bb-equiv","1"))
       {
         hash_map<intptr_t ,ASTNode> nodeToFn;
-        typename std::map<ASTNode, BBNode>::iterator it;
-        for (it = BBFormMemo.begin(); it != BBFormMemo.end(); it++)
+        for (size_t i = 0; i < BBFormMemo.size(); i++)
           {
-          const ASTNode& n = it->first;
+          const ASTNode& n = BBFormMemo.key(i);
           if (n.isConstant())
             continue;
 
-          const BBNode& x = it->second;
+          const BBNode& x = BBFormMemo.value(i);
           if (x == BBTrue || x == BBFalse)
             continue;
 
@@ -226,14 +222,13 @@ namespace BEEV
       if (form.GetSTPMgr()->UserFlags.isSet("bb-equiv","1"))
         {
           M lookup;
-          typename std::map<ASTNode, vector<BBNode> >::iterator it;
-          for (it = BBTermMemo.begin(); it != BBTermMemo.end(); it++)
+          for (size_t i = 0; i < BBTermMemo.size(); i++)
             {
-              const ASTNode& n = it->first;
+              const ASTNode& n = BBTermMemo.key(i);
               if (n.isConstant())
                 continue;
 
-              const vector<BBNode>& x = it->second;
+              const vector<BBNode>& x = BBTermMemo.value(i);
 
               bool constNode = true;
               for (int i = 0; i < (int) x.size(); i++)
@@ -485,12 +480,12 @@ namespace BEEV
     {
       ASTNode term = _term; // mutable local copy.
 
-      typename BBNodeVecMap::iterator it = BBTermMemo.find(term);
-      if (it != BBTermMemo.end())
+      BBNodeVec* memo = BBTermMemo.find(term);
+      if (memo != NULL)
         {
         // Constant bit propagation may have updated something.
-        updateTerm(term, it->second, support);
-        return it->second;
+        updateTerm(term, *memo, support);
+        return *memo;
         }
 
       // This block checks if the bitblasting/fixed bits have discovered
@@ -604,12 +599,12 @@ namespace BEEV
           term = n_term;
 
           // check if we've already done the simplified one.
-          it = BBTermMemo.find(term);
-          if (it != BBTermMemo.end())
+          memo = BBTermMemo.find(term);
+          if (memo != NULL)
             {
             // Constant bit propagation may have updated something.
-            updateTerm(term, it->second, support);
-            return it->second;
+            updateTerm(term, *memo, support);
+            return *memo;
             }
           }
         }
@@ -1033,11 +1028,11 @@ namespace BEEV
     const BBNode
     BitBlaster<BBNode, BBNodeManagerT>::BBForm(const ASTNode& form, BBNodeSet& support)
     {
-      typename std::map<ASTNode, BBNode>::iterator it = BBFormMemo.find(form);
-      if (it != BBFormMemo.end())
+      const BBNode* memo = BBFormMemo.find(form);
+      if (memo != NULL)
         {
         // already there.  Just return it.
-        return it->second;
+        return *memo;
         }
 
       BBNode result;
@@ -2905,7 +2900,6 @@ namespace BEEV
   template class BitBlaster<BBNodeAIG, BBNodeManagerAIG> ;
 
 #undef BBNodeVec
-#undef BBNodeVecMap
 #undef BBNodeSet
 
 } // BEEV namespace
@@ -41,6 +41,7 @@ THE SOFTWARE.
 #include "stp/Sat/MinisatCore.h"
 #include "stp/STPManager/STP.h"
 #include "stp/STPManager/DifficultyScore.h"
+#include "stp/Simplifier/BatchEvaluator.h"
 #include "stp/AST/AST.h"
 #include "stp/STPManager/STPManager.h"
 using namespace BEEV;
@@ -851,32 +852,41 @@ getHash(const ASTNode& n_, const vector<VariableAssignment>& values)
       assert(symbols[j].GetValueWidth() == ass_bitwidth);
     }
 
-  for (int i = 0; i < values.size(); i++)
+  // Evaluates the expression under a batch of the values at a time.
+  BatchEvaluator batch(mgr);
+  for (int first = 0; first < values.size(); first += BatchEvaluator::Lanes)
     {
-      // They both should be set..
-      assert(values[i].getV().GetValueWidth() == ass_bitwidth);
-      assert(values[i].getW().GetValueWidth() == ass_bitwidth);
-
-      ASTNodeMap mapToVal;
-      for (int j = 0; j < symbols.size(); j++)
+      const int last = std::min((int) values.size(), first + (int) BatchEvaluator::Lanes);
+      for (int i = first; i < last; i++)
         {
-          assert(symbols[j].GetValueWidth() == ass_bitwidth);
+          // They both should be set..
+          assert(values[i].getV().GetValueWidth() == ass_bitwidth);
+          assert(values[i].getW().GetValueWidth() == ass_bitwidth);
 
-          if (strncmp(symbols[j].GetName(), "v", 1) == 0)
-            mapToVal.insert(make_pair(symbols[j], values[i].getV()));
-          else if (strncmp(symbols[j].GetName(), "w", 1) == 0)
-            mapToVal.insert(make_pair(symbols[j], values[i].getW()));
-          else
+          for (int j = 0; j < symbols.size(); j++)
             {
-              cerr << "Unknown symbol!" << symbols[j];
-              FatalError("f");
+              assert(symbols[j].GetValueWidth() == ass_bitwidth);
+
+              if (strncmp(symbols[j].GetName(), "v", 1) == 0)
+                batch.setValue(symbols[j], i - first, values[i].getV());
+              else if (strncmp(symbols[j].GetName(), "w", 1) == 0)
+                batch.setValue(symbols[j], i - first, values[i].getW());
+              else
+                {
+                  cerr << "Unknown symbol!" << symbols[j];
+                  FatalError("f");
+                }
             }
         }
 
-      ASTNode r = eval(n, mapToVal);
-      assert(r.isConstant());
-      hash <<= ass_bitwidth;
-      hash += r.GetUnsignedConst();
+      if (!batch.evaluate(n))
+        FatalError("getHash: couldn't evaluate", n);
+
+      for (int i = first; i < last; i++)
+        {
+          hash <<= ass_bitwidth;
+          hash += batch.getUint64(n, i - first);
+        }
     }
   return hash;
 }
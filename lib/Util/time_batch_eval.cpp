@@ -0,0 +1,239 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+// Times BatchEvaluator against the constant evaluator on random
+// expressions, checking that they agree. A smaller, fixed-seed version
+// of the check is in tests/api/C/batch-eval.cpp.
+
+#include <cstdlib>
+#include "stp/AST/AST.h"
+#include "stp/STPManager/STPManager.h"
+#include "stp/Simplifier/simplifier.h"
+#include "stp/Simplifier/BatchEvaluator.h"
+
+using namespace BEEV;
+using std::cerr;
+using std::endl;
+
+#include "stp/Util/StopWatch.h"
+
+STPMgr * mgr;
+NodeFactory * nf;
+
+static uint64_t random64()
+{
+  uint64_t r = 0;
+  for (int i = 0; i < 4; i++)
+    r = (r << 16) ^ (rand() & 0xffff);
+
+  // Favour the edge cases.
+  switch (rand() % 8)
+    {
+    case 0:
+      return 0;
+    case 1:
+      return 1;
+    case 2:
+      return ~(uint64_t) 0;
+    case 3:
+      return r & 0xff;
+    default:
+      return r;
+    }
+}
+
+static ASTNode randomConstant(unsigned width)
+{
+  CBV c = CONSTANTBV::BitVector_Create(width, true);
+  for (unsigned i = 0; i < width; i += 64)
+    {
+      const uint64_t r = random64();
+      for (unsigned j = 0; j < 64 && i + j < width; j++)
+        if ((r >> j) & 1)
+          CONSTANTBV::BitVector_Bit_On(c, i + j);
+    }
+  return mgr->CreateBVConst(c, width);
+}
+
+static ASTNode randomTerm(const ASTVec& vars, unsigned width, int depth);
+
+static ASTNode randomFormula(const ASTVec& vars, unsigned width, int depth)
+{
+  const Kind predicates[] = {EQ, BVLT, BVLE, BVGT, BVGE, BVSLT, BVSLE, BVSGT, BVSGE};
+  const Kind connectives[] = {NOT, AND, OR, XOR, NAND, NOR, IFF, IMPLIES};
+
+  if (depth <= 0 || rand() % 3 == 0)
+    {
+      if (rand() % 4 == 0)
+        return nf->CreateNode(BOOLEXTRACT, randomTerm(vars, width, depth - 1),
+            mgr->CreateBVConst(32, rand() % width));
+      return nf->CreateNode(predicates[rand() % 9], randomTerm(vars, width, depth - 1),
+          randomTerm(vars, width, depth - 1));
+    }
+
+  const Kind k = connectives[rand() % 8];
+  if (k == NOT)
+    return nf->CreateNode(NOT, randomFormula(vars, width, depth - 1));
+  return nf->CreateNode(k, randomFormula(vars, width, depth - 1), randomFormula(vars, width, depth - 1));
+}
+
+static ASTNode randomTerm(const ASTVec& vars, unsigned width, int depth)
+{
+  const Kind binary[] = {BVPLUS, BVSUB, BVMULT, BVAND, BVOR, BVXOR, BVDIV, BVMOD, SBVDIV, SBVREM, SBVMOD,
+      BVLEFTSHIFT, BVRIGHTSHIFT, BVSRSHIFT};
+  const int nBinary = sizeof(binary) / sizeof(binary[0]);
+
+  if (depth <= 0 || rand() % 5 == 0)
+    return (rand() % 4 == 0) ? randomConstant(width) : vars[rand() % vars.size()];
+
+  const int r = rand() % (nBinary + 5);
+  if (r < nBinary)
+    return nf->CreateTerm(binary[r], width, randomTerm(vars, width, depth - 1), randomTerm(vars, width, depth - 1));
+
+  switch (r - nBinary)
+    {
+    case 0:
+      return nf->CreateTerm(BVNEG, width, randomTerm(vars, width, depth - 1));
+    case 1:
+      return nf->CreateTerm(BVUMINUS, width, randomTerm(vars, width, depth - 1));
+    case 2:
+      return nf->CreateTerm(ITE, width, randomFormula(vars, width, depth - 1), randomTerm(vars, width, depth - 1),
+          randomTerm(vars, width, depth - 1));
+    case 3:
+      {
+        // Extract the top part, then extend it back.
+        const unsigned low = rand() % width;
+        ASTNode e = nf->CreateTerm(BVEXTRACT, width - low, randomTerm(vars, width, depth - 1),
+            mgr->CreateBVConst(32, width - 1), mgr->CreateBVConst(32, low));
+        if (low == 0)
+          return e;
+        return nf->CreateTerm((rand() % 2) ? BVSX : BVZX, width, e, mgr->CreateBVConst(32, width));
+      }
+    default:
+      {
+        // Split into two pieces, then concatenate them.
+        if (width == 1)
+          return randomTerm(vars, width, depth - 1);
+        const unsigned split = 1 + rand() % (width - 1);
+        ASTNode t = randomTerm(vars, width, depth - 1);
+        ASTNode hi = nf->CreateTerm(BVEXTRACT, width - split, t, mgr->CreateBVConst(32, width - 1),
+            mgr->CreateBVConst(32, split));
+        ASTNode lo = nf->CreateTerm(BVEXTRACT, split, randomTerm(vars, width, depth - 1),
+            mgr->CreateBVConst(32, split - 1), mgr->CreateBVConst(32, 0));
+        return nf->CreateTerm(BVCONCAT, width, hi, lo);
+      }
+    }
+}
+
+// Evaluates n with the symbols replaced by the values in the map.
+static ASTNode eval(const ASTNode& n, ASTNodeMap& map)
+{
+  if (n.isConstant())
+    return n;
+
+  ASTNodeMap::const_iterator it = map.find(n);
+  if (it != map.end())
+    return it->second;
+
+  ASTVec children;
+  for (size_t i = 0; i < n.Degree(); i++)
+    children.push_back(eval(n[i], map));
+
+  ASTNode r = NonMemberBVConstEvaluator(mgr, n.GetKind(), children, n.GetValueWidth());
+  map.insert(std::make_pair(n, r));
+  return r;
+}
+
+int main(int argc, char ** argv)
+{
+  CONSTANTBV::BitVector_Boot();
+  mgr = new STPMgr;
+  ParserBM = mgr;
+  nf = mgr->hashingNodeFactory;
+  mgr->UserFlags.division_by_zero_returns_one_flag = true;
+
+  const int rounds = (argc > 1) ? atoi(argv[1]) : 300;
+  const unsigned widths[] = {1, 2, 3, 7, 8, 13, 31, 32, 33, 63, 64, 65, 100};
+  const int lanes = BatchEvaluator::Lanes;
+
+  Stopwatch2 batchTime, constTime;
+  long checked = 0;
+
+  for (int round = 0; round < rounds; round++)
+    {
+      const unsigned width = widths[round % (sizeof(widths) / sizeof(widths[0]))];
+
+      ASTVec vars;
+      for (int i = 0; i < 3; i++)
+        {
+          char name[32];
+          sprintf(name, "v%d_%u", i, width);
+          vars.push_back(nf->CreateSymbol(name, 0, width));
+        }
+      ASTNode b = nf->CreateSymbol("b", 0, 0);
+
+      const ASTNode t = randomTerm(vars, width, 5);
+      const ASTNode f = nf->CreateNode(IFF, b, randomFormula(vars, width, 4));
+
+      std::vector<ASTNodeMap> models(lanes);
+      for (int lane = 0; lane < lanes; lane++)
+        {
+          for (size_t i = 0; i < vars.size(); i++)
+            models[lane].insert(std::make_pair(vars[i], randomConstant(width)));
+          models[lane].insert(std::make_pair(b, (rand() % 2) ? mgr->ASTTrue : mgr->ASTFalse));
+        }
+
+      batchTime.start();
+      BatchEvaluator batch(mgr);
+      for (int lane = 0; lane < lanes; lane++)
+        for (ASTNodeMap::const_iterator it = models[lane].begin(); it != models[lane].end(); it++)
+          batch.setValue(it->first, lane, it->second);
+      if (!batch.evaluate(t) || !batch.evaluate(f))
+        FatalError("BatchEvaluator couldn't evaluate", t);
+      batchTime.stop();
+
+      for (int lane = 0; lane < lanes; lane++)
+        {
+          constTime.start();
+          ASTNodeMap& m = models[lane];
+          const ASTNode tv = eval(t, m);
+          const ASTNode fv = eval(f, m);
+          constTime.stop();
+
+          if (tv != batch.getValue(t, lane) || fv != batch.getValue(f, lane))
+            {
+              cerr << "Different in lane " << lane << ":" << t << f;
+              cerr << "expected " << tv << fv << "got " << batch.getValue(t, lane) << batch.getValue(f, lane);
+              FatalError("time_batch_eval failed");
+            }
+          checked++;
+        }
+    }
+
+  cerr << "Checked " << checked << " assignments." << endl;
+  cerr << "Batch evaluation: " << (double) batchTime.elapsed / CLOCKS_PER_SEC << "s, one at a time: "
+      << (double) constTime.elapsed / CLOCKS_PER_SEC << "s" << endl;
+  delete mgr;
+  return 0;
+}
@@ -0,0 +1,98 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+// Times HashingNodeFactory::CreateNode: creating fresh nodes, looking
+// up nodes that already exist, and removing them from the unique table.
+
+#include <sstream>
+#include "stp/AST/AST.h"
+#include "stp/STPManager/STPManager.h"
+
+using namespace BEEV;
+using std::cerr;
+using std::endl;
+
+#include "stp/Util/StopWatch.h"
+
+const int variables = 1000;
+const int nodes = 2000000;
+const unsigned width = 32;
+
+int main(int argc, char ** argv)
+{
+  STPMgr * mgr = new STPMgr;
+  ParserBM = mgr;
+  NodeFactory * nf = mgr->hashingNodeFactory;
+
+  ASTVec vars;
+  for (int i = 0; i < variables; i++)
+    {
+      std::stringstream name;
+      name << "v" << i;
+      vars.push_back(nf->CreateSymbol(name.str().c_str(), 0, width));
+    }
+
+  // Every (kind, variable, variable) triple is used at most once, so
+  // all of the nodes are distinct.
+  const Kind kinds[] = {BVSUB, BVDIV, BVMOD};
+  ASTVec created;
+  created.reserve(nodes);
+  {
+    cerr << "Creating " << nodes << " nodes. ";
+    Stopwatch s;
+    for (int i = 0; i < nodes; i++)
+      {
+        const ASTNode& a = vars[i % variables];
+        const ASTNode& b = vars[(i / variables) % variables];
+        const Kind k = kinds[(i / (variables * variables)) % 3];
+        created.push_back(nf->CreateTerm(k, width, a, b));
+      }
+    s.stop();
+  }
+
+  {
+    cerr << "Looking up " << nodes << " existing nodes. ";
+    Stopwatch s;
+    for (int i = 0; i < nodes; i++)
+      {
+        const ASTNode& n = created[i];
+        ASTNode found = nf->CreateTerm(n.GetKind(), width, n.GetChildren());
+        if (found != n)
+          FatalError("lookup returned a different node");
+      }
+    s.stop();
+  }
+
+  {
+    cerr << "Removing " << nodes << " nodes. ";
+    Stopwatch s;
+    created.clear();
+    s.stop();
+  }
+
+  mgr->printNodeAllocationStats();
+  vars.clear();
+  delete mgr;
+  return 0;
+}
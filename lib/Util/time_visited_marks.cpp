@@ -0,0 +1,77 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+
+// Times lots of small traversals in a big node table. That they nest
+// is checked by tests/api/C/visited-marks.cpp.
+
+#include "stp/AST/AST.h"
+#include "stp/STPManager/STPManager.h"
+#include "stp/STPManager/NodeIterator.h"
+
+using namespace BEEV;
+using std::cerr;
+using std::endl;
+
+#include "stp/Util/StopWatch.h"
+
+static int count(const ASTNode& n, STPMgr& mgr)
+{
+  NodeIterator ni(n, mgr.ASTUndefined, mgr);
+  int result = 0;
+  while (ni.next() != ni.end())
+    result++;
+  return result;
+}
+
+int main()
+{
+  STPMgr* mgr = new STPMgr();
+  BEEV::ParserBM = mgr;
+  NodeFactory* nf = mgr->defaultNodeFactory;
+
+  // A chain in which each link refers to the one before twice.
+  const int length = 200;
+  ASTVec chain;
+  chain.push_back(mgr->CreateSymbol("x", 0, 32));
+  for (int i = 1; i < length; i++)
+    {
+      ASTNode times = nf->CreateTerm(BVMULT, 32, chain[i - 1], mgr->CreateBVConst(32, i));
+      chain.push_back(nf->CreateTerm(BVPLUS, 32, chain[i - 1], times));
+    }
+
+  // Lots of nodes, then lots of small traversals.
+  ASTVec others;
+  for (int i = 0; i < 1000000; i++)
+    others.push_back(mgr->CreateSymbol(("v" + std::to_string(i)).c_str(), 0, 32));
+
+  Stopwatch s;
+  long total = 0;
+  for (int i = 0; i < 100000; i++)
+    total += count(chain[i % 10 + 1], *mgr);
+  cerr << "Small traversals (" << total << " nodes) ";
+  s.stop();
+
+  return 0;
+}
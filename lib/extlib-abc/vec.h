@@ -63,6 +63,16 @@ extern "C" {
 ///                      MACRO DEFINITIONS                           ///
 ////////////////////////////////////////////////////////////////////////
 
+// For the few global tables and scratch buffers. Each thread gets
+// its own, so that separate STP instances can run on separate threads.
+#ifndef ABC_THREAD_LOCAL
+#ifdef _MSC_VER
+#define ABC_THREAD_LOCAL __declspec(thread)
+#else
+#define ABC_THREAD_LOCAL __thread
+#endif
+#endif
+
 #ifndef ABS
 #define ABS(a)			((a) < 0 ? -(a) : (a))
 #endif
@@ -263,9 +263,13 @@ namespace CONSTANTBV {
   /*   of this package! (But call only ONCE, or you      */
   /*   will suffer memory leaks!)                        */
   /*                                                     */
+  /*   BitVector_Boot() runs this the first time it is   */
+  /*   called (from whichever thread), and afterwards    */
+  /*   just returns the result.                          */
+  /*                                                     */
   /*******************************************************/
 
-  ErrCode BitVector_Boot(void) {
+  static ErrCode BIT_VECTOR_boot(void) {
     unsigned long longsample = 1L;
     unsigned int sample = LSB;
     unsigned int lsb;
@@ -310,6 +314,11 @@ namespace CONSTANTBV {
     return(ErrCode_Ok);
   }
 
+  ErrCode BitVector_Boot(void) {
+    static const ErrCode result = BIT_VECTOR_boot();
+    return(result);
+  }
+
   unsigned int BitVector_Size(unsigned int bits) {          /* bit vector size (# of words)  */
     unsigned int size;
 
@@ -0,0 +1,147 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// The fixed bits of the assertions are kept between queries, and
+// go back to what they were at a pop.
+
+#include <gtest/gtest.h>
+#include "stp/c_interface.h"
+
+static Expr
+lowNibbleIs(VC vc, Expr x, int value)
+{
+  return vc_eqExpr(vc, vc_bvExtract(vc, x, 3, 0), vc_bvConstExprFromInt(vc, 4, value));
+}
+
+// Each query is in its own context.
+static int
+query(VC vc, Expr e)
+{
+  vc_push(vc);
+  int result = vc_query(vc, e);
+  vc_pop(vc);
+  return result;
+}
+
+TEST(asserted_constant_bits, forgotten_at_pop)
+{
+  VC vc = vc_createValidityChecker();
+  Expr x = vc_varExpr(vc, "x", vc_bvType(vc, 8));
+
+  vc_push(vc);
+  vc_assertFormula(vc, lowNibbleIs(vc, x, 5));
+  ASSERT_EQ(1, query(vc, lowNibbleIs(vc, x, 5)));
+
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_eqExpr(vc, x, vc_bvConstExprFromInt(vc, 8, 5))));
+  ASSERT_EQ(5u, getBVUnsigned(vc_getCounterExample(vc, x)) & 0xF);
+  vc_pop(vc);
+  vc_pop(vc);
+
+  // So that x isn't simplified away.
+  Expr y = vc_varExpr(vc, "y", vc_bvType(vc, 8));
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 8, x, y), vc_bvConstExprFromInt(vc, 8, 0x12)));
+  ASSERT_EQ(0, query(vc, lowNibbleIs(vc, x, 5)));
+  vc_Destroy(vc);
+}
+
+// What's asserted at the bottom is used by the queries at each level.
+TEST(asserted_constant_bits, levels)
+{
+  VC vc = vc_createValidityChecker();
+  Type bv8 = vc_bvType(vc, 8);
+  Expr x = vc_varExpr(vc, "x", bv8);
+  Expr y = vc_varExpr(vc, "y", bv8);
+  Expr high = vc_bvConstExprFromInt(vc, 8, 0xF0);
+
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvAndExpr(vc, x, high), vc_bvConstExprFromInt(vc, 8, 0x30)));
+
+  for (int i = 0; i < 3; i++)
+    {
+      vc_push(vc);
+      vc_assertFormula(vc, vc_eqExpr(vc, y, vc_bvPlusExpr(vc, 8, x, vc_bvConstExprFromInt(vc, 8, 1))));
+
+      Expr yHigh = vc_bvExtract(vc, y, 7, 4);
+      Expr three = vc_eqExpr(vc, yHigh, vc_bvConstExprFromInt(vc, 4, 3));
+      Expr four = vc_eqExpr(vc, yHigh, vc_bvConstExprFromInt(vc, 4, 4));
+      ASSERT_EQ(1, query(vc, vc_orExpr(vc, three, four)));
+
+      vc_push(vc);
+      ASSERT_EQ(0, vc_query(vc, three));
+      ASSERT_EQ(0x40u, getBVUnsigned(vc_getCounterExample(vc, y)));
+      vc_pop(vc);
+      vc_pop(vc);
+
+      vc_push(vc);
+      vc_assertFormula(vc, vc_eqExpr(vc, y, x));
+      ASSERT_EQ(1, query(vc, vc_eqExpr(vc, vc_bvAndExpr(vc, y, high), vc_bvConstExprFromInt(vc, 8, 0x30))));
+      vc_pop(vc);
+    }
+
+  ASSERT_EQ(0, query(vc, vc_eqExpr(vc, y, x)));
+  vc_Destroy(vc);
+}
+
+// The assertions contradict each other, but only once the last is added.
+TEST(asserted_constant_bits, contradictory)
+{
+  VC vc = vc_createValidityChecker();
+  Expr x = vc_varExpr(vc, "x", vc_bvType(vc, 8));
+
+  vc_assertFormula(vc, lowNibbleIs(vc, x, 5));
+  ASSERT_EQ(0, query(vc, vc_falseExpr(vc)));
+
+  vc_push(vc);
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvExtract(vc, x, 0, 0), vc_bvConstExprFromInt(vc, 1, 0)));
+  ASSERT_EQ(1, query(vc, vc_falseExpr(vc)));
+  vc_pop(vc);
+
+  ASSERT_EQ(0, query(vc, vc_falseExpr(vc)));
+  ASSERT_EQ(1, query(vc, lowNibbleIs(vc, x, 5)));
+  vc_Destroy(vc);
+}
+
+// Nothing is propagated until a query, so the first query propagates
+// what was asserted at every level, and a pop still goes back.
+TEST(asserted_constant_bits, queried_at_the_top)
+{
+  VC vc = vc_createValidityChecker();
+  Expr x = vc_varExpr(vc, "x", vc_bvType(vc, 16));
+  Expr bit4 = vc_bvExtract(vc, x, 4, 4);
+  Expr one = vc_bvConstExprFromInt(vc, 1, 1);
+
+  vc_assertFormula(vc, lowNibbleIs(vc, x, 5));
+  vc_push(vc);
+  vc_assertFormula(vc, vc_eqExpr(vc, bit4, one));
+  vc_push(vc);
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvExtract(vc, x, 15, 8), vc_bvConstExprFromInt(vc, 8, 0xAB)));
+
+  ASSERT_EQ(1, query(vc, vc_eqExpr(vc, vc_bvExtract(vc, x, 4, 0), vc_bvConstExprFromInt(vc, 5, 0x15))));
+  vc_pop(vc);
+  vc_pop(vc);
+
+  ASSERT_EQ(0, query(vc, vc_eqExpr(vc, bit4, one)));
+  ASSERT_EQ(1, query(vc, lowNibbleIs(vc, x, 5)));
+  vc_Destroy(vc);
+}
@@ -0,0 +1,296 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+// Checks BatchEvaluator, lane by lane, against NonMemberBVConstEvaluator.
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <random>
+#include <string>
+#include "stp/STPManager/STPManager.h"
+#include "stp/Simplifier/simplifier.h"
+#include "stp/Simplifier/BatchEvaluator.h"
+
+using namespace BEEV;
+
+static const int lanes = BatchEvaluator::Lanes;
+
+// The widths either side of the word boundaries.
+static const unsigned widths[] = {1, 2, 7, 31, 32, 33, 63, 64, 65, 100, 128, 129};
+static const int numberOfWidths = sizeof(widths) / sizeof(widths[0]);
+
+static uint64_t
+random64(std::mt19937_64& rng)
+{
+  // Favour the edge cases.
+  switch (rng() % 8)
+    {
+  case 0:
+    return 0;
+  case 1:
+    return 1;
+  case 2:
+    return ~(uint64_t) 0;
+  case 3:
+    return rng() & 0xff;
+  default:
+    return rng();
+    }
+}
+
+static ASTNode
+constant(STPMgr& bm, unsigned width, std::mt19937_64& rng)
+{
+  CBV c = CONSTANTBV::BitVector_Create(width, true);
+  for (unsigned i = 0; i < width; i += 64)
+    {
+      const uint64_t r = random64(rng);
+      for (unsigned j = 0; j < 64 && i + j < width; j++)
+        if ((r >> j) & 1)
+          CONSTANTBV::BitVector_Bit_On(c, i + j);
+    }
+  return bm.CreateBVConst(c, width);
+}
+
+// The constant v, which is truncated to width bits.
+static ASTNode
+constant(STPMgr& bm, unsigned width, uint64_t v)
+{
+  CBV c = CONSTANTBV::BitVector_Create(width, true);
+  for (unsigned j = 0; j < 64 && j < width; j++)
+    if ((v >> j) & 1)
+      CONSTANTBV::BitVector_Bit_On(c, j);
+  return bm.CreateBVConst(c, width);
+}
+
+class Generator
+{
+  STPMgr& bm;
+  NodeFactory* nf;
+  std::mt19937_64& rng;
+  const ASTVec& vars;
+  const unsigned width;
+
+public:
+  Generator(STPMgr& _bm, std::mt19937_64& _rng, const ASTVec& _vars, unsigned _width) :
+    bm(_bm), nf(_bm.hashingNodeFactory), rng(_rng), vars(_vars), width(_width)
+  {
+  }
+
+  ASTNode
+  formula(int depth)
+  {
+    const Kind predicates[] = {EQ, BVLT, BVLE, BVGT, BVGE, BVSLT, BVSLE, BVSGT, BVSGE};
+    const Kind connectives[] = {NOT, AND, OR, XOR, NAND, NOR, IFF, IMPLIES};
+
+    if (depth <= 0 || rng() % 3 == 0)
+      {
+        if (rng() % 4 == 0)
+          return nf->CreateNode(BOOLEXTRACT, term(depth - 1), bm.CreateBVConst(32, rng() % width));
+        return nf->CreateNode(predicates[rng() % 9], term(depth - 1), term(depth - 1));
+      }
+
+    const Kind k = connectives[rng() % 8];
+    if (k == NOT)
+      return nf->CreateNode(NOT, formula(depth - 1));
+    return nf->CreateNode(k, formula(depth - 1), formula(depth - 1));
+  }
+
+  ASTNode
+  term(int depth)
+  {
+    const Kind binary[] = {BVPLUS, BVSUB, BVMULT, BVAND, BVOR, BVXOR, BVDIV, BVMOD, SBVDIV, SBVREM, SBVMOD,
+        BVLEFTSHIFT, BVRIGHTSHIFT, BVSRSHIFT};
+    const int nBinary = sizeof(binary) / sizeof(binary[0]);
+
+    if (depth <= 0 || rng() % 5 == 0)
+      return (rng() % 4 == 0) ? constant(bm, width, rng) : vars[rng() % vars.size()];
+
+    const int r = rng() % (nBinary + 5);
+    if (r < nBinary)
+      return nf->CreateTerm(binary[r], width, term(depth - 1), term(depth - 1));
+
+    switch (r - nBinary)
+      {
+    case 0:
+      return nf->CreateTerm(BVNEG, width, term(depth - 1));
+    case 1:
+      return nf->CreateTerm(BVUMINUS, width, term(depth - 1));
+    case 2:
+      return nf->CreateTerm(ITE, width, formula(depth - 1), term(depth - 1), term(depth - 1));
+    case 3:
+      {
+        // Extract the top part, then extend it back.
+        const unsigned low = rng() % width;
+        ASTNode e = nf->CreateTerm(BVEXTRACT, width - low, term(depth - 1), bm.CreateBVConst(32, width - 1),
+            bm.CreateBVConst(32, low));
+        if (low == 0)
+          return e;
+        return nf->CreateTerm((rng() % 2) ? BVSX : BVZX, width, e, bm.CreateBVConst(32, width));
+      }
+    default:
+      {
+        // Split into two pieces, then concatenate them.
+        if (width == 1)
+          return term(depth - 1);
+        const unsigned split = 1 + rng() % (width - 1);
+        ASTNode hi = nf->CreateTerm(BVEXTRACT, width - split, term(depth - 1), bm.CreateBVConst(32, width - 1),
+            bm.CreateBVConst(32, split));
+        ASTNode lo = nf->CreateTerm(BVEXTRACT, split, term(depth - 1), bm.CreateBVConst(32, split - 1),
+            bm.CreateBVConst(32, 0));
+        return nf->CreateTerm(BVCONCAT, width, hi, lo);
+      }
+      }
+  }
+};
+
+// Evaluates n with the symbols replaced by the values in the map.
+static ASTNode
+eval(STPMgr& bm, const ASTNode& n, ASTNodeMap& map)
+{
+  if (n.isConstant())
+    return n;
+
+  ASTNodeMap::const_iterator it = map.find(n);
+  if (it != map.end())
+    return it->second;
+
+  ASTVec children;
+  for (size_t i = 0; i < n.Degree(); i++)
+    children.push_back(eval(bm, n[i], map));
+
+  const ASTNode r = NonMemberBVConstEvaluator(&bm, n.GetKind(), children, n.GetValueWidth());
+  map.insert(std::make_pair(n, r));
+  return r;
+}
+
+// Evaluates each of nodes in every lane, with the lanes' values of the
+// symbols, and compares what the two evaluators give.
+static void
+compare(STPMgr& bm, const ASTVec& nodes, std::vector<ASTNodeMap>& models)
+{
+  BatchEvaluator batch(&bm);
+  for (int lane = 0; lane < lanes; lane++)
+    for (ASTNodeMap::const_iterator it = models[lane].begin(); it != models[lane].end(); it++)
+      batch.setValue(it->first, lane, it->second);
+
+  for (size_t i = 0; i < nodes.size(); i++)
+    {
+      ASSERT_TRUE(batch.evaluate(nodes[i]));
+      for (int lane = 0; lane < lanes; lane++)
+        ASSERT_TRUE(eval(bm, nodes[i], models[lane]) == batch.getValue(nodes[i], lane))
+            << "node " << i << " of width " << nodes[i].GetValueWidth() << ", lane " << lane;
+    }
+}
+
+TEST(batch_eval, random)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  bm.UserFlags.division_by_zero_returns_one_flag = true;
+  NodeFactory* nf = bm.hashingNodeFactory;
+  std::mt19937_64 rng(5);
+
+  for (int round = 0; round < 3 * numberOfWidths; round++)
+    {
+      const unsigned width = widths[round % numberOfWidths];
+
+      ASTVec vars;
+      for (int i = 0; i < 3; i++)
+        vars.push_back(nf->CreateSymbol(("v" + std::to_string(i) + "_" + std::to_string(width)).c_str(), 0, width));
+      const ASTNode b = nf->CreateSymbol("b", 0, 0);
+
+      Generator g(bm, rng, vars, width);
+      ASTVec nodes;
+      nodes.push_back(g.term(5));
+      nodes.push_back(nf->CreateNode(IFF, b, g.formula(4)));
+
+      std::vector<ASTNodeMap> models(lanes);
+      for (int lane = 0; lane < lanes; lane++)
+        {
+          for (size_t i = 0; i < vars.size(); i++)
+            models[lane].insert(std::make_pair(vars[i], constant(bm, width, rng)));
+          models[lane].insert(std::make_pair(b, (rng() % 2) ? bm.ASTTrue : bm.ASTFalse));
+        }
+
+      compare(bm, nodes, models);
+      if (HasFatalFailure())
+        return;
+    }
+}
+
+// Divides by zero in some lanes and not in others, and shifts by the
+// width, by more, and by less.
+TEST(batch_eval, division_by_zero_and_long_shifts)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  bm.UserFlags.division_by_zero_returns_one_flag = true;
+  NodeFactory* nf = bm.hashingNodeFactory;
+  std::mt19937_64 rng(7);
+
+  const unsigned edges[] = {1, 63, 64, 65};
+  for (int e = 0; e < 4; e++)
+    {
+      const unsigned width = edges[e];
+      const ASTNode x = nf->CreateSymbol(("x" + std::to_string(width)).c_str(), 0, width);
+      const ASTNode y = nf->CreateSymbol(("y" + std::to_string(width)).c_str(), 0, width);
+
+      ASTVec nodes;
+      const Kind kinds[] = {BVDIV, BVMOD, SBVDIV, SBVREM, SBVMOD, BVLEFTSHIFT, BVRIGHTSHIFT, BVSRSHIFT};
+      for (int k = 0; k < 8; k++)
+        nodes.push_back(nf->CreateTerm(kinds[k], width, x, y));
+
+      std::vector<ASTNodeMap> models(lanes);
+      for (int lane = 0; lane < lanes; lane++)
+        {
+          ASTNode divisor;
+          switch (lane % 8)
+            {
+          case 0:
+            divisor = constant(bm, width, (uint64_t) 0);
+            break;
+          case 1:
+            divisor = constant(bm, width, (uint64_t) width);
+            break;
+          case 2:
+            divisor = constant(bm, width, (uint64_t) width + 1);
+            break;
+          case 3:
+            divisor = constant(bm, width, ~(uint64_t) 0);
+            break;
+          case 4:
+            divisor = constant(bm, width, (uint64_t) (rng() % width));
+            break;
+          default:
+            divisor = constant(bm, width, rng);
+            }
+          models[lane].insert(std::make_pair(x, constant(bm, width, rng)));
+          models[lane].insert(std::make_pair(y, divisor));
+        }
+
+      compare(bm, nodes, models);
+      if (HasFatalFailure())
+        return;
+    }
+}
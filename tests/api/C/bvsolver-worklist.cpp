@@ -0,0 +1,79 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Equations the word-level solver can only solve once others have been.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "stp/c_interface.h"
+
+// a[i] * a[i+1] = k[i] can't be solved until a[i+1] has been, and
+// a[n] is only given last.
+TEST(bvsolver_worklist, solved_backwards)
+{
+  const int n = 200;
+  VC vc = vc_createValidityChecker();
+  Type bv32 = vc_bvType(vc, 32);
+
+  std::vector<Expr> a;
+  std::vector<unsigned> value;
+  for (int i = 0; i <= n; i++)
+    {
+      char name[16];
+      sprintf(name, "a%d", i);
+      a.push_back(vc_varExpr(vc, name, bv32));
+      value.push_back(2 * (i * 2654435761u) + 1);
+    }
+
+  for (int i = 0; i < n; i++)
+    {
+      Expr k = vc_bvConstExprFromInt(vc, 32, value[i] * value[i + 1]);
+      vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 32, a[i], a[i + 1]), k));
+    }
+  vc_assertFormula(vc, vc_eqExpr(vc, a[n], vc_bvConstExprFromInt(vc, 32, value[n])));
+
+  Expr all = vc_trueExpr(vc);
+  for (int i = 0; i <= n; i++)
+    all = vc_andExpr(vc, all, vc_eqExpr(vc, a[i], vc_bvConstExprFromInt(vc, 32, value[i])));
+  ASSERT_EQ(1, vc_query(vc, all));
+  vc_Destroy(vc);
+}
+
+// Solving for a variable makes another equation false.
+TEST(bvsolver_worklist, false_after_substitution)
+{
+  VC vc = vc_createValidityChecker();
+  Type bv32 = vc_bvType(vc, 32);
+  Expr x = vc_varExpr(vc, "x", bv32);
+  Expr y = vc_varExpr(vc, "y", bv32);
+  Expr three = vc_bvConstExprFromInt(vc, 32, 3);
+
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 32, x, y), vc_bvConstExprFromInt(vc, 32, 4)));
+  vc_assertFormula(vc, vc_eqExpr(vc, y, vc_bvConstExprFromInt(vc, 32, 2)));
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 32, x, three), vc_bvConstExprFromInt(vc, 32, 7)));
+
+  ASSERT_EQ(1, vc_query(vc, vc_falseExpr(vc)));
+  vc_Destroy(vc);
+}
@@ -0,0 +1,98 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Constant bit propagation over bit-vectors that span several words.
+
+#include <gtest/gtest.h>
+#include "stp/c_interface.h"
+
+static const int width = 130;
+
+// Constants are made from at most 64 bits, so wider ones are zero extended.
+static Expr constant(VC vc, int bits, unsigned long long value)
+{
+  if (bits <= 64)
+    return vc_bvConstExprFromLL(vc, bits, value);
+  return vc_bvConcatExpr(vc, constant(vc, bits - 64, 0), vc_bvConstExprFromLL(vc, 64, value));
+}
+
+TEST(constant_bits, shifted_out)
+{
+  VC vc = vc_createValidityChecker();
+  Expr x = vc_varExpr(vc, "x", vc_bvType(vc, width));
+
+  // The bottom 70 bits of x << 70 are zero, the top ones are x's bottom.
+  Expr shifted = vc_bvLeftShiftExprExpr(vc, width, x, constant(vc, width, 70));
+  Expr low = vc_bvExtract(vc, shifted, 69, 0);
+  Expr high = vc_bvExtract(vc, shifted, width - 1, 70);
+  Expr q = vc_andExpr(vc, vc_eqExpr(vc, low, constant(vc, 70, 0)),
+                      vc_eqExpr(vc, high, vc_bvExtract(vc, x, width - 71, 0)));
+  ASSERT_EQ(1, vc_query(vc, q));
+  vc_Destroy(vc);
+}
+
+TEST(constant_bits, boolean_across_words)
+{
+  VC vc = vc_createValidityChecker();
+  Expr x = vc_varExpr(vc, "x", vc_bvType(vc, width));
+  Expr y = vc_varExpr(vc, "y", vc_bvType(vc, width));
+  Expr zero = constant(vc, width, 0);
+
+  // (x | ~x) & ~(y ^ y) is all ones.
+  Expr ones = vc_bvNotExpr(vc, zero);
+  Expr e = vc_bvAndExpr(vc, vc_bvOrExpr(vc, x, vc_bvNotExpr(vc, x)),
+                        vc_bvNotExpr(vc, vc_bvXorExpr(vc, y, y)));
+  ASSERT_EQ(1, vc_query(vc, vc_eqExpr(vc, e, ones)));
+
+  // Setting bit 100 of x gives a value that's not zero, and whose bit 100 is set.
+  Expr bit = vc_bvLeftShiftExprExpr(vc, width, constant(vc, width, 1),
+                                    constant(vc, width, 100));
+  Expr set = vc_bvOrExpr(vc, x, bit);
+  ASSERT_EQ(1, vc_query(vc, vc_notExpr(vc, vc_eqExpr(vc, set, zero))));
+  ASSERT_EQ(1, vc_query(vc, vc_eqExpr(vc, vc_bvExtract(vc, set, 100, 100),
+                                      vc_bvConstExprFromInt(vc, 1, 1))));
+  vc_Destroy(vc);
+}
+
+TEST(constant_bits, addition_carries_between_words)
+{
+  VC vc = vc_createValidityChecker();
+  Expr x = vc_varExpr(vc, "x", vc_bvType(vc, width));
+
+  // If the bottom 64 bits of x are all ones, x + 1 carries into bit 64.
+  Expr low = vc_bvExtract(vc, x, 63, 0);
+  Expr allOnes = vc_bvNotExpr(vc, constant(vc, 64, 0));
+  Expr sum = vc_bvPlusExpr(vc, width, x, constant(vc, width, 1));
+  Expr q = vc_impliesExpr(vc, vc_eqExpr(vc, low, allOnes),
+                          vc_eqExpr(vc, vc_bvExtract(vc, sum, 63, 0),
+                                    constant(vc, 64, 0)));
+  ASSERT_EQ(1, vc_query(vc, q));
+
+  // But bit 64 of the sum can be either value.
+  Expr bit = vc_bvExtract(vc, sum, 64, 64);
+  Expr q2 = vc_impliesExpr(vc, vc_eqExpr(vc, low, allOnes),
+                           vc_eqExpr(vc, bit, vc_bvConstExprFromInt(vc, 1, 1)));
+  ASSERT_EQ(0, vc_query(vc, q2));
+  vc_Destroy(vc);
+}
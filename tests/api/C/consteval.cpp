@@ -0,0 +1,196 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+// Checks the 64-bit fast path of constant folding against the general code.
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <random>
+#include <string>
+#include "stp/STPManager/STPManager.h"
+#include "stp/Simplifier/simplifier.h"
+
+using namespace BEEV;
+
+static uint64_t
+mask(unsigned width)
+{
+  return (width >= 64) ? ~(uint64_t) 0 : (((uint64_t) 1) << width) - 1;
+}
+
+// Mostly the values at the edges, where the fast path could go wrong.
+static uint64_t
+operand(std::mt19937_64& rng, unsigned width)
+{
+  uint64_t v;
+  switch (rng() % 8)
+    {
+  case 0:
+    v = 0;
+    break;
+  case 1:
+    v = 1;
+    break;
+  case 2:
+    v = ~(uint64_t) 0;
+    break;
+  case 3:
+    v = ((uint64_t) 1) << (width - 1); // the most negative value.
+    break;
+  case 4:
+    v = (((uint64_t) 1) << (width - 1)) - 1; // the most positive value.
+    break;
+  case 5:
+    v = rng() % (width + 3); // a shift amount, sometimes past the width.
+    break;
+  default:
+    v = rng();
+    }
+  return v & mask(width);
+}
+
+static ASTNode
+constant(STPMgr& bm, unsigned width, uint64_t v)
+{
+  return bm.CreateBVConst(width, (unsigned long long) v);
+}
+
+static ASTVec
+nodes(const ASTNode& a, const ASTNode& b = ASTNode(), const ASTNode& c = ASTNode())
+{
+  ASTVec v;
+  v.push_back(a);
+  if (!b.IsNull())
+    v.push_back(b);
+  if (!c.IsNull())
+    v.push_back(c);
+  return v;
+}
+
+// Printing a node needs the parser's manager, so constants are printed here.
+static std::string
+str(const ASTNode& n)
+{
+  if (BVCONST != n.GetKind())
+    return _kind_names[n.GetKind()];
+
+  unsigned char* hex = CONSTANTBV::BitVector_to_Hex(n.GetBVConst());
+  const std::string s = "0x" + std::string((char*) hex);
+  CONSTANTBV::BitVector_Dispose(hex);
+  return s;
+}
+
+// Folds with and without the fast path, which must agree.
+static void
+check(STPMgr& bm, Kind k, const ASTVec& children, unsigned width)
+{
+  const ASTNode fast = NonMemberBVConstEvaluator(&bm, k, children, width);
+  const ASTNode general = NonMemberBVConstEvaluator(&bm, k, children, width, false);
+  if (fast == general)
+    return;
+
+  std::string of;
+  for (size_t i = 0; i < children.size(); i++)
+    of += " " + str(children[i]);
+  ADD_FAILURE() << _kind_names[k] << " at width " << width << " of" << of << " gives " << str(fast) << " not "
+                << str(general);
+}
+
+static void
+checkAll(STPMgr& bm, unsigned rounds)
+{
+  const Kind terms[] = {BVPLUS, BVSUB, BVMULT, BVDIV, BVMOD, SBVDIV, SBVREM, SBVMOD, BVAND, BVOR, BVXOR,
+                        BVLEFTSHIFT, BVRIGHTSHIFT, BVSRSHIFT};
+  const Kind predicates[] = {EQ, BVLT, BVLE, BVGT, BVGE, BVSLT, BVSLE, BVSGT, BVSGE};
+  std::mt19937_64 rng(7);
+
+  for (unsigned width = 1; width <= 64; width++)
+    for (unsigned r = 0; r < rounds; r++)
+      {
+        const ASTNode a = constant(bm, width, operand(rng, width));
+        const ASTNode b = constant(bm, width, operand(rng, width));
+        const ASTVec ab = nodes(a, b);
+
+        for (size_t i = 0; i < sizeof(terms) / sizeof(terms[0]); i++)
+          check(bm, terms[i], ab, width);
+        for (size_t i = 0; i < sizeof(predicates) / sizeof(predicates[0]); i++)
+          check(bm, predicates[i], ab, 0);
+
+        check(bm, BVNEG, nodes(a), width);
+        check(bm, BVUMINUS, nodes(a), width);
+        check(bm, BVPLUS, nodes(a, b, a), width);
+        check(bm, BVMULT, nodes(a, b, b), width);
+
+        const unsigned low = rng() % width;
+        const unsigned high = low + rng() % (width - low);
+        check(bm, BVEXTRACT, nodes(a, constant(bm, 32, high), constant(bm, 32, low)), high - low + 1);
+        check(bm, BOOLEXTRACT, nodes(a, constant(bm, 32, low)), 0);
+
+        const unsigned wider = width + rng() % (65 - width);
+        check(bm, BVSX, nodes(a, constant(bm, 32, wider)), wider);
+        check(bm, BVZX, nodes(a, constant(bm, 32, wider)), wider);
+
+        // Sometimes too wide for the fast path.
+        const unsigned other = 1 + rng() % 64;
+        check(bm, BVCONCAT, nodes(a, constant(bm, other, operand(rng, other))), width + other);
+      }
+}
+
+TEST(consteval, division_by_zero_returns_one)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  bm.UserFlags.division_by_zero_returns_one_flag = true;
+  checkAll(bm, 200);
+}
+
+// Without the flag, an unsigned division by zero gives zero, but only
+// while a counterexample is being checked.
+TEST(consteval, division_by_zero_is_undefined)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  bm.UserFlags.division_by_zero_returns_one_flag = false;
+  bm.counterexample_checking_during_refinement = true;
+
+  std::mt19937_64 rng(11);
+  for (unsigned width = 1; width <= 64; width++)
+    for (unsigned r = 0; r < 20; r++)
+      {
+        const ASTNode a = constant(bm, width, operand(rng, width));
+        const ASTNode b = constant(bm, width, operand(rng, width) | 1);
+        check(bm, BVDIV, nodes(a, b), width);
+        check(bm, BVMOD, nodes(a, b), width);
+        check(bm, SBVDIV, nodes(a, b), width);
+        check(bm, SBVREM, nodes(a, b), width);
+        check(bm, SBVMOD, nodes(a, b), width);
+
+        const ASTNode zero = bm.CreateZeroConst(width);
+        bm.bvdiv_exception_occured = false;
+        check(bm, BVDIV, nodes(a, zero), width);
+        ASSERT_TRUE(bm.bvdiv_exception_occured);
+        bm.bvdiv_exception_occured = false;
+        check(bm, BVMOD, nodes(a, zero), width);
+        ASSERT_TRUE(bm.bvdiv_exception_occured);
+      }
+}
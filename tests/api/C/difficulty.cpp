@@ -0,0 +1,109 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// The difficulty calibration log, and reading fitted difficulty models.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "stp/c_interface.h"
+
+static const char* logName = "difficulty-test.log";
+static const char* modelName = "difficulty-test.model";
+
+// Solves a query with a multiplication in it (which 143 = 11 * 13
+// satisfies), logging to logName,
+// and returns the line logged.
+static std::string solveLogged(const char* model)
+{
+  std::remove(logName);
+
+  VC vc = vc_createValidityChecker();
+  if (model != NULL)
+    EXPECT_EQ(1, vc_loadDifficultyModel(vc, model));
+  vc_logDifficulty(vc, logName);
+
+  Expr x = vc_varExpr(vc, "x", vc_bvType(vc, 16));
+  Expr y = vc_varExpr(vc, "y", vc_bvType(vc, 16));
+  Expr product = vc_bvMultExpr(vc, 16, x, y);
+  vc_push(vc);
+  Expr one = vc_bvConstExprFromInt(vc, 16, 1);
+  Expr factors = vc_andExpr(vc, vc_bvGtExpr(vc, x, one), vc_bvGtExpr(vc, y, one));
+  Expr q = vc_andExpr(vc, vc_eqExpr(vc, product, vc_bvConstExprFromInt(vc, 16, 143)), factors);
+  EXPECT_EQ(0, vc_query(vc, vc_notExpr(vc, q)));
+  vc_pop(vc);
+  vc_Destroy(vc);
+
+  std::ifstream in(logName);
+  std::string line, rest;
+  std::getline(in, line);
+  EXPECT_FALSE(std::getline(in, rest));
+  std::remove(logName);
+  return line;
+}
+
+static long field(const std::string& line, const std::string& name)
+{
+  const size_t at = line.find(name + ":");
+  if (at == std::string::npos)
+    return -1;
+  return atol(line.c_str() + at + name.size() + 1);
+}
+
+TEST(difficulty, log)
+{
+  const std::string line = solveLogged(NULL);
+  ASSERT_GT(field(line, "score"), 0);
+  ASSERT_GT(field(line, "aig"), 0);
+  ASSERT_GT(field(line, "cnf_vars"), 0);
+  ASSERT_GT(field(line, "cnf_clauses"), 0);
+  ASSERT_GE(field(line, "solve_ms"), 0);
+  ASSERT_NE(std::string::npos, line.find("\tBVMULT:"));
+}
+
+TEST(difficulty, model)
+{
+  const long before = field(solveLogged(NULL), "score");
+
+  {
+    std::ofstream out(modelName);
+    out << "# kind linear quadratic" << std::endl;
+    out << "BVMULT 0 1000" << std::endl;
+  }
+  const long after = field(solveLogged(modelName), "score");
+  ASSERT_GE(after, before + 1000 * 16 * 16 - 5 * 16 * 16);
+
+  // A malformed model is rejected, and changes nothing.
+  {
+    std::ofstream out(modelName);
+    out << "BVMULT 0 1000" << std::endl;
+    out << "NOT_A_KIND 1 1" << std::endl;
+  }
+  VC vc = vc_createValidityChecker();
+  ASSERT_EQ(0, vc_loadDifficultyModel(vc, modelName));
+  ASSERT_EQ(0, vc_loadDifficultyModel(vc, "no-such-difficulty-model"));
+  vc_Destroy(vc);
+  std::remove(modelName);
+}
@@ -0,0 +1,90 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Long chains of equalities between variables, as in SSA form.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "stp/c_interface.h"
+
+// Asserts x[i] = x[i+1] for each i, in a scrambled order.
+static std::vector<Expr> chain(VC vc, int n)
+{
+  Type bv32 = vc_bvType(vc, 32);
+  std::vector<Expr> x;
+  for (int i = 0; i <= n; i++)
+    {
+      char name[16];
+      sprintf(name, "x%d", i);
+      x.push_back(vc_varExpr(vc, name, bv32));
+    }
+
+  for (int k = 0; k < n; k++)
+    {
+      const int i = (k * 7919) % n;
+      vc_assertFormula(vc, vc_eqExpr(vc, x[i], x[i + 1]));
+    }
+  return x;
+}
+
+TEST(equality_chains, ends_equal)
+{
+  const int n = 3000;
+  VC vc = vc_createValidityChecker();
+  std::vector<Expr> x = chain(vc, n);
+  Expr seven = vc_bvConstExprFromInt(vc, 32, 7);
+  vc_assertFormula(vc, vc_bvGtExpr(vc, x[n / 2], seven));
+
+  vc_push(vc);
+  ASSERT_EQ(1, vc_query(vc, vc_bvGtExpr(vc, x[0], seven)));
+  vc_pop(vc);
+
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_eqExpr(vc, x[n], vc_bvConstExprFromInt(vc, 32, 8))));
+  Expr first = vc_getCounterExample(vc, x[0]);
+  Expr last = vc_getCounterExample(vc, x[n]);
+  ASSERT_EQ(getBVUnsigned(first), getBVUnsigned(last));
+  ASSERT_NE(8u, getBVUnsigned(last));
+  vc_DeleteExpr(first);
+  vc_DeleteExpr(last);
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+}
+
+// The chain ends at something that isn't a variable, and is closed into
+// a loop that can't hold.
+TEST(equality_chains, loop_through_term)
+{
+  const int n = 500;
+  VC vc = vc_createValidityChecker();
+  std::vector<Expr> x = chain(vc, n);
+  Expr one = vc_bvConstExprFromInt(vc, 32, 1);
+  vc_assertFormula(vc, vc_eqExpr(vc, x[n], vc_bvPlusExpr(vc, 32, x[0], one)));
+
+  ASSERT_EQ(1, vc_query(vc, vc_falseExpr(vc)));
+  vc_Destroy(vc);
+}
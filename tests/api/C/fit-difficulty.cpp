@@ -0,0 +1,112 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+// Runs fit_difficulty on a small log and reads back the model it fits.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include "stp/c_interface.h"
+
+static const char* logName = "fit-difficulty-test.log";
+static const char* modelName = "fit-difficulty-test.model";
+
+// Solves for factors of 143 at widths 8 to 32, logging each query to
+// logName, with the coefficients from model if it's given.
+static void solveLogged(const char* model)
+{
+  std::remove(logName);
+  for (int width = 8; width <= 32; width += 4)
+    {
+      VC vc = vc_createValidityChecker();
+      if (model != NULL)
+        ASSERT_EQ(1, vc_loadDifficultyModel(vc, model));
+      vc_logDifficulty(vc, logName);
+
+      Expr x = vc_varExpr(vc, "x", vc_bvType(vc, width));
+      Expr y = vc_varExpr(vc, "y", vc_bvType(vc, width));
+      Expr one = vc_bvConstExprFromInt(vc, width, 1);
+      Expr product = vc_bvMultExpr(vc, width, x, y);
+      Expr factors = vc_andExpr(vc, vc_bvGtExpr(vc, x, one), vc_bvGtExpr(vc, y, one));
+      Expr q = vc_andExpr(vc, vc_eqExpr(vc, product, vc_bvConstExprFromInt(vc, width, 143)), factors);
+      ASSERT_EQ(0, vc_query(vc, vc_notExpr(vc, q)));
+      vc_Destroy(vc);
+    }
+}
+
+static double field(const std::string& line, const std::string& name)
+{
+  const size_t at = line.find(name + ":");
+  EXPECT_NE(std::string::npos, at) << line;
+  return atof(line.c_str() + at + name.size() + 1);
+}
+
+// The mean of |score - aig| / aig over the lines of logName.
+static double meanError()
+{
+  std::ifstream in(logName);
+  std::string line;
+  double total = 0;
+  int lines = 0;
+  while (std::getline(in, line))
+    {
+      const double aig = field(line, "aig");
+      total += std::fabs(field(line, "score") - aig) / aig;
+      lines++;
+    }
+  EXPECT_EQ(7, lines);
+  return total / lines;
+}
+
+TEST(fit_difficulty, log)
+{
+  solveLogged(NULL);
+  const double before = meanError();
+
+  const std::string command = std::string(FIT_DIFFICULTY) + " " + logName + " > " + modelName;
+  ASSERT_EQ(0, std::system(command.c_str()));
+
+  // The fitted model scores the same queries closer to their real size.
+  solveLogged(modelName);
+  const double after = meanError();
+  ASSERT_LT(after, before);
+
+  std::remove(logName);
+  std::remove(modelName);
+}
+
+TEST(fit_difficulty, bad_log)
+{
+  {
+    std::ofstream out(logName);
+    out << "score:10\tBVMULT:1,1" << std::endl;
+  }
+  const std::string command = std::string(FIT_DIFFICULTY) + " " + logName + " > " + modelName + " 2> /dev/null";
+  ASSERT_NE(0, std::system(command.c_str()));
+
+  std::remove(logName);
+  std::remove(modelName);
+}
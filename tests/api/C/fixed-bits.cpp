@@ -0,0 +1,703 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+// Checks the word-at-a-time FixedBits helpers and transfer functions
+// bit by bit, at widths either side of the word boundaries, and with
+// offsets that cross them.
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <random>
+#include <sstream>
+#include "stp/STPManager/STPManager.h"
+#include "stp/Simplifier/simplifier.h"
+#include "stp/Simplifier/constantBitP/FixedBits.h"
+#include "stp/Simplifier/constantBitP/ConstantBitP_TransferFunctions.h"
+#include "stp/Simplifier/constantBitP/ConstantBitP_Utility.h"
+
+using namespace BEEV;
+using namespace simplifier::constantBitP;
+
+typedef std::vector<bool> Bits;
+
+static const unsigned widths[] = {1, 2, 31, 32, 33, 63, 64, 65, 127, 128, 129, 130};
+static const int numberOfWidths = sizeof(widths) / sizeof(widths[0]);
+
+// Whole words of zeroes or ones are likely, so that carries and
+// comparisons run across the word boundaries.
+static Bits
+randomBits(std::mt19937_64& rng, unsigned width)
+{
+  Bits result(width);
+  for (unsigned i = 0; i < width; i += 64)
+    {
+      uint64_t w;
+      switch (rng() % 4)
+        {
+      case 0:
+        w = 0;
+        break;
+      case 1:
+        w = ~(uint64_t) 0;
+        break;
+      default:
+        w = rng();
+        }
+      for (unsigned j = 0; j < 64 && i + j < width; j++)
+        result[i + j] = (w >> j) & 1;
+    }
+  return result;
+}
+
+static Bits
+fromUnsigned(unsigned width, uint64_t v)
+{
+  Bits result(width);
+  for (unsigned j = 0; j < 64 && j < width; j++)
+    result[j] = (v >> j) & 1;
+  return result;
+}
+
+static ASTNode
+toNode(STPMgr& bm, const Bits& b, bool isBoolean)
+{
+  if (isBoolean)
+    return b[0] ? bm.ASTTrue : bm.ASTFalse;
+
+  CBV c = CONSTANTBV::BitVector_Create(b.size(), true);
+  for (unsigned i = 0; i < b.size(); i++)
+    if (b[i])
+      CONSTANTBV::BitVector_Bit_On(c, i);
+  return bm.CreateBVConst(c, b.size());
+}
+
+static Bits
+fromNode(const ASTNode& n)
+{
+  if (n.GetKind() == TRUE || n.GetKind() == FALSE)
+    return Bits(1, n.GetKind() == TRUE);
+
+  Bits result(n.GetValueWidth());
+  for (unsigned i = 0; i < result.size(); i++)
+    result[i] = CONSTANTBV::BitVector_bit_test(n.GetBVConst(), i);
+  return result;
+}
+
+// Fixes each bit to its value in b with a chance of quarters / 4.
+static FixedBits
+abstraction(const Bits& b, bool isBoolean, std::mt19937_64& rng, unsigned quarters)
+{
+  FixedBits result(b.size(), isBoolean);
+  for (unsigned i = 0; i < b.size(); i++)
+    if (rng() % 4 < quarters)
+      {
+        result.setFixed(i, true);
+        result.setValue(i, b[i]);
+      }
+  return result;
+}
+
+// Fixes a random part of the bits to random values.
+static FixedBits
+randomFixedBits(unsigned width, std::mt19937_64& rng)
+{
+  return abstraction(randomBits(rng, width), false, rng, rng() % 5);
+}
+
+// Whether every bit that's fixed has its value in b.
+static bool
+agrees(const FixedBits& f, const Bits& b)
+{
+  for (unsigned i = 0; i < b.size(); i++)
+    if (f.isFixed(i) && f.getValue(i) != b[i])
+      return false;
+  return true;
+}
+
+static bool
+same(const FixedBits& a, const FixedBits& b)
+{
+  if (a.getWidth() != b.getWidth())
+    return false;
+  for (unsigned i = 0; i < a.getWidth(); i++)
+    if (a[i] != b[i])
+      return false;
+  return true;
+}
+
+static std::string
+show(const FixedBits& f)
+{
+  std::string result;
+  for (unsigned i = f.getWidth(); i-- > 0;)
+    result += f[i];
+  return result;
+}
+
+TEST(fixed_bits, words)
+{
+  std::mt19937_64 rng(1);
+  for (int w = 0; w < numberOfWidths; w++)
+    for (int round = 0; round < 50; round++)
+      {
+        const unsigned width = widths[w];
+        FixedBits f = randomFixedBits(width, rng);
+
+        // Reading 64 bits from any position.
+        for (unsigned from = 0; from < width + 64; from++)
+          {
+            uint64_t fixed = 0, value = 0;
+            for (unsigned j = 0; j < 64 && from + j < width; j++)
+              if (f.isFixed(from + j))
+                {
+                  fixed |= (uint64_t) 1 << j;
+                  if (f.getValue(from + j))
+                    value |= (uint64_t) 1 << j;
+                }
+            ASSERT_EQ(fixed, f.getFixedAt(from)) << width << " " << from;
+            ASSERT_EQ(value, f.getValueAt(from) & fixed) << width << " " << from;
+          }
+
+        // The queries.
+        unsigned count = 0;
+        int least = -1, most = -1, possibleOne = -1, firstPossibleOne = -1, firstOne = -1;
+        bool zero = true;
+        for (unsigned i = 0; i < width; i++)
+          {
+            if (f.isFixed(i))
+              count++;
+            else
+              {
+                if (least == -1)
+                  least = i;
+                most = i;
+              }
+            if (!f.isFixedToZero(i))
+              {
+                possibleOne = i;
+                if (firstPossibleOne == -1)
+                  firstPossibleOne = i;
+              }
+            if (f.isFixedToOne(i))
+              {
+                zero = false;
+                if (firstOne == -1)
+                  firstOne = i;
+              }
+          }
+        ASSERT_EQ(count, f.countFixed());
+        ASSERT_EQ(count == width, f.isTotallyFixed());
+        ASSERT_EQ(least == -1 ? width : (unsigned) least, f.leastUnfixed());
+        ASSERT_EQ(most, f.mostUnfixed());
+        ASSERT_EQ(possibleOne, f.topmostPossibleLeadingOne());
+        ASSERT_EQ(firstPossibleOne == -1 ? width : (unsigned) firstPossibleOne, f.minimum_numberOfTrailingZeroes());
+        ASSERT_EQ(firstOne == -1 ? width : (unsigned) firstOne, f.maximum_numberOfTrailingZeroes());
+        ASSERT_EQ(zero, f.containsZero());
+
+        // Fixing 64 bits at any position.
+        const unsigned from = rng() % (width + 64);
+        const uint64_t mask = rng() & rng(), v = rng();
+        FixedBits expected(f);
+        for (unsigned j = 0; j < 64 && from + j < width; j++)
+          if ((mask >> j) & 1)
+            {
+              expected.setFixed(from + j, true);
+              expected.setValue(from + j, (v >> j) & 1);
+            }
+        f.fixAt(from, mask, v);
+        ASSERT_TRUE(same(expected, f)) << width << " " << from << " " << show(f);
+      }
+}
+
+// makeEqual and fixRangeTo against doing the same a bit at a time.
+TEST(fixed_bits, make_equal)
+{
+  std::mt19937_64 rng(2);
+  for (int round = 0; round < 3000; round++)
+    {
+      const unsigned aWidth = widths[rng() % numberOfWidths];
+      const unsigned bWidth = widths[rng() % numberOfWidths];
+      const unsigned length = rng() % (std::min(aWidth, bWidth) + 1);
+      const unsigned aFrom = rng() % (aWidth - length + 1);
+      const unsigned bFrom = rng() % (bWidth - length + 1);
+
+      // Mostly agreeing, so that there's something to copy.
+      FixedBits a = randomFixedBits(aWidth, rng);
+      FixedBits b = randomFixedBits(bWidth, rng);
+      if (rng() % 4 != 0)
+        for (unsigned i = 0; i < length; i++)
+          if (a.isFixed(aFrom + i) && b.isFixed(bFrom + i))
+            b.setValue(bFrom + i, a.getValue(aFrom + i));
+
+      FixedBits expectedA(a), expectedB(b);
+      Result expected = NO_CHANGE;
+      for (unsigned i = 0; i < length && expected != CONFLICT; i++)
+        {
+          const unsigned x = aFrom + i, y = bFrom + i;
+          if (a.isFixed(x) && b.isFixed(y))
+            {
+              if (a.getValue(x) != b.getValue(y))
+                expected = CONFLICT;
+            }
+          else if (a.isFixed(x))
+            {
+              expectedB.setFixed(y, true);
+              expectedB.setValue(y, a.getValue(x));
+              expected = CHANGED;
+            }
+          else if (b.isFixed(y))
+            {
+              expectedA.setFixed(x, true);
+              expectedA.setValue(x, b.getValue(y));
+              expected = CHANGED;
+            }
+        }
+
+      const Result result = makeEqual(a, aFrom, b, bFrom, length);
+      ASSERT_EQ(expected, result) << aWidth << " " << aFrom << " " << bWidth << " " << bFrom << " " << length;
+      if (result != CONFLICT)
+        {
+          ASSERT_TRUE(same(expectedA, a)) << show(expectedA) << " " << show(a);
+          ASSERT_TRUE(same(expectedB, b)) << show(expectedB) << " " << show(b);
+        }
+
+      // And fixing a range of bits.
+      const unsigned to = aFrom + length;
+      const bool value = rng() % 2;
+      FixedBits c = randomFixedBits(aWidth, rng);
+      if (rng() % 2 == 0)
+        for (unsigned i = aFrom; i < to; i++)
+          if (c.isFixed(i))
+            c.setValue(i, value);
+      FixedBits expectedC(c);
+      expected = NO_CHANGE;
+      for (unsigned i = aFrom; i < to && expected != CONFLICT; i++)
+        if (!c.isFixed(i))
+          {
+            expectedC.setFixed(i, true);
+            expectedC.setValue(i, value);
+            expected = CHANGED;
+          }
+        else if (c.getValue(i) != value)
+          expected = CONFLICT;
+
+      const Result fixResult = fixRangeTo(c, aFrom, to, value);
+      ASSERT_EQ(expected, fixResult);
+      if (fixResult != CONFLICT)
+        ASSERT_TRUE(same(expectedC, c));
+    }
+}
+
+TEST(fixed_bits, min_max)
+{
+  CONSTANTBV::BitVector_Boot();
+  std::mt19937_64 rng(3);
+  for (int w = 0; w < numberOfWidths; w++)
+    for (int round = 0; round < 100; round++)
+      {
+        const unsigned width = widths[w];
+        FixedBits f = randomFixedBits(width, rng);
+        const unsigned msb = width - 1;
+
+        CBV min = CONSTANTBV::BitVector_Create(width, true);
+        CBV max = CONSTANTBV::BitVector_Create(width, true);
+
+        setUnsignedMinMax(f, min, max);
+        for (unsigned i = 0; i < width; i++)
+          {
+            ASSERT_EQ(f.isFixedToOne(i), (bool) CONSTANTBV::BitVector_bit_test(min, i)) << width << " " << i;
+            ASSERT_EQ(!f.isFixedToZero(i), (bool) CONSTANTBV::BitVector_bit_test(max, i)) << width << " " << i;
+          }
+
+        // The sign bit, if it's not fixed, is on in the minimum and off
+        // in the maximum.
+        setSignedMinMax(f, min, max);
+        for (unsigned i = 0; i < width; i++)
+          {
+            const bool unfixed = !f.isFixed(i);
+            ASSERT_EQ(f.isFixedToOne(i) || (unfixed && i == msb), (bool) CONSTANTBV::BitVector_bit_test(min, i));
+            ASSERT_EQ(f.isFixedToOne(i) || (unfixed && i != msb), (bool) CONSTANTBV::BitVector_bit_test(max, i));
+          }
+
+        CONSTANTBV::BitVector_Destroy(min);
+        CONSTANTBV::BitVector_Destroy(max);
+      }
+}
+
+static Result
+transfer(Kind k, vector<FixedBits*>& children, FixedBits& output)
+{
+  switch (k)
+    {
+  case BVAND:
+    return bvAndBothWays(children, output);
+  case BVOR:
+    return bvOrBothWays(children, output);
+  case BVXOR:
+    return bvXorBothWays(children, output);
+  case BVNEG:
+    return bvNotBothWays(children, output);
+  case EQ:
+    return bvEqualsBothWays(children, output);
+  case ITE:
+    return bvITEBothWays(children, output);
+  case BVZX:
+    return bvZeroExtendBothWays(children, output);
+  case BVSX:
+    return bvSignExtendBothWays(children, output);
+  case BVEXTRACT:
+    return bvExtractBothWays(children, output);
+  case BVCONCAT:
+    return bvConcatBothWays(children, output);
+  case BVLEFTSHIFT:
+    return bvLeftShiftBothWays(children, output);
+  case BVRIGHTSHIFT:
+    return bvRightShiftBothWays(children, output);
+  case BVSRSHIFT:
+    return bvArithmeticRightShiftBothWays(children, output);
+  case BVPLUS:
+    return bvAddBothWays(children, output);
+  case BVSUB:
+    return bvSubtractBothWays(children, output);
+  case BVUMINUS:
+    return bvUnaryMinusBothWays(children, output);
+  case BVLT:
+    return bvLessThanBothWays(children, output);
+  case BVLE:
+    return bvLessThanEqualsBothWays(children, output);
+  case BVGT:
+    return bvGreaterThanBothWays(children, output);
+  case BVGE:
+    return bvGreaterThanEqualsBothWays(children, output);
+  case BVSLT:
+    return bvSignedLessThanBothWays(children, output);
+  case BVSLE:
+    return bvSignedLessThanEqualsBothWays(children, output);
+  case BVSGT:
+    return bvSignedGreaterThanBothWays(children, output);
+  case BVSGE:
+    return bvSignedGreaterThanEqualsBothWays(children, output);
+  default:
+    ADD_FAILURE() << "No transfer function for " << k;
+    return CONFLICT;
+    }
+}
+
+// A node with concrete children. The children from "indices" on are
+// the constant arguments of extract and the extensions, which are
+// always totally fixed.
+struct Application
+{
+  Kind k;
+  std::vector<Bits> children;
+  std::vector<bool> booleanChild;
+  size_t indices;
+  bool booleanOutput;
+  Bits output;
+};
+
+static Application
+application(STPMgr& bm, Kind k, unsigned width, std::mt19937_64& rng)
+{
+  Application a;
+  a.k = k;
+  a.booleanOutput = false;
+  unsigned outputWidth = width;
+
+  switch (k)
+    {
+  case BVNEG:
+  case BVUMINUS:
+    a.children.push_back(randomBits(rng, width));
+    break;
+  case ITE:
+    a.children.push_back(Bits(1, rng() % 2));
+    a.children.push_back(randomBits(rng, width));
+    a.children.push_back(randomBits(rng, width));
+    break;
+  case BVZX:
+  case BVSX:
+    {
+      // From a narrower width, across a word boundary if there is one.
+      const unsigned from = 1 + rng() % width;
+      a.children.push_back(randomBits(rng, from));
+      a.children.push_back(fromUnsigned(32, width));
+      break;
+    }
+  case BVEXTRACT:
+    {
+      const unsigned low = rng() % width;
+      const unsigned high = low + rng() % (width - low);
+      a.children.push_back(randomBits(rng, width));
+      a.children.push_back(fromUnsigned(32, high));
+      a.children.push_back(fromUnsigned(32, low));
+      outputWidth = high - low + 1;
+      break;
+    }
+  case BVCONCAT:
+    {
+      // Needs a width of two or more.
+      const unsigned split = 1 + rng() % (width - 1);
+      a.children.push_back(randomBits(rng, width - split));
+      a.children.push_back(randomBits(rng, split));
+      break;
+    }
+  case BVLEFTSHIFT:
+  case BVRIGHTSHIFT:
+  case BVSRSHIFT:
+    {
+      // By less than the width, the width, or more.
+      a.children.push_back(randomBits(rng, width));
+      const unsigned r = rng() % 4;
+      a.children.push_back(r == 0 ? randomBits(rng, width) : fromUnsigned(width, r == 1 ? width : rng() % width));
+      break;
+    }
+  default:
+    a.children.push_back(randomBits(rng, width));
+    a.children.push_back(randomBits(rng, width));
+    // Often equal above a word, so comparisons look further down.
+    if (rng() % 2 == 0)
+      for (unsigned i = rng() % width; i < width; i++)
+        a.children[1][i] = a.children[0][i];
+    a.booleanOutput = (k == EQ || is_Form_kind(k));
+    }
+
+  a.booleanChild.assign(a.children.size(), false);
+  if (k == ITE)
+    a.booleanChild[0] = true;
+  a.indices = (k == BVZX || k == BVSX || k == BVEXTRACT) ? 1 : a.children.size();
+
+  ASTVec nodes;
+  for (size_t i = 0; i < a.children.size(); i++)
+    nodes.push_back(toNode(bm, a.children[i], a.booleanChild[i]));
+  if (k == BVCONCAT)
+    outputWidth = a.children[0].size() + a.children[1].size();
+  a.output = fromNode(NonMemberBVConstEvaluator(&bm, k, nodes, a.booleanOutput ? 0 : outputWidth));
+  return a;
+}
+
+// Runs the transfer function with the children and output fixed with a
+// chance of childQuarters / 4 and outputQuarters / 4, and returns
+// what it gives, with the fixings after.
+static Result
+run(const Application& a, unsigned childQuarters, unsigned outputQuarters, std::mt19937_64& rng,
+    std::vector<FixedBits>& children, FixedBits& output)
+{
+  children.clear();
+  for (size_t i = 0; i < a.children.size(); i++)
+    children.push_back(abstraction(a.children[i], a.booleanChild[i], rng, i < a.indices ? childQuarters : 4));
+  output = abstraction(a.output, a.booleanOutput, rng, outputQuarters);
+
+  vector<FixedBits*> pointers;
+  for (size_t i = 0; i < children.size(); i++)
+    pointers.push_back(&children[i]);
+  return transfer(a.k, pointers, output);
+}
+
+static std::string
+describe(const Application& a, const std::vector<FixedBits>& children, const FixedBits& output)
+{
+  std::ostringstream result;
+  result << a.k << " of width " << a.children[0].size() << ":";
+  for (size_t i = 0; i < children.size(); i++)
+    result << " " << show(children[i]);
+  result << " -> " << show(output);
+  return result.str();
+}
+
+TEST(fixed_bits, transfer_functions)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  bm.UserFlags.division_by_zero_returns_one_flag = true;
+  std::mt19937_64 rng(4);
+
+  const Kind kinds[] = {BVAND, BVOR, BVXOR, BVNEG, EQ, ITE, BVZX, BVSX, BVEXTRACT, BVCONCAT, BVLEFTSHIFT,
+      BVRIGHTSHIFT, BVSRSHIFT, BVPLUS, BVSUB, BVUMINUS, BVLT, BVLE, BVGT, BVGE, BVSLT, BVSLE, BVSGT, BVSGE};
+
+  for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++)
+    for (int w = 0; w < numberOfWidths; w++)
+      for (int round = 0; round < 20; round++)
+        {
+          if (kinds[k] == BVCONCAT && widths[w] == 1)
+            continue;
+          const Application a = application(bm, kinds[k], widths[w], rng);
+          std::vector<FixedBits> children;
+          FixedBits output(1, false);
+
+          // Nothing fixed that isn't so is: never a conflict.
+          for (unsigned q = 0; q < 5; q++)
+            {
+              ASSERT_NE(CONFLICT, run(a, q, rng() % 5, rng, children, output)) << describe(a, children, output);
+              for (size_t i = 0; i < children.size(); i++)
+                ASSERT_TRUE(agrees(children[i], a.children[i])) << describe(a, children, output);
+              ASSERT_TRUE(agrees(output, a.output)) << describe(a, children, output);
+            }
+
+          // The children fixed gives the output.
+          ASSERT_NE(CONFLICT, run(a, 4, 0, rng, children, output));
+          ASSERT_TRUE(output.isTotallyFixed()) << describe(a, children, output);
+          ASSERT_TRUE(agrees(output, a.output)) << describe(a, children, output);
+
+          // And any other output is a conflict.
+          run(a, 4, 4, rng, children, output);
+          const unsigned flip = rng() % output.getWidth();
+          output.setValue(flip, !output.getValue(flip));
+          vector<FixedBits*> pointers;
+          for (size_t i = 0; i < children.size(); i++)
+            pointers.push_back(&children[i]);
+          ASSERT_EQ(CONFLICT, transfer(a.k, pointers, output)) << describe(a, children, output);
+        }
+}
+
+// Some transfer functions fix everything that can be, given the bits
+// that are fixed in particular places.
+TEST(fixed_bits, precise)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  std::mt19937_64 rng(6);
+
+  for (int w = 0; w < numberOfWidths; w++)
+    for (int round = 0; round < 30; round++)
+      {
+        const unsigned width = widths[w];
+        std::vector<FixedBits> children;
+        FixedBits output(1, false);
+
+        // Extract, concatenation and the extensions copy the fixed bits
+        // both ways.
+        Application a = application(bm, BVEXTRACT, width, rng);
+        ASSERT_NE(CONFLICT, run(a, rng() % 5, rng() % 5, rng, children, output));
+        {
+          unsigned bottom = 0;
+          for (unsigned i = 0; i < 32; i++)
+            if (a.children[2][i])
+              bottom |= 1u << i;
+          for (unsigned i = 0; i < output.getWidth(); i++)
+            ASSERT_EQ(children[0][bottom + i], output[i]) << describe(a, children, output);
+        }
+
+        if (width > 1)
+          {
+            a = application(bm, BVCONCAT, width, rng);
+            ASSERT_NE(CONFLICT, run(a, rng() % 5, rng() % 5, rng, children, output));
+            const unsigned lowWidth = children[1].getWidth();
+            for (unsigned i = 0; i < output.getWidth(); i++)
+              ASSERT_EQ(i < lowWidth ? children[1][i] : children[0][i - lowWidth], output[i])
+                  << describe(a, children, output);
+          }
+
+        a = application(bm, BVZX, width, rng);
+        ASSERT_NE(CONFLICT, run(a, rng() % 5, rng() % 5, rng, children, output));
+        for (unsigned i = 0; i < output.getWidth(); i++)
+          ASSERT_EQ(i < children[0].getWidth() ? children[0][i] : '0', output[i]) << describe(a, children, output);
+
+        // The sign extended bits are all fixed if any of them are.
+        a = application(bm, BVSX, width, rng);
+        ASSERT_NE(CONFLICT, run(a, rng() % 5, rng() % 5, rng, children, output));
+        for (unsigned i = 0; i < output.getWidth(); i++)
+          {
+            const unsigned from = std::min(i, children[0].getWidth() - 1);
+            ASSERT_EQ(children[0][from], output[i]) << describe(a, children, output);
+          }
+
+        // Shifting by a fixed amount moves the fixed bits, and fixes
+        // those shifted in.
+        const Kind shifts[] = {BVLEFTSHIFT, BVRIGHTSHIFT, BVSRSHIFT};
+        for (int s = 0; s < 3; s++)
+          {
+            a = application(bm, shifts[s], width, rng);
+            children.clear();
+            children.push_back(abstraction(a.children[0], false, rng, rng() % 5));
+            children.push_back(abstraction(a.children[1], false, rng, 4));
+            output = FixedBits(width, false);
+            vector<FixedBits*> pointers;
+            pointers.push_back(&children[0]);
+            pointers.push_back(&children[1]);
+            ASSERT_NE(CONFLICT, transfer(shifts[s], pointers, output));
+
+            // By the width or more, everything is shifted out.
+            unsigned amount = 0;
+            for (unsigned i = width; i-- > 0;)
+              if (a.children[1][i])
+                {
+                  if (i >= 32)
+                    {
+                      amount = width;
+                      break;
+                    }
+                  amount |= 1u << i;
+                }
+            amount = std::min(amount, width);
+
+            for (unsigned i = 0; i < width; i++)
+              {
+                char expected;
+                if (shifts[s] == BVLEFTSHIFT)
+                  expected = (i < amount) ? '0' : children[0][i - amount];
+                else if (i + amount < width)
+                  expected = children[0][i + amount];
+                else
+                  expected = (shifts[s] == BVRIGHTSHIFT) ? '0' : children[0][width - 1];
+                ASSERT_EQ(expected, output[i]) << describe(a, children, output);
+              }
+          }
+
+        // Adding, the output is fixed as far up as both operands are,
+        // and with the output and one operand fixed, so is the other.
+        a = application(bm, BVPLUS, width, rng);
+        const unsigned known = rng() % (width + 1);
+        children.clear();
+        for (int c = 0; c < 2; c++)
+          {
+            children.push_back(abstraction(a.children[c], false, rng, rng() % 5));
+            for (unsigned i = 0; i < known; i++)
+              {
+                children[c].setFixed(i, true);
+                children[c].setValue(i, a.children[c][i]);
+              }
+          }
+        output = FixedBits(width, false);
+        {
+          vector<FixedBits*> pointers;
+          pointers.push_back(&children[0]);
+          pointers.push_back(&children[1]);
+          ASSERT_NE(CONFLICT, transfer(BVPLUS, pointers, output));
+          for (unsigned i = 0; i < known; i++)
+            ASSERT_TRUE(output.isFixed(i)) << known << " " << describe(a, children, output);
+          ASSERT_TRUE(agrees(output, a.output));
+        }
+
+        ASSERT_NE(CONFLICT, run(a, 0, 4, rng, children, output));
+        children[1] = abstraction(a.children[1], false, rng, 4);
+        {
+          vector<FixedBits*> pointers;
+          pointers.push_back(&children[0]);
+          pointers.push_back(&children[1]);
+          ASSERT_NE(CONFLICT, transfer(BVPLUS, pointers, output));
+          ASSERT_TRUE(children[0].isTotallyFixed()) << describe(a, children, output);
+          ASSERT_TRUE(agrees(children[0], a.children[0]));
+        }
+      }
+}
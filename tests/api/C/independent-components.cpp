@@ -0,0 +1,157 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Queries whose asserts split into groups that share no variables, so
+// that each group is solved separately.
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include "stp/c_interface.h"
+
+// Asserts that x * y = product, with x and y between 2 and 2^16.
+static void factorGroup(VC vc, int id, unsigned product, std::vector<Expr>& xs, std::vector<Expr>& ys)
+{
+  char name[32];
+  Type bv32 = vc_bvType(vc, 32);
+  sprintf(name, "x%d", id);
+  Expr x = vc_varExpr(vc, name, bv32);
+  sprintf(name, "y%d", id);
+  Expr y = vc_varExpr(vc, name, bv32);
+  Expr one = vc_bvConstExprFromInt(vc, 32, 1);
+  Expr limit = vc_bvConstExprFromInt(vc, 32, 1 << 16);
+
+  vc_assertFormula(vc, vc_bvGtExpr(vc, x, one));
+  vc_assertFormula(vc, vc_bvGtExpr(vc, y, one));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, x, limit));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, y, limit));
+  Expr p = vc_bvConstExprFromInt(vc, 32, product);
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 32, x, y), p));
+  xs.push_back(x);
+  ys.push_back(y);
+}
+
+// Asserts that x * y = p * q, for primes p and q near 2^30, which
+// takes the solver far longer than any test runs.
+static void hardGroup(VC vc)
+{
+  Type bv64 = vc_bvType(vc, 64);
+  Expr x = vc_varExpr(vc, "hx", bv64);
+  Expr y = vc_varExpr(vc, "hy", bv64);
+  Expr one = vc_bvConstExprFromLL(vc, 64, 1);
+  Expr limit = vc_bvConstExprFromLL(vc, 64, 1ULL << 32);
+
+  vc_assertFormula(vc, vc_bvGtExpr(vc, x, one));
+  vc_assertFormula(vc, vc_bvGtExpr(vc, y, one));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, x, limit));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, y, limit));
+  Expr p = vc_bvConstExprFromLL(vc, 64, 1073741789ULL * 1073741827ULL);
+  vc_assertFormula(vc, vc_eqExpr(vc, vc_bvMultExpr(vc, 64, x, y), p));
+}
+
+static void checkModels(int threads)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, COMPONENT_THREADS, threads);
+
+  const int n = 6;
+  std::vector<Expr> xs, ys;
+  for (int i = 0; i < n; i++)
+    factorGroup(vc, i, (unsigned)(251 + 6 * i) * 241, xs, ys);
+
+  // Satisfiable, so there's a counterexample.
+  ASSERT_EQ(0, vc_query(vc, vc_falseExpr(vc)));
+
+  // Each group's values come from a different solver.
+  for (int i = 0; i < n; i++)
+    {
+      Expr xv = vc_getCounterExample(vc, xs[i]);
+      Expr yv = vc_getCounterExample(vc, ys[i]);
+      ASSERT_EQ((251 + 6 * i) * 241, getBVUnsigned(xv) * getBVUnsigned(yv)) << "group " << i;
+      vc_DeleteExpr(xv);
+      vc_DeleteExpr(yv);
+    }
+  vc_Destroy(vc);
+}
+
+TEST(independent_components, models_merged)
+{
+  checkModels(1);
+}
+
+TEST(independent_components, models_merged_threads)
+{
+  checkModels(4);
+}
+
+// One group can't be satisfied, as 65521 is prime.
+TEST(independent_components, one_unsatisfiable)
+{
+  for (int threads = 1; threads <= 4; threads += 3)
+    {
+      VC vc = vc_createValidityChecker();
+      vc_setInterfaceFlags(vc, COMPONENT_THREADS, threads);
+
+      std::vector<Expr> xs, ys;
+      for (int i = 0; i < 4; i++)
+        factorGroup(vc, i, (unsigned)(251 + 6 * i) * 241, xs, ys);
+      factorGroup(vc, 4, 65521, xs, ys);
+
+      ASSERT_EQ(1, vc_query(vc, vc_falseExpr(vc))) << threads << " threads";
+      vc_Destroy(vc);
+    }
+}
+
+// The time the calling thread spends waiting for the others counts.
+TEST(independent_components, timeout_threads)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, COMPONENT_THREADS, 2);
+
+  std::vector<Expr> xs, ys;
+  factorGroup(vc, 0, 251 * 241, xs, ys);
+  hardGroup(vc);
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  ASSERT_EQ(3, vc_query_with_timeout(vc, vc_falseExpr(vc), 500));
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(30));
+  vc_Destroy(vc);
+}
+
+// Once a group is found to be unsatisfiable, the others are stopped.
+TEST(independent_components, unsatisfiable_stops_others)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, COMPONENT_THREADS, 2);
+
+  std::vector<Expr> xs, ys;
+  hardGroup(vc);
+  factorGroup(vc, 0, 65521, xs, ys);
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  ASSERT_EQ(1, vc_query_with_timeout(vc, vc_falseExpr(vc), 60000));
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(30));
+  vc_Destroy(vc);
+}
@@ -0,0 +1,101 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Bounds that the interval analysis reads off the assertions.
+
+#include <gtest/gtest.h>
+#include "stp/c_interface.h"
+
+// Bounds that say the same thing mustn't simplify each other away.
+TEST(intervals, repeated_bounds_kept)
+{
+  VC vc = vc_createValidityChecker();
+  Type bv32 = vc_bvType(vc, 32);
+  Expr x = vc_varExpr(vc, "x", bv32);
+  vc_assertFormula(vc, vc_bvLtExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 10)));
+  vc_assertFormula(vc, vc_bvLeExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 9)));
+  vc_assertFormula(vc, vc_bvGeExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 5)));
+
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_bvLtExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 9))));
+  Expr xv = vc_getCounterExample(vc, x);
+  ASSERT_EQ(9u, getBVUnsigned(xv));
+  vc_DeleteExpr(xv);
+  vc_pop(vc);
+
+  vc_push(vc);
+  ASSERT_EQ(1, vc_query(vc, vc_bvGtExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 4))));
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+}
+
+// Signed bounds go through sums and products.
+TEST(intervals, signed_arithmetic)
+{
+  VC vc = vc_createValidityChecker();
+  Type bv32 = vc_bvType(vc, 32);
+  Expr x = vc_varExpr(vc, "x", bv32);
+  Expr y = vc_varExpr(vc, "y", bv32);
+  vc_assertFormula(vc, vc_sbvGtExpr(vc, x, vc_bvConstExprFromInt(vc, 32, -20)));
+  vc_assertFormula(vc, vc_sbvLeExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 3)));
+  vc_assertFormula(vc, vc_sbvGeExpr(vc, y, vc_bvConstExprFromInt(vc, 32, -2)));
+  vc_assertFormula(vc, vc_sbvLtExpr(vc, y, vc_bvConstExprFromInt(vc, 32, 7)));
+
+  // -19 * -2 = 38 is the largest product, and -19 * 6 = -114 the smallest.
+  Expr product = vc_bvMultExpr(vc, 32, x, y);
+  vc_push(vc);
+  ASSERT_EQ(1, vc_query(vc, vc_andExpr(vc, vc_sbvLeExpr(vc, product, vc_bvConstExprFromInt(vc, 32, 38)),
+                                           vc_sbvGeExpr(vc, product, vc_bvConstExprFromInt(vc, 32, -114)))));
+  vc_pop(vc);
+
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_sbvGtExpr(vc, product, vc_bvConstExprFromInt(vc, 32, -114))));
+  Expr xv = vc_getCounterExample(vc, x);
+  Expr yv = vc_getCounterExample(vc, y);
+  ASSERT_EQ(-19, getBVInt(xv));
+  ASSERT_EQ(6, getBVInt(yv));
+  vc_DeleteExpr(xv);
+  vc_DeleteExpr(yv);
+  vc_pop(vc);
+
+  vc_push(vc);
+  Expr sum = vc_bvPlusExpr(vc, 32, x, y);
+  ASSERT_EQ(1, vc_query(vc, vc_sbvLtExpr(vc, sum, vc_bvConstExprFromInt(vc, 32, 10))));
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+}
+
+// Bounds that contradict each other.
+TEST(intervals, empty_bounds)
+{
+  VC vc = vc_createValidityChecker();
+  Type bv8 = vc_bvType(vc, 8);
+  Expr x = vc_varExpr(vc, "x", bv8);
+  vc_assertFormula(vc, vc_sbvLtExpr(vc, x, vc_bvConstExprFromInt(vc, 8, 0)));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, x, vc_bvConstExprFromInt(vc, 8, 100)));
+  ASSERT_EQ(1, vc_query(vc, vc_falseExpr(vc)));
+  vc_Destroy(vc);
+}
@@ -0,0 +1,114 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Wide operations on narrow values, which are done at a smaller width.
+
+#include <gtest/gtest.h>
+#include "stp/c_interface.h"
+
+// The 64-bit product of two zero extended 16-bit variables.
+TEST(narrow_widths, zero_extended_product)
+{
+  VC vc = vc_createValidityChecker();
+  Expr a = vc_varExpr(vc, "a", vc_bvType(vc, 16));
+  Expr b = vc_varExpr(vc, "b", vc_bvType(vc, 16));
+  Expr zero = vc_bvConstExprFromInt(vc, 48, 0);
+  Expr product = vc_bvMultExpr(vc, 64, vc_bvConcatExpr(vc, zero, a), vc_bvConcatExpr(vc, zero, b));
+
+  // 65535 * 65535 is the largest product there is.
+  vc_push(vc);
+  Expr largest = vc_bvConstExprFromLL(vc, 64, 65535ull * 65535ull);
+  ASSERT_EQ(1, vc_query(vc, vc_bvLeExpr(vc, product, largest)));
+  vc_pop(vc);
+
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_notExpr(vc, vc_eqExpr(vc, product, largest))));
+  Expr av = vc_getCounterExample(vc, a);
+  ASSERT_EQ(65535u, getBVUnsigned(av));
+  vc_DeleteExpr(av);
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+}
+
+// The same for sign extended variables.
+TEST(narrow_widths, sign_extended_product)
+{
+  VC vc = vc_createValidityChecker();
+  Expr a = vc_varExpr(vc, "a", vc_bvType(vc, 8));
+  Expr b = vc_varExpr(vc, "b", vc_bvType(vc, 8));
+  Expr product = vc_bvMultExpr(vc, 32, vc_bvSignExtend(vc, a, 32), vc_bvSignExtend(vc, b, 32));
+
+  // -128 * -128 = 16384, and -128 * 127 = -16256.
+  vc_push(vc);
+  Expr most = vc_bvConstExprFromInt(vc, 32, 16384);
+  Expr least = vc_bvUMinusExpr(vc, vc_bvConstExprFromInt(vc, 32, 16256));
+  ASSERT_EQ(1, vc_query(vc, vc_andExpr(vc, vc_sbvLeExpr(vc, product, most), vc_sbvGeExpr(vc, product, least))));
+  vc_pop(vc);
+
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_notExpr(vc, vc_eqExpr(vc, product, least))));
+  Expr av = vc_getCounterExample(vc, a);
+  Expr bv = vc_getCounterExample(vc, b);
+  const unsigned ua = getBVUnsigned(av), ub = getBVUnsigned(bv);
+  ASSERT_TRUE((ua == 0x80 && ub == 0x7f) || (ua == 0x7f && ub == 0x80));
+  vc_DeleteExpr(av);
+  vc_DeleteExpr(bv);
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+}
+
+// Values that are asserted to be small are compared and divided at a
+// smaller width, and the bounds stay in the formula.
+TEST(narrow_widths, asserted_bounds)
+{
+  VC vc = vc_createValidityChecker();
+  make_division_total(vc);
+  Type bv32 = vc_bvType(vc, 32);
+  Expr x = vc_varExpr(vc, "x", bv32);
+  Expr y = vc_varExpr(vc, "y", bv32);
+  vc_assertFormula(vc, vc_bvLeExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 255)));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, y, vc_bvConstExprFromInt(vc, 32, 16)));
+
+  vc_push(vc);
+  Expr q = vc_bvDivExpr(vc, 32, x, y);
+  ASSERT_EQ(0, vc_query(vc, vc_bvLtExpr(vc, q, vc_bvConstExprFromInt(vc, 32, 255))));
+  Expr xv = vc_getCounterExample(vc, x);
+  Expr yv = vc_getCounterExample(vc, y);
+  ASSERT_EQ(255u, getBVUnsigned(xv));
+  ASSERT_EQ(1u, getBVUnsigned(yv));
+  vc_DeleteExpr(xv);
+  vc_DeleteExpr(yv);
+  vc_pop(vc);
+
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_bvLtExpr(vc, x, vc_bvConstExprFromInt(vc, 32, 255))));
+  xv = vc_getCounterExample(vc, x);
+  ASSERT_EQ(255u, getBVUnsigned(xv));
+  vc_DeleteExpr(xv);
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+}
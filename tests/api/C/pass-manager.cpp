@@ -0,0 +1,119 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+// Checks the PassManager's pipelines and when it skips passes.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "stp/STPManager/STPManager.h"
+#include "stp/STPManager/PassManager.h"
+
+using namespace BEEV;
+
+// Notes its name each time it's run, and leaves the formula alone.
+static PassManager::Pass
+noting(std::vector<std::string>& log, const std::string& name)
+{
+  return [&log, name](const ASTNode& n) { log.push_back(name); return n; };
+}
+
+// A formula that's new to every pass.
+static ASTNode
+fresh(STPMgr& bm, int i)
+{
+  const std::string name = "p" + std::to_string(i);
+  return bm.CreateSymbol(name.c_str(), 0, 0);
+}
+
+TEST(pass_manager, pipeline)
+{
+  STPMgr bm;
+  PassManager pm(&bm);
+  std::vector<std::string> log;
+  pm.add("a", noting(log, "a"));
+  pm.add("b", noting(log, "b"));
+  pm.add("c", noting(log, "c"), [] { return false; });
+
+  pm.runOnce(fresh(bm, 0));
+  ASSERT_EQ(std::vector<std::string>({"a", "b"}), log);
+
+  log.clear();
+  pm.setPipeline("b,a,b");
+  pm.runOnce(fresh(bm, 1));
+  ASSERT_EQ(std::vector<std::string>({"b", "a"}), log);
+
+  log.clear();
+  pm.setPipeline("c,b");
+  pm.runOnce(fresh(bm, 2));
+  ASSERT_EQ(std::vector<std::string>({"b"}), log);
+
+  log.clear();
+  pm.setPipeline("");
+  pm.runOnce(fresh(bm, 3));
+  ASSERT_EQ(std::vector<std::string>({"a", "b"}), log);
+}
+
+TEST(pass_manager, unknown_pass)
+{
+  STPMgr bm;
+  PassManager pm(&bm);
+  std::vector<std::string> log;
+  pm.add("a", noting(log, "a"));
+  EXPECT_DEATH(pm.setPipeline("a,nope"), "unknown pass in pipeline: nope");
+}
+
+// The "grow" pass makes the formula harder for its first five runs.
+static unsigned
+runsOfGrow(double minimumYield, bool stats)
+{
+  STPMgr bm;
+  bm.UserFlags.stats_flag = stats;
+  unsigned runs = 0;
+  {
+    PassManager pm(&bm);
+    const ASTNode x = bm.CreateSymbol("x", 0, 8);
+    pm.add("grow", [&](const ASTNode& n) {
+      if (++runs > 5)
+        return n;
+      const ASTNode product = bm.CreateTerm(BVMULT, 8, x, bm.CreateBVConst(8, runs));
+      return bm.CreateNode(AND, n, bm.CreateNode(EQ, product, x));
+    });
+    pm.setMinimumYield(minimumYield);
+    pm.runToFixedPoint(bm.CreateNode(EQ, x, bm.CreateBVConst(8, 0)));
+  }
+  return runs;
+}
+
+TEST(pass_manager, skipping)
+{
+  // Runs until it stops changing the formula.
+  ASSERT_EQ(6u, runsOfGrow(0, false));
+
+  // The statistics don't change what's run.
+  ASSERT_EQ(6u, runsOfGrow(0, true));
+
+  // Skipped once its last two runs made things worse.
+  ASSERT_EQ(2u, runsOfGrow(0.1, false));
+  ASSERT_EQ(2u, runsOfGrow(0.1, true));
+}
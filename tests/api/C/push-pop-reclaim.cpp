@@ -0,0 +1,132 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+
+// Many push/pop rounds, with what each round makes let go of at the pop.
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include "stp/c_interface.h"
+
+TEST(push_pop_reclaim, rounds)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, EXPRDELETE_ON_POP, 1);
+
+  Type bv16 = vc_bvType(vc, 16);
+  Expr x = vc_varExpr(vc, "x", bv16);
+  vc_assertFormula(vc, vc_bvLtExpr(vc, x, vc_bvConstExprFromInt(vc, 16, 1000)));
+
+  for (int r = 0; r < 200; r++)
+    {
+      vc_push(vc);
+
+      char name[32];
+      sprintf(name, "y_%d", r);
+      Expr y = vc_varExpr(vc, name, bv16);
+      Expr sum = vc_bvPlusExpr(vc, 16, x, y);
+      Expr target = vc_bvConstExprFromInt(vc, 16, 2000 + r);
+      Expr eq = vc_eqExpr(vc, sum, target);
+      Expr yLimit = vc_bvLtExpr(vc, y, vc_bvConstExprFromInt(vc, 16, 1500));
+      Expr xLimit = vc_bvGtExpr(vc, x, vc_bvConstExprFromInt(vc, 16, 500));
+      vc_assertFormula(vc, yLimit);
+      vc_assertFormula(vc, xLimit);
+
+      // Invalid: there are x and y that add up to the target.
+      Expr neq = vc_notExpr(vc, eq);
+      ASSERT_EQ(0, vc_query(vc, neq));
+
+      Expr xv = vc_getCounterExample(vc, x);
+      Expr yv = vc_getCounterExample(vc, y);
+      ASSERT_EQ(2000u + r, (getBVUnsigned(xv) + getBVUnsigned(yv)) & 0xffff);
+      vc_DeleteExpr(xv);
+      vc_DeleteExpr(yv);
+
+      vc_DeleteExpr(xLimit);
+      vc_DeleteExpr(yLimit);
+      vc_DeleteExpr(neq);
+      vc_DeleteExpr(eq);
+      vc_DeleteExpr(sum);
+      vc_DeleteExpr(y);
+      vc_pop(vc);
+
+      // The counterexample survives the pop.
+      xv = vc_getCounterExample(vc, x);
+      ASSERT_LT(getBVUnsigned(xv), 1000u);
+      vc_DeleteExpr(xv);
+
+      // The assertions from the popped round are gone.
+      Expr big = vc_bvGtExpr(vc, x, vc_bvConstExprFromInt(vc, 16, 500));
+      ASSERT_EQ(0, vc_query(vc, big));
+      vc_DeleteExpr(big);
+    }
+
+  // The variables of the popped rounds were dropped from the
+  // declarations, and x wasn't. The last round's variable was held by
+  // its counterexample when it was popped, so is dropped at the next
+  // push.
+  vc_push(vc);
+  vc_pop(vc);
+  testing::internal::CaptureStdout();
+  vc_printVarDecls(vc);
+  std::string decls = testing::internal::GetCapturedStdout();
+  ASSERT_NE(std::string::npos, decls.find("x"));
+  ASSERT_EQ(std::string::npos, decls.find("y_")) << decls;
+
+  vc_DeleteExpr(x);
+  vc_Destroy(vc);
+}
+
+// The context that the first assertion makes, without a push, can be
+// popped too, as can one level more than was pushed after it.
+TEST(push_pop_reclaim, pop_without_push)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, EXPRDELETE_ON_POP, 1);
+
+  Type bv16 = vc_bvType(vc, 16);
+  Expr x = vc_varExpr(vc, "x", bv16);
+  Expr small = vc_bvLtExpr(vc, x, vc_bvConstExprFromInt(vc, 16, 1000));
+
+  // Division introduces symbols while the assertion's context is there.
+  Expr quotient = vc_bvDivExpr(vc, 16, x, vc_bvConstExprFromInt(vc, 16, 3));
+  Expr bounded = vc_bvLtExpr(vc, quotient, vc_bvConstExprFromInt(vc, 16, 334));
+
+  vc_assertFormula(vc, small);
+  ASSERT_EQ(1, vc_query(vc, bounded));
+  vc_pop(vc);
+  ASSERT_EQ(0, vc_query(vc, small));
+
+  vc_assertFormula(vc, small);
+  vc_push(vc);
+  vc_assertFormula(vc, vc_bvGtExpr(vc, x, vc_bvConstExprFromInt(vc, 16, 500)));
+  ASSERT_EQ(1, vc_query(vc, bounded));
+  vc_pop(vc);
+  vc_pop(vc);
+  ASSERT_EQ(0, vc_query(vc, small));
+  ASSERT_EQ(0, vc_query(vc, bounded));
+
+  vc_Destroy(vc);
+}
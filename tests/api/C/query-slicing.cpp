@@ -0,0 +1,149 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Queries that only get the assertions connected to them.
+
+#include <gtest/gtest.h>
+#include "stp/c_interface.h"
+
+// An assertion about x that can't hold: x * x is never 2 (mod 2^8).
+static Expr impossible(VC vc, Expr x)
+{
+  Expr square = vc_bvMultExpr(vc, 8, x, x);
+  return vc_eqExpr(vc, square, vc_bvConstExprFromInt(vc, 8, 2));
+}
+
+TEST(query_slicing, unconnected_assertions_left_out)
+{
+  VC vc = vc_createValidityChecker();
+  Type bv8 = vc_bvType(vc, 8);
+  Expr x = vc_varExpr(vc, "x", bv8);
+  Expr y = vc_varExpr(vc, "y", bv8);
+  Expr q = vc_eqExpr(vc, y, vc_bvConstExprFromInt(vc, 8, 0));
+
+  vc_assertFormula(vc, impossible(vc, x));
+
+  // The assertion has nothing to do with y, so it's left out.
+  vc_setInterfaceFlags(vc, QUERY_SLICING, 1);
+  ASSERT_EQ(0, vc_query(vc, q));
+
+  // Everything is valid when the assertions can't hold.
+  vc_setInterfaceFlags(vc, QUERY_SLICING, 0);
+  vc_push(vc);
+  ASSERT_EQ(1, vc_query(vc, q));
+  vc_pop(vc);
+
+  vc_Destroy(vc);
+}
+
+TEST(query_slicing, connected_through_other_assertions)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, QUERY_SLICING, 1);
+  Type bv8 = vc_bvType(vc, 8);
+  Expr x = vc_varExpr(vc, "x", bv8);
+  Expr y = vc_varExpr(vc, "y", bv8);
+  Expr z = vc_varExpr(vc, "z", bv8);
+  Expr w = vc_varExpr(vc, "w", bv8);
+  Expr one = vc_bvConstExprFromInt(vc, 8, 1);
+
+  vc_assertFormula(vc, vc_eqExpr(vc, x, vc_bvPlusExpr(vc, 8, y, one)));
+  vc_assertFormula(vc, vc_eqExpr(vc, y, vc_bvPlusExpr(vc, 8, z, one)));
+  vc_assertFormula(vc, vc_eqExpr(vc, z, vc_bvConstExprFromInt(vc, 8, 5)));
+  vc_assertFormula(vc, impossible(vc, w));
+
+  // x = 7 follows from the chain through y to z.
+  vc_push(vc);
+  ASSERT_EQ(1, vc_query(vc, vc_eqExpr(vc, x, vc_bvConstExprFromInt(vc, 8, 7))));
+  vc_pop(vc);
+
+  // The counterexample satisfies the assertions that were used.
+  vc_push(vc);
+  ASSERT_EQ(0, vc_query(vc, vc_eqExpr(vc, x, vc_bvConstExprFromInt(vc, 8, 8))));
+  vc_pop(vc);
+  Expr xv = vc_getCounterExample(vc, x);
+  Expr zv = vc_getCounterExample(vc, z);
+  ASSERT_EQ(7u, getBVUnsigned(xv));
+  ASSERT_EQ(5u, getBVUnsigned(zv));
+  vc_DeleteExpr(xv);
+  vc_DeleteExpr(zv);
+
+  vc_Destroy(vc);
+}
+
+TEST(query_slicing, assertions_without_symbols_kept)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, QUERY_SLICING, 1);
+  Expr p = vc_varExpr(vc, "p", vc_boolType(vc));
+
+  vc_push(vc);
+  vc_assertFormula(vc, vc_falseExpr(vc));
+  ASSERT_EQ(1, vc_query(vc, p));
+  vc_pop(vc);
+
+  ASSERT_EQ(0, vc_query(vc, p));
+  vc_Destroy(vc);
+}
+
+TEST(query_slicing, popped_assertions_dropped)
+{
+  VC vc = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc, QUERY_SLICING, 1);
+  Type bv8 = vc_bvType(vc, 8);
+  Expr x = vc_varExpr(vc, "x", bv8);
+  Expr y = vc_varExpr(vc, "y", bv8);
+  Expr five = vc_bvConstExprFromInt(vc, 8, 5);
+  Expr q = vc_eqExpr(vc, x, five);
+
+  vc_assertFormula(vc, vc_eqExpr(vc, x, y));
+  for (int i = 0; i < 3; i++)
+    {
+      vc_push(vc);
+      vc_assertFormula(vc, vc_eqExpr(vc, y, five));
+      ASSERT_EQ(1, vc_query(vc, q));
+      vc_pop(vc);
+
+      vc_push(vc);
+      ASSERT_EQ(0, vc_query(vc, q));
+      vc_pop(vc);
+    }
+
+  // Turned on after the assertions were made.
+  VC other = vc_createValidityChecker();
+  Expr a = vc_varExpr(other, "a", vc_bvType(other, 8));
+  Expr b = vc_varExpr(other, "b", vc_bvType(other, 8));
+  vc_assertFormula(other, vc_eqExpr(other, a, vc_bvConstExprFromInt(other, 8, 3)));
+  vc_assertFormula(other, impossible(other, b));
+  vc_setInterfaceFlags(other, QUERY_SLICING, 1);
+  vc_push(other);
+  ASSERT_EQ(1, vc_query(other, vc_eqExpr(other, a, vc_bvConstExprFromInt(other, 8, 3))));
+  vc_pop(other);
+  vc_push(other);
+  ASSERT_EQ(0, vc_query(other, vc_eqExpr(other, a, vc_bvConstExprFromInt(other, 8, 4))));
+  vc_pop(other);
+  vc_Destroy(other);
+
+  vc_Destroy(vc);
+}
@@ -0,0 +1,150 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+// Checks that applySubstitutionMap, which keeps its results between
+// calls, gives what a fresh replace() does as keys are added.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include "stp/STPManager/STPManager.h"
+#include "stp/Simplifier/simplifier.h"
+#include "stp/Simplifier/SubstitutionMap.h"
+
+using namespace BEEV;
+
+static const unsigned width = 8;
+
+static ASTNode
+term(NodeFactory* nf, STPMgr& bm, std::mt19937& rng, const ASTVec& vars, int depth)
+{
+  if (depth == 0 || rng() % 4 == 0)
+    {
+      if (rng() % 5 == 0)
+        return bm.CreateBVConst(width, rng() % 256);
+      return vars[rng() % vars.size()];
+    }
+
+  const ASTNode a = term(nf, bm, rng, vars, depth - 1);
+  const ASTNode b = term(nf, bm, rng, vars, depth - 1);
+  switch (rng() % 6)
+    {
+  case 0:
+    return nf->CreateTerm(BVPLUS, width, a, b);
+  case 1:
+    return nf->CreateTerm(BVAND, width, a, b);
+  case 2:
+    return nf->CreateTerm(BVXOR, width, a, b);
+  case 3:
+    return nf->CreateTerm(BVMULT, width, a, b);
+  case 4:
+    return nf->CreateTerm(BVCONCAT, width, nf->CreateTerm(BVEXTRACT, 4, a, bm.CreateBVConst(32, 3),
+        bm.CreateBVConst(32, 0)), nf->CreateTerm(BVEXTRACT, 4, b, bm.CreateBVConst(32, 7), bm.CreateBVConst(32, 4)));
+  default:
+    return nf->CreateTerm(ITE, width, nf->CreateNode(BVLT, a, b), a, b);
+    }
+}
+
+// The bit-vector terms in n, other than the symbols and constants.
+static void
+subterms(const ASTNode& n, ASTNodeSet& seen, ASTVec& out)
+{
+  if (!seen.insert(n).second)
+    return;
+  for (size_t i = 0; i < n.Degree(); i++)
+    subterms(n[i], seen, out);
+  if (BITVECTOR_TYPE == n.GetType() && SYMBOL != n.GetKind() && BVCONST != n.GetKind())
+    out.push_back(n);
+}
+
+static void
+addOneAtATime(unsigned seed)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  Simplifier simp(&bm);
+  NodeFactory* nf = bm.defaultNodeFactory;
+  std::mt19937 rng(seed);
+
+  ASTVec vars;
+  for (int i = 0; i < 16; i++)
+    vars.push_back(bm.CreateSymbol(("v" + std::to_string(i)).c_str(), 0, width));
+
+  ASTVec conjuncts;
+  for (int i = 0; i < 40; i++)
+    conjuncts.push_back(nf->CreateNode((i % 2) ? EQ : BVLE, term(nf, bm, rng, vars, 4), term(nf, bm, rng, vars, 4)));
+  const ASTNode f = nf->CreateNode(AND, conjuncts);
+
+  ASTNodeSet seen;
+  ASTVec terms;
+  subterms(f, seen, terms);
+  ASSERT_FALSE(terms.empty());
+
+  int added = 0;
+  for (int step = 0; step < 80; step++)
+    {
+      const ASTNode v = vars[rng() % vars.size()];
+      bool fresh;
+      switch (rng() % 4)
+        {
+      case 0: // A symbol for a term.
+        {
+          const ASTNode t = term(nf, bm, rng, vars, 2);
+          fresh = (t != v) && simp.UpdateSubstitutionMap(v, t);
+        }
+        break;
+      case 1: // Two symbols made equal.
+        {
+          const ASTNode w = vars[rng() % vars.size()];
+          fresh = (w != v) && simp.UpdateSubstitutionMap(v, w);
+        }
+        break;
+      case 2: // A term that isn't a symbol for a constant.
+        {
+          const ASTNode t = terms[rng() % terms.size()];
+          fresh = simp.UpdateSolverMap(t, bm.CreateBVConst(t.GetValueWidth(), rng() % 16));
+        }
+        break;
+      default: // Some bits of a symbol.
+        fresh = simp.UpdateSolverMap(nf->CreateTerm(BVEXTRACT, 4, v, bm.CreateBVConst(32, 7), bm.CreateBVConst(32, 4)),
+            bm.CreateBVConst(4, rng() % 16));
+        }
+      added += fresh;
+
+      const ASTNode applied = simp.applySubstitutionMap(f);
+
+      ASTNodeMap fromTo(*simp.Return_SolverMap());
+      ASTNodeMap cache;
+      const ASTNode expected = SubstitutionMap::replace(f, fromTo, cache, nf);
+      ASSERT_TRUE(expected == applied) << "seed " << seed << ", step " << step;
+    }
+
+  // Otherwise the test isn't testing much.
+  ASSERT_LT(20, added);
+}
+
+TEST(substitution_map, added_one_at_a_time)
+{
+  for (unsigned seed = 1; seed <= 20; seed++)
+    addOneAtATime(seed);
+}
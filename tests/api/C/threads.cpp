@@ -0,0 +1,149 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+
+// Runs a separate validity checker on each of several threads at once.
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "stp/c_interface.h"
+
+// Factors "product" (which has factors below 2^16) into two numbers
+// bigger than one, then checks that the counterexample really is a
+// factorisation. Returns the number of checks that failed.
+static int factor(VC vc, unsigned product)
+{
+  int failures = 0;
+  Type bv32 = vc_bvType(vc, 32);
+  Expr x = vc_varExpr(vc, "x", bv32);
+  Expr y = vc_varExpr(vc, "y", bv32);
+  Expr one = vc_bvConstExprFromInt(vc, 32, 1);
+  Expr limit = vc_bvConstExprFromInt(vc, 32, 1 << 16);
+
+  vc_push(vc);
+  vc_assertFormula(vc, vc_bvGtExpr(vc, x, one));
+  vc_assertFormula(vc, vc_bvGtExpr(vc, y, one));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, x, limit));
+  vc_assertFormula(vc, vc_bvLtExpr(vc, y, limit));
+  Expr p = vc_bvConstExprFromInt(vc, 32, product);
+  Expr eq = vc_eqExpr(vc, vc_bvMultExpr(vc, 32, x, y), p);
+
+  // Invalid, because there is a factorisation.
+  if (vc_query(vc, vc_notExpr(vc, eq)) != 0)
+    failures++;
+  else
+    {
+      Expr xv = vc_getCounterExample(vc, x);
+      Expr yv = vc_getCounterExample(vc, y);
+      if (getBVUnsigned(xv) * getBVUnsigned(yv) != product)
+        failures++;
+      vc_DeleteExpr(xv);
+      vc_DeleteExpr(yv);
+    }
+  vc_pop(vc);
+
+  // x + 0 = x is valid.
+  Expr zero = vc_bvConstExprFromInt(vc, 32, 0);
+  if (vc_query(vc, vc_eqExpr(vc, vc_bvPlusExpr(vc, 32, x, zero), x)) != 1)
+    failures++;
+
+  return failures;
+}
+
+static void worker(int id, int rounds, int* failures)
+{
+  for (int r = 0; r < rounds; r++)
+    {
+      VC vc = vc_createValidityChecker();
+      // A different product on each thread.
+      *failures += factor(vc, (unsigned)(251 + 6 * id) * 241);
+      vc_Destroy(vc);
+    }
+}
+
+TEST(threads, independent_vcs)
+{
+  const int n = 8;
+  const int rounds = 5;
+  std::vector<int> failures(n, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < n; i++)
+    threads.push_back(std::thread(worker, i, rounds, &failures[i]));
+  for (int i = 0; i < n; i++)
+    threads[i].join();
+
+  for (int i = 0; i < n; i++)
+    ASSERT_EQ(0, failures[i]) << "thread " << i;
+}
+
+// A timed query on one thread mustn't disturb queries on the others.
+TEST(threads, timeout_per_vc)
+{
+  int failures = 0;
+  std::thread other(worker, 0, 3, &failures);
+
+  VC vc = vc_createValidityChecker();
+  Expr t = vc_trueExpr(vc);
+  ASSERT_EQ(1, vc_query_with_timeout(vc, t, 10000));
+  vc_Destroy(vc);
+
+  other.join();
+  ASSERT_EQ(0, failures);
+}
+
+// An expression made by one VC can be let go of while another VC is
+// the one in use on the thread.
+TEST(threads, two_vcs_on_one_thread)
+{
+  VC vc1 = vc_createValidityChecker();
+  vc_setInterfaceFlags(vc1, EXPRDELETE, 0);
+  VC vc2 = vc_createValidityChecker();
+
+  Type bv8 = vc_bvType(vc1, 8);
+  Expr x = vc_varExpr(vc1, "x", bv8);
+  for (int i = 0; i < 50; i++)
+    {
+      Expr c = vc_bvConstExprFromInt(vc1, 8, i);
+      Expr sum = vc_bvPlusExpr(vc1, 8, x, c);
+
+      // Uses vc2, then drops the only references to c and sum.
+      Expr y = vc_varExpr(vc2, "y", vc_bvType(vc2, 8));
+      vc_DeleteExpr(sum);
+      vc_DeleteExpr(c);
+      vc_push(vc2);
+      ASSERT_EQ(0, vc_query(vc2, vc_eqExpr(vc2, y, vc_bvConstExprFromInt(vc2, 8, i))));
+      vc_pop(vc2);
+
+      // Made again, they must be what they were.
+      c = vc_bvConstExprFromInt(vc1, 8, i);
+      sum = vc_bvPlusExpr(vc1, 8, x, c);
+      vc_push(vc1);
+      ASSERT_EQ(1, vc_query(vc1, vc_eqExpr(vc1, vc_bvMinusExpr(vc1, 8, sum, c), x)));
+      vc_pop(vc1);
+    }
+
+  vc_Destroy(vc1);
+  ASSERT_EQ(1, vc_query(vc2, vc_trueExpr(vc2)));
+  vc_Destroy(vc2);
+}
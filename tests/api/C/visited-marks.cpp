@@ -0,0 +1,153 @@
+/***********
+AUTHORS: Unknown
+
+BEGIN DATE: Oct, 2026
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+**********************/
+// Checks the pooled visited marks, and that NodeIterators, which take
+// their marks from the pool, can nest.
+
+#include <gtest/gtest.h>
+#include <string>
+#include "stp/STPManager/STPManager.h"
+#include "stp/STPManager/NodeIterator.h"
+
+using namespace BEEV;
+
+// The number of distinct nodes in n, found without marks.
+static size_t
+reference(const ASTNode& n, ASTNodeSet& seen)
+{
+  if (!seen.insert(n).second)
+    return 0;
+  size_t result = 1;
+  for (size_t i = 0; i < n.Degree(); i++)
+    result += reference(n[i], seen);
+  return result;
+}
+
+static size_t
+reference(const ASTNode& n)
+{
+  ASTNodeSet seen;
+  return reference(n, seen);
+}
+
+static size_t
+count(const ASTNode& n, STPMgr& bm)
+{
+  NodeIterator ni(n, bm.ASTUndefined, bm);
+  size_t result = 0;
+  while (ni.next() != ni.end())
+    result++;
+  return result;
+}
+
+// A chain in which each link refers to the one before twice.
+static ASTVec
+chain(STPMgr& bm, int length)
+{
+  NodeFactory* nf = bm.defaultNodeFactory;
+  ASTVec result;
+  result.push_back(bm.CreateSymbol("x", 0, 32));
+  for (int i = 1; i < length; i++)
+    {
+      ASTNode times = nf->CreateTerm(BVMULT, 32, result[i - 1], bm.CreateBVConst(32, i));
+      result.push_back(nf->CreateTerm(BVPLUS, 32, result[i - 1], times));
+    }
+  return result;
+}
+
+TEST(visited_marks, mark_and_clear)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  const ASTVec links = chain(bm, 10);
+
+  VisitedMarks marks;
+  ASSERT_FALSE(marks.isMarked(links[3]));
+  ASSERT_TRUE(marks.mark(links[3]));
+  ASSERT_FALSE(marks.mark(links[3]));
+  ASSERT_TRUE(marks.isMarked(links[3]));
+  ASSERT_FALSE(marks.isMarked(links[4]));
+
+  marks.clear();
+  ASSERT_FALSE(marks.isMarked(links[3]));
+  ASSERT_TRUE(marks.mark(links[3]));
+}
+
+// Marks from the pool are unmarked when they are handed out again, and
+// two that are out at once are separate.
+TEST(visited_marks, pool)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  const ASTVec links = chain(bm, 10);
+
+  {
+    VisitedMarksScope outer(bm);
+    outer->mark(links[1]);
+    {
+      VisitedMarksScope inner(bm);
+      ASSERT_FALSE(inner->isMarked(links[1]));
+      inner->mark(links[2]);
+      ASSERT_FALSE(outer->isMarked(links[2]));
+    }
+    ASSERT_TRUE(outer->isMarked(links[1]));
+  }
+
+  VisitedMarksScope again(bm);
+  ASSERT_FALSE(again->isMarked(links[1]));
+  ASSERT_FALSE(again->isMarked(links[2]));
+}
+
+// Counting the nodes below each node while an outer traversal is part
+// way through mustn't disturb the outer one, nor the counts.
+TEST(visited_marks, nested_traversals)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  const ASTVec links = chain(bm, 200);
+
+  ASTNodeSet seen;
+  NodeIterator ni(links.back(), bm.ASTUndefined, bm);
+  ASTNode current;
+  while ((current = ni.next()) != ni.end())
+    {
+      ASSERT_TRUE(seen.insert(current).second);
+      ASSERT_EQ(reference(current), count(current, bm));
+    }
+  ASSERT_EQ(reference(links.back()), seen.size());
+}
+
+// Nodes made after the marks were first used, with bigger node
+// numbers, are marked too.
+TEST(visited_marks, nodes_made_later)
+{
+  CONSTANTBV::BitVector_Boot();
+  STPMgr bm;
+  ASTVec links = chain(bm, 5);
+  ASSERT_EQ(reference(links.back()), count(links.back(), bm));
+
+  for (int i = 0; i < 10000; i++)
+    bm.CreateSymbol(("v" + std::to_string(i)).c_str(), 0, 32);
+  links = chain(bm, 50);
+  ASSERT_EQ(reference(links.back()), count(links.back(), bm));
+}
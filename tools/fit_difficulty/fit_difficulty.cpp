@@ -0,0 +1,294 @@
+/********************************************************************
+ * AUTHORS: Unknown
+ *
+ * BEGIN DATE: Oct, 2026
+ *
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+********************************************************************/
+
+// Fits the difficulty model to a log written with --difficulty-log,
+// so that the difficulty scores predict the number of AIG nodes that
+// bit-blasting really creates, then writes the model out for
+// --difficulty-model to read. The coefficients start from the default
+// model, or from the model given, and only the kinds in the log are
+// changed.
+//
+// usage: fit_difficulty log [model] > fitted
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include "stp/STPManager/DifficultyModel.h"
+
+using namespace BEEV;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+// How strongly the coefficients are pulled towards the starting ones,
+// which keeps them sensible for kinds that the log says little about.
+static const double damping = 0.01;
+
+struct Query
+{
+  double aig;
+  std::map<Kind, std::pair<double, double> > features;
+};
+
+static bool
+readLog(std::istream& in, vector<Query>& queries)
+{
+  string line;
+  while (std::getline(in, line))
+    {
+      if (line.empty())
+        continue;
+
+      Query q;
+      q.aig = -1;
+      std::istringstream fields(line);
+      string field;
+      while (std::getline(fields, field, '\t'))
+        {
+          const size_t colon = field.find(':');
+          if (colon == string::npos)
+            return false;
+          const string name = field.substr(0, colon);
+          const string value = field.substr(colon + 1);
+
+          Kind k;
+          if (name == "aig")
+            q.aig = atof(value.c_str());
+          else if (DifficultyModel::kindFromName(name, k))
+            {
+              const size_t comma = value.find(',');
+              if (comma == string::npos)
+                return false;
+              q.features[k] = std::make_pair(atof(value.substr(0, comma).c_str()),
+                  atof(value.substr(comma + 1).c_str()));
+            }
+        }
+      if (q.aig < 0)
+        return false;
+      queries.push_back(q);
+    }
+  return true;
+}
+
+static double
+predict(const DifficultyModel& model, const Query& q)
+{
+  double result = 0;
+  for (std::map<Kind, std::pair<double, double> >::const_iterator it = q.features.begin(); it != q.features.end(); it++)
+    result += model.getLinear(it->first) * it->second.first + model.getQuadratic(it->first) * it->second.second;
+  return result;
+}
+
+// The mean of |predicted - actual| / actual.
+static double
+meanError(const DifficultyModel& model, const vector<Query>& queries)
+{
+  double total = 0;
+  for (size_t i = 0; i < queries.size(); i++)
+    total += std::fabs(predict(model, queries[i]) - queries[i].aig) / std::max(queries[i].aig, 1.0);
+  return queries.empty() ? 0 : total / queries.size();
+}
+
+// Solves m x = b by Gaussian elimination. Returns false if m is singular.
+static bool
+solve(vector<vector<double> > m, vector<double> b, vector<double>& x)
+{
+  const size_t n = b.size();
+  for (size_t c = 0; c < n; c++)
+    {
+      size_t pivot = c;
+      for (size_t r = c + 1; r < n; r++)
+        if (std::fabs(m[r][c]) > std::fabs(m[pivot][c]))
+          pivot = r;
+      if (m[pivot][c] == 0)
+        return false;
+      std::swap(m[c], m[pivot]);
+      std::swap(b[c], b[pivot]);
+
+      for (size_t r = c + 1; r < n; r++)
+        {
+          const double f = m[r][c] / m[c][c];
+          for (size_t j = c; j < n; j++)
+            m[r][j] -= f * m[c][j];
+          b[r] -= f * b[c];
+        }
+    }
+
+  x.assign(n, 0);
+  for (size_t c = n; c-- > 0;)
+    {
+      double v = b[c];
+      for (size_t j = c + 1; j < n; j++)
+        v -= m[c][j] * x[j];
+      x[c] = v / m[c][c];
+    }
+  return true;
+}
+
+// A coefficient being fitted: the linear (0) or quadratic (1) one of a kind.
+struct Coefficient
+{
+  Kind k;
+  int which;
+};
+
+static double
+feature(const Query& q, const Coefficient& c)
+{
+  std::map<Kind, std::pair<double, double> >::const_iterator it = q.features.find(c.k);
+  if (it == q.features.end())
+    return 0;
+  return c.which == 0 ? it->second.first : it->second.second;
+}
+
+static double
+get(const DifficultyModel& model, const Coefficient& c)
+{
+  return c.which == 0 ? model.getLinear(c.k) : model.getQuadratic(c.k);
+}
+
+static void
+put(DifficultyModel& model, const Coefficient& c, double v)
+{
+  if (c.which == 0)
+    model.set(c.k, v, model.getQuadratic(c.k));
+  else
+    model.set(c.k, model.getLinear(c.k), v);
+}
+
+// Least squares on the relative error, damped towards the starting
+// coefficients. A coefficient that comes out negative is set to zero
+// and the rest are fitted again.
+static void
+fit(DifficultyModel& model, const vector<Query>& queries)
+{
+  vector<Coefficient> fitted;
+  for (int k = 0; k < DifficultyModel::numberOfKinds; k++)
+    for (int which = 0; which < 2; which++)
+      {
+        Coefficient c = { (Kind) k, which };
+        for (size_t i = 0; i < queries.size(); i++)
+          if (feature(queries[i], c) != 0)
+            {
+              fitted.push_back(c);
+              break;
+            }
+      }
+
+  while (!fitted.empty())
+    {
+      const size_t n = fitted.size();
+      vector<vector<double> > m(n, vector<double>(n, 0));
+      vector<double> b(n, 0);
+
+      // What the coefficients that aren't being fitted contribute.
+      DifficultyModel fixed = model;
+      for (size_t j = 0; j < n; j++)
+        put(fixed, fitted[j], 0);
+
+      for (size_t i = 0; i < queries.size(); i++)
+        {
+          const Query& q = queries[i];
+          const double weight = 1 / std::max(q.aig * q.aig, 1.0);
+          const double target = q.aig - predict(fixed, q);
+
+          vector<double> row(n);
+          for (size_t j = 0; j < n; j++)
+            row[j] = feature(q, fitted[j]);
+
+          for (size_t j = 0; j < n; j++)
+            {
+              for (size_t l = 0; l < n; l++)
+                m[j][l] += weight * row[j] * row[l];
+              b[j] += weight * row[j] * target;
+            }
+        }
+
+      for (size_t j = 0; j < n; j++)
+        {
+          const double d = damping * std::max(m[j][j], 1e-12);
+          m[j][j] += d;
+          b[j] += d * get(model, fitted[j]);
+        }
+
+      vector<double> x;
+      if (!solve(m, b, x))
+        {
+          cerr << "The log doesn't determine the coefficients" << endl;
+          exit(1);
+        }
+
+      vector<Coefficient> positive;
+      for (size_t j = 0; j < n; j++)
+        if (x[j] < 0)
+          put(model, fitted[j], 0);
+        else
+          positive.push_back(fitted[j]);
+
+      if (positive.size() == n)
+        {
+          for (size_t j = 0; j < n; j++)
+            put(model, fitted[j], x[j]);
+          break;
+        }
+      fitted = positive;
+    }
+}
+
+int
+main(int argc, char ** argv)
+{
+  if (argc < 2 || argc > 3)
+    {
+      cerr << "usage: " << argv[0] << " log [model]" << endl;
+      return 1;
+    }
+
+  std::ifstream in(argv[1]);
+  vector<Query> queries;
+  if (!in || !readLog(in, queries))
+    {
+      cerr << "Can't read the log " << argv[1] << endl;
+      return 1;
+    }
+
+  DifficultyModel model;
+  if (argc == 3 && !model.load(argv[2]))
+    {
+      cerr << "Can't read the model " << argv[2] << endl;
+      return 1;
+    }
+
+  cerr << "Queries:" << queries.size() << endl;
+  cerr << "Mean relative error before:" << meanError(model, queries) << endl;
+  fit(model, queries);
+  cerr << "Mean relative error after:" << meanError(model, queries) << endl;
+
+  model.write(std::cout);
+  return 0;
+}
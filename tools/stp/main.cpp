@@ -164,6 +164,21 @@ void ExtraMain::create_options()
     ("disable-opt-inc,a", "disable potentially size-increasing optimisations")
     ("disable-cbitp", "disable constant bit propagation")
     ("disable-equality", "disable equality propagation")
+    ("pipeline", po::value<string>()
+        , "size reducing passes to run, in order, separated by commas: "
+          "propagate-equalities, remove-unconstrained, intervals, constant-bits, "
+          "pure-literals, always-true, bv-solver")
+    ("pass-min-yield", po::value<string>()
+        , "skip size reducing passes that recently removed less than this fraction of the difficulty (0, the default, never skips)")
+    ("disable-incremental-fixpoint", "simplify the whole formula in every round, rather than just the parts that changed")
+    ("disable-narrow-widths", "don't do arithmetic and comparisons at the width their operands need before bit-blasting")
+    ("disable-split-components", "don't solve the parts of the problem that share no variables separately")
+    ("component-threads", po::value<int>()
+        , "number of independent parts of the problem to solve at once")
+    ("difficulty-log", po::value<string>()
+        , "append the predicted difficulty and the real bit-blasted size and solve time of each query to this file")
+    ("difficulty-model", po::value<string>()
+        , "read the difficulty score coefficients from this file, as written by fit_difficulty")
     ;
 
     po::options_description solver_options("SAT Solver options");
@@ -358,6 +373,41 @@ int ExtraMain::parse_options(int argc, char** argv)
         bm->UserFlags.propagate_equalities = false;
     }
 
+    if (vm.count("pipeline")) {
+        bm->UserFlags.set("pipeline", vm["pipeline"].as<string>());
+    }
+
+    if (vm.count("pass-min-yield")) {
+        bm->UserFlags.set("pass-min-yield", vm["pass-min-yield"].as<string>());
+    }
+
+    if (vm.count("disable-incremental-fixpoint")) {
+        bm->UserFlags.set("incremental-fixpoint", "0");
+    }
+
+    if (vm.count("disable-narrow-widths")) {
+        bm->UserFlags.set("narrow-widths", "0");
+    }
+
+    if (vm.count("disable-split-components")) {
+        bm->UserFlags.set("split-components", "0");
+    }
+
+    if (vm.count("component-threads")) {
+        bm->UserFlags.set("component-threads", std::to_string(vm["component-threads"].as<int>()));
+    }
+
+    if (vm.count("difficulty-log")) {
+        bm->UserFlags.set("difficulty-log", vm["difficulty-log"].as<string>());
+    }
+
+    if (vm.count("difficulty-model")) {
+        if (!bm->difficultyModel.load(vm["difficulty-model"].as<string>())) {
+            cerr << "ERROR: can't read the difficulty model " << vm["difficulty-model"].as<string>() << endl;
+            exit(-1);
+        }
+    }
+
     if (vm.count("random-seed")) {
         srand(time(NULL));
         bm->UserFlags.random_seed_flag = true;